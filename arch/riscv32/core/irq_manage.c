@@ -7,6 +7,7 @@
 #include <toolchain.h>
 #include <kernel_structs.h>
 #include <misc/printk.h>
+#include <logging/kernel_event_logger.h>
 
 void _irq_spurious(void *unused)
 {
@@ -28,3 +29,30 @@ void _irq_spurious(void *unused)
 
 	_NanoFatalErrorHandler(_NANO_ERR_SPURIOUS_INT, &_default_esf);
 }
+
+#ifdef CONFIG_RISCV_DIRECT_ISR
+#ifdef CONFIG_SYS_POWER_MANAGEMENT
+/*
+ * Called from direct ISRs, with interrupts locked: notify the kernel of an
+ * idle wakeup, as the interrupt entry code does for regular ISRs.
+ */
+void _arch_isr_direct_pm(void)
+{
+	s32_t idle_val = _kernel.idle;
+
+	if (idle_val) {
+		_kernel.idle = 0;
+		_sys_power_save_idle_exit(idle_val);
+	}
+}
+#endif
+
+#if defined(CONFIG_KERNEL_EVENT_LOGGER_SLEEP) || \
+	defined(CONFIG_KERNEL_EVENT_LOGGER_INTERRUPT)
+void _arch_isr_direct_header(void)
+{
+	_sys_k_event_logger_interrupt();
+	_sys_k_event_logger_exit_sleep();
+}
+#endif
+#endif /* CONFIG_RISCV_DIRECT_ISR */
@@ -19,6 +19,9 @@
 
 /* thread_arch_t member offsets */
 GEN_OFFSET_SYM(_thread_arch_t, swap_return_value);
+#ifdef CONFIG_FP_SHARING
+GEN_OFFSET_SYM(_thread_arch_t, preempt_float);
+#endif
 
 /* struct coop member offsets */
 GEN_OFFSET_SYM(_callee_saved_t, sp);
@@ -76,7 +79,13 @@ GEN_OFFSET_SYM(NANO_ESF, lpcount1);
 GEN_ABSOLUTE_SYM(__NANO_ESF_SIZEOF, STACK_ROUND_UP(sizeof(NANO_ESF)));
 
 /* size of the struct tcs structure sans save area for floating point regs */
+#ifdef CONFIG_FP_SHARING
+GEN_ABSOLUTE_SYM(_K_THREAD_NO_FLOAT_SIZEOF,
+		 STACK_ROUND_UP(sizeof(struct k_thread) -
+				sizeof(struct _preempt_float)));
+#else
 GEN_ABSOLUTE_SYM(_K_THREAD_NO_FLOAT_SIZEOF,
 		 STACK_ROUND_UP(sizeof(struct k_thread)));
+#endif
 
 GEN_ABS_SYM_END
@@ -62,6 +62,21 @@ void _new_thread(struct k_thread *thread, char *stack_memory,
 	stack_init->mstatus = SOC_MSTATUS_DEF_RESTORE;
 	stack_init->mepc = (u32_t)_thread_entry_wrapper;
 
+#if defined(CONFIG_FP_SHARING)
+	/*
+	 * Only threads created with K_FP_REGS get access to the floating
+	 * point registers, which they get in their initial state.
+	 */
+	if (options & K_FP_REGS) {
+		stack_init->mstatus |= SOC_MSTATUS_FS_INIT;
+		memset(&thread->arch.preempt_float, 0,
+		       sizeof(thread->arch.preempt_float));
+	}
+#elif defined(CONFIG_FLOAT)
+	/* any thread may use the registers, which are not preserved */
+	stack_init->mstatus |= SOC_MSTATUS_FS_INIT;
+#endif
+
 	thread->callee_saved.sp = (u32_t)stack_init;
 
 	thread_monitor_init(thread);
@@ -54,8 +54,29 @@ struct _caller_saved {
 
 typedef struct _caller_saved _caller_saved_t;
 
+#ifdef CONFIG_FP_SHARING
+#ifdef CONFIG_RISCV_HAS_D_EXTENSION
+typedef u64_t _fp_reg_t;
+#else
+typedef u32_t _fp_reg_t;
+#endif
+
+/*
+ * Floating point registers, saved when switching out a thread that modified
+ * them, and restored when switching in a thread using them.
+ */
+struct _preempt_float {
+	_fp_reg_t f[32]; /* f0 - f31 */
+	u32_t fcsr;      /* floating point control and status register */
+};
+#endif
+
 struct _thread_arch {
 	u32_t swap_return_value; /* Return value of _Swap() */
+
+#ifdef CONFIG_FP_SHARING
+	struct _preempt_float preempt_float;
+#endif
 };
 
 typedef struct _thread_arch _thread_arch_t;
@@ -59,6 +59,11 @@
 #define _thread_offset_to_swap_return_value \
 	(___thread_t_arch_OFFSET + ___thread_arch_t_swap_return_value_OFFSET)
 
+#ifdef CONFIG_FP_SHARING
+#define _thread_offset_to_preempt_float \
+	(___thread_t_arch_OFFSET + ___thread_arch_t_preempt_float_OFFSET)
+#endif
+
 /* end - threads */
 
 #endif /* _offsets_short_arch__h_ */
@@ -35,6 +35,13 @@
 /* Interrupt Enable Bit in Previous Privilege Mode */
 #define SOC_MSTATUS_MPIE             (1 << 7)
 
+/* Floating point unit state: off, initial, clean or dirty */
+#define SOC_MSTATUS_FS_MASK          (3 << 13)
+#define SOC_MSTATUS_FS_OFF           (0 << 13)
+#define SOC_MSTATUS_FS_INIT          (1 << 13)
+#define SOC_MSTATUS_FS_CLEAN         (2 << 13)
+#define SOC_MSTATUS_FS_DIRTY         (3 << 13)
+
 /*
  * Default MSTATUS register value to restore from stack
  * upon scheduling a thread for the first time
@@ -108,6 +108,9 @@
 /* Clock controller. */
 #define PRCI_BASE_ADDR               0x10008000
 
+/* Machine software interrupt pending register, in the CLINT */
+#define RISCV_MSIP_BASE              0x02000000
+
 /* Timer configuration */
 #define RISCV_MTIME_BASE             0x0200BFF8
 #define RISCV_MTIMECMP_BASE          0x02004000
@@ -4,10 +4,33 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+/**
+ * @file
+ * @brief RISCV machine-mode timer driver
+ *
+ * The machine-mode timer is made of a free running 64-bit counter, mtime,
+ * and a 64-bit compare register, mtimecmp: the timer interrupt is pending as
+ * long as mtime is greater than or equal to mtimecmp. The counter never wraps
+ * around in practice, hence the driver never has to account for overflows.
+ *
+ * Ticks are announced relative to last_count, the value of mtime on the last
+ * tick boundary accounted for, which always matches _sys_clock_tick_count.
+ * Each interrupt announces the whole ticks elapsed since then and programs
+ * the compare register on a tick boundary, so that a late interrupt does not
+ * make the system clock drift.
+ *
+ * With CONFIG_TICKLESS_IDLE, the compare register is programmed for the next
+ * timeout expiry when the kernel goes idle, and the ticks elapsed while idle
+ * are announced when it wakes up. With CONFIG_TICKLESS_KERNEL, there is no
+ * periodic interrupt at all: the compare register is only programmed, through
+ * _set_time(), for the next timeout or time slice expiry.
+ */
+
 #include <kernel.h>
 #include <arch/cpu.h>
 #include <device.h>
 #include <system_timer.h>
+#include <sys_clock.h>
 #include <board.h>
 
 typedef struct {
@@ -20,60 +43,288 @@ static volatile riscv_machine_timer_t *mtime =
 static volatile riscv_machine_timer_t *mtimecmp =
 	(riscv_machine_timer_t *)RISCV_MTIMECMP_BASE;
 
-/*
- * The RISCV machine-mode timer is a one shot timer that needs to be rearm upon
- * every interrupt. Timer clock is a 64-bits ART.
- * To arm timer, we need to read the RTC value and update the
- * timer compare register by the RTC value + time interval we want timer
- * to interrupt.
- */
-static ALWAYS_INLINE void riscv_machine_rearm_timer(void)
-{
-	u64_t rtc;
+/* value of mtime on the last tick boundary accounted for */
+static u64_t last_count;
 
-	/*
-	 * Disable timer interrupt while rearming the timer
-	 * to avoid generation of interrupts while setting
-	 * the mtimecmp->val_low register.
-	 */
-	irq_disable(RISCV_MACHINE_TIMER_IRQ);
+#ifdef CONFIG_TICKLESS_IDLE
+/* maximum number of ticks that can be announced at once */
+#define MAX_TICKS 0x7fffffff
+#endif
+
+#ifdef CONFIG_TICKLESS_KERNEL
+/* ticks programmed from last_count, or 0 if nothing is programmed */
+static u32_t programmed_ticks;
+#endif
+
+static u64_t riscv_machine_timer_read(void)
+{
+	u32_t low, high;
 
 	/*
 	 * Following machine-mode timer implementation in QEMU, the actual
 	 * RTC read is performed when reading low timer value register.
 	 * Reading high timer value just reads the most significant 32-bits
 	 * of a cache value, obtained from a previous read to the low
-	 * timer value register. Hence, always read timer->val_low first.
-	 * This also works for other implementations.
+	 * timer value register. Reading the high value again after the low
+	 * one, until it does not change, thus works for both QEMU and the
+	 * implementations where the counter carries into the high value
+	 * between the two reads.
 	 */
-	rtc = mtime->val_low;
-	rtc |= ((u64_t)mtime->val_high << 32);
+	do {
+		high = mtime->val_high;
+		low = mtime->val_low;
+	} while (mtime->val_high != high);
+
+	return ((u64_t)high << 32) | low;
+}
+
+/*
+ * Set the compare register. Interrupts must be locked, which is always the
+ * case since this is only called from the timer interrupt or with interrupts
+ * locked by the kernel.
+ *
+ * The low word is first set to its maximum, so that the compare value never
+ * goes below both the previous and the new value while being updated, which
+ * would raise a spurious interrupt. A value in the past makes the interrupt
+ * pending right away.
+ */
+static void riscv_machine_timer_set(u64_t count)
+{
+	mtimecmp->val_low = 0xffffffff;
+	mtimecmp->val_high = (u32_t)(count >> 32);
+	mtimecmp->val_low = (u32_t)count;
+}
+
+/* number of whole ticks elapsed since last_count */
+static u32_t elapsed_ticks(void)
+{
+	u64_t cycles = riscv_machine_timer_read() - last_count;
+
+	/* avoid the 64-bit division for the usual, short intervals */
+	if (cycles <= 0xffffffff) {
+		return (u32_t)cycles / sys_clock_hw_cycles_per_tick;
+	}
+
+	return (u32_t)(cycles / sys_clock_hw_cycles_per_tick);
+}
+
+#ifdef CONFIG_TICKLESS_KERNEL
+
+static void riscv_machine_timer_irq_handler(void *unused)
+{
+	u32_t elapsed;
+
+	ARG_UNUSED(unused);
+
+#ifdef CONFIG_EXECUTION_BENCHMARKING
+	extern void read_timer_start_of_tick_handler(void);
+	read_timer_start_of_tick_handler();
+#endif
+
+	/* nothing is due until _set_time() is called again */
+	riscv_machine_timer_set(~((u64_t)0));
+
+	if (!programmed_ticks) {
+		return;
+	}
 
 	/*
-	 * Rearm timer to generate an interrupt after
-	 * sys_clock_hw_cycles_per_tick
+	 * Clear programmed ticks before announcing elapsed time, so that
+	 * _set_time() called while handling the timeouts counts from the
+	 * new reference.
 	 */
-	rtc += sys_clock_hw_cycles_per_tick;
-	mtimecmp->val_low = (u32_t)(rtc & 0xffffffff);
-	mtimecmp->val_high = (u32_t)((rtc >> 32) & 0xffffffff);
+	programmed_ticks = 0;
 
-	/* Enable timer interrupt */
-	irq_enable(RISCV_MACHINE_TIMER_IRQ);
+	elapsed = elapsed_ticks();
+	last_count += (u64_t)elapsed * sys_clock_hw_cycles_per_tick;
+	_sys_clock_tick_count += elapsed;
+
+	_sys_idle_elapsed_ticks = elapsed;
+	_sys_clock_tick_announce();
+
+#ifdef CONFIG_EXECUTION_BENCHMARKING
+	extern void read_timer_end_of_tick_handler(void);
+	read_timer_end_of_tick_handler();
+#endif
+}
+
+u32_t _get_program_time(void)
+{
+	return programmed_ticks;
+}
+
+u32_t _get_elapsed_program_time(void)
+{
+	u32_t elapsed;
+
+	if (!programmed_ticks) {
+		return 0;
+	}
+
+	elapsed = elapsed_ticks();
+
+	return elapsed < programmed_ticks ? elapsed : programmed_ticks;
+}
+
+u32_t _get_remaining_program_time(void)
+{
+	if (!programmed_ticks) {
+		return 0;
+	}
+
+	return programmed_ticks - _get_elapsed_program_time();
+}
+
+/*
+ * The kernel gives the time relative to when the timer was last programmed,
+ * having already accounted for the ticks elapsed since then, unless nothing
+ * is programmed: in that case, count from the current tick.
+ */
+void _set_time(u32_t time)
+{
+	unsigned int key;
+	u32_t elapsed;
+
+	key = irq_lock();
+
+	if (!time) {
+		programmed_ticks = 0;
+		riscv_machine_timer_set(~((u64_t)0));
+		irq_unlock(key);
+		return;
+	}
+
+	if (!programmed_ticks) {
+		elapsed = elapsed_ticks();
+		last_count += (u64_t)elapsed * sys_clock_hw_cycles_per_tick;
+		_sys_clock_tick_count += elapsed;
+	}
+
+	programmed_ticks = time > MAX_TICKS ? MAX_TICKS : time;
+
+	riscv_machine_timer_set(last_count + (u64_t)programmed_ticks *
+				sys_clock_hw_cycles_per_tick);
+
+	irq_unlock(key);
+}
+
+/*
+ * The counter runs whether or not anything is programmed, and never wraps
+ * around: the system clock can be read at any time without further ado.
+ */
+void _enable_sys_clock(void)
+{
+}
+
+u64_t _get_elapsed_clock_time(void)
+{
+	unsigned int key;
+	u64_t ticks;
+
+	key = irq_lock();
+	ticks = _sys_clock_tick_count + elapsed_ticks();
+	irq_unlock(key);
+
+	return ticks;
+}
+
+void _timer_idle_enter(s32_t ticks)
+{
+	/* the timer is already programmed for the next timeout, if any */
+	if (ticks == K_FOREVER) {
+		programmed_ticks = 0;
+		riscv_machine_timer_set(~((u64_t)0));
+	}
+}
+
+void _timer_idle_exit(void)
+{
+	/* the timer interrupt announces the elapsed ticks, if any */
+}
+
+#else /* CONFIG_TICKLESS_KERNEL */
+
+/*
+ * Announce the ticks elapsed since the last announcement, if any, and
+ * program the interrupt for the next tick boundary.
+ */
+static void riscv_machine_timer_announce(void)
+{
+	u32_t elapsed = elapsed_ticks();
+
+	if (elapsed) {
+#ifndef CONFIG_TICKLESS_IDLE
+		/*
+		 * Announce a single tick at a time: the interrupt fires again
+		 * right away for each tick that was missed.
+		 */
+		elapsed = 1;
+#endif
+		last_count += (u64_t)elapsed * sys_clock_hw_cycles_per_tick;
+
+		_sys_idle_elapsed_ticks = elapsed;
+		_sys_clock_tick_announce();
+	}
+
+	riscv_machine_timer_set(last_count + sys_clock_hw_cycles_per_tick);
 }
 
 static void riscv_machine_timer_irq_handler(void *unused)
 {
 	ARG_UNUSED(unused);
 
-	_sys_clock_tick_announce();
+#ifdef CONFIG_EXECUTION_BENCHMARKING
+	extern void read_timer_start_of_tick_handler(void);
+	read_timer_start_of_tick_handler();
+#endif
 
-	/* Rearm timer */
-	riscv_machine_rearm_timer();
+	riscv_machine_timer_announce();
+
+#ifdef CONFIG_EXECUTION_BENCHMARKING
+	extern void read_timer_end_of_tick_handler(void);
+	read_timer_end_of_tick_handler();
+#endif
 }
 
 #ifdef CONFIG_TICKLESS_IDLE
-#error "Tickless idle not yet implemented for riscv-machine timer"
-#endif
+/**
+ *
+ * @brief Place the system timer into idle state
+ *
+ * Program the timer to fire after the given number of ticks, counted from
+ * the last tick announced, instead of on the next tick. This is called from
+ * the idle thread, with interrupts locked.
+ *
+ * @return N/A
+ */
+void _timer_idle_enter(s32_t ticks)
+{
+	if ((ticks == K_FOREVER) || (ticks > MAX_TICKS)) {
+		ticks = MAX_TICKS;
+	}
+
+	riscv_machine_timer_set(last_count + (u64_t)ticks *
+				sys_clock_hw_cycles_per_tick);
+}
+
+/**
+ *
+ * @brief Take the system timer out of idle state
+ *
+ * Announce the ticks elapsed while idle and program the timer for the next
+ * tick. This is called, with interrupts locked, by the interrupt waking up
+ * the kernel; if this is the timer interrupt, its handler then finds no more
+ * ticks to announce.
+ *
+ * @return N/A
+ */
+void _timer_idle_exit(void)
+{
+	riscv_machine_timer_announce();
+}
+#endif /* CONFIG_TICKLESS_IDLE */
+
+#endif /* CONFIG_TICKLESS_KERNEL */
 
 int _sys_clock_driver_init(struct device *device)
 {
@@ -82,8 +333,16 @@ int _sys_clock_driver_init(struct device *device)
 	IRQ_CONNECT(RISCV_MACHINE_TIMER_IRQ, 0,
 		    riscv_machine_timer_irq_handler, NULL, 0);
 
-	/* Initialize timer, just call riscv_machine_rearm_timer */
-	riscv_machine_rearm_timer();
+	last_count = riscv_machine_timer_read();
+
+#ifdef CONFIG_TICKLESS_KERNEL
+	/* nothing to do until the kernel programs a timeout */
+	riscv_machine_timer_set(~((u64_t)0));
+#else
+	riscv_machine_timer_set(last_count + sys_clock_hw_cycles_per_tick);
+#endif
+
+	irq_enable(RISCV_MACHINE_TIMER_IRQ);
 
 	return 0;
 }
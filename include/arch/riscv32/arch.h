@@ -25,6 +25,14 @@
 extern "C" {
 #endif
 
+/*
+ * The atomic builtins would otherwise be turned into calls to libatomic,
+ * which is not available.
+ */
+#if defined(CONFIG_RISCV_ATOMIC_EXT) && !defined(__riscv_atomic)
+#error "CONFIG_RISCV_ATOMIC_EXT requires a toolchain targeting the A extension"
+#endif
+
 /* stacks, for RISCV architecture stack should be 16byte-aligned */
 #define STACK_ALIGN  16
 
@@ -87,6 +95,73 @@ void _irq_spurious(void *unused);
 })
 #endif
 
+#ifdef CONFIG_RISCV_DIRECT_ISR
+/**
+ * Configure a 'direct' static interrupt.
+ *
+ * See include/irq.h for details.
+ * All arguments must be computable at build time.
+ */
+#if defined(CONFIG_RISCV_HAS_PLIC)
+#define _ARCH_IRQ_DIRECT_CONNECT(irq_p, priority_p, isr_p, flags_p) \
+({ \
+	BUILD_ASSERT_MSG(irq_p <= RISCV_MAX_GENERIC_IRQ, \
+			 "PLIC interrupts cannot be direct"); \
+	_ISR_DECLARE(irq_p, ISR_FLAG_DIRECT, isr_p, NULL); \
+	irq_p; \
+})
+#else
+#define _ARCH_IRQ_DIRECT_CONNECT(irq_p, priority_p, isr_p, flags_p) \
+({ \
+	_ISR_DECLARE(irq_p, ISR_FLAG_DIRECT, isr_p, NULL); \
+	irq_p; \
+})
+#endif
+
+#ifdef CONFIG_SYS_POWER_MANAGEMENT
+extern void _arch_isr_direct_pm(void);
+#define _ARCH_ISR_DIRECT_PM() _arch_isr_direct_pm()
+#else
+#define _ARCH_ISR_DIRECT_PM() do { } while (0)
+#endif
+
+#if defined(CONFIG_KERNEL_EVENT_LOGGER_SLEEP) || \
+	defined(CONFIG_KERNEL_EVENT_LOGGER_INTERRUPT)
+extern void _arch_isr_direct_header(void);
+#define _ARCH_ISR_DIRECT_HEADER() _arch_isr_direct_header()
+#else
+#define _ARCH_ISR_DIRECT_HEADER() do { } while (0)
+#endif
+
+/*
+ * The interrupt entry code goes through the rescheduling check when the
+ * ISR returns non-zero: there is nothing left to do here.
+ */
+#define _ARCH_ISR_DIRECT_FOOTER(swap) do { } while (0)
+
+/*
+ * Direct ISRs are regular C functions called from the interrupt entry code,
+ * with interrupts locked and on the interrupt stack.
+ */
+#define _ARCH_ISR_DIRECT_DECLARE(name) \
+	static inline int name##_body(void); \
+	int name(void) \
+	{ \
+		int check_reschedule; \
+		ISR_DIRECT_HEADER(); \
+		check_reschedule = name##_body(); \
+		ISR_DIRECT_FOOTER(check_reschedule); \
+		return check_reschedule; \
+	} \
+	static inline int name##_body(void)
+
+/*
+ * Marks the regular interrupts in _irq_vector_table: the interrupt entry
+ * code dispatches them through _sw_isr_table.
+ */
+extern void _isr_wrapper(void);
+#endif /* CONFIG_RISCV_DIRECT_ISR */
+
 /*
  * use atomic instruction csrrc to lock global irq
  * csrrc: atomic read and clear bits in CSR register
@@ -121,6 +196,39 @@ static ALWAYS_INLINE void _arch_irq_unlock(unsigned int key)
 extern u32_t _timer_cycle_get_32(void);
 #define _arch_k_cycle_get_32()	_timer_cycle_get_32()
 
+#ifdef CONFIG_RISCV_HAS_CYCLE_COUNTERS
+/**
+ * @brief Read the core clock cycle counter
+ *
+ * Unlike k_cycle_get_32(), which reads the memory-mapped machine timer,
+ * this reads the mcycle CSR, counting at the core clock frequency.
+ *
+ * @return lower 32 bits of the number of core clock cycles elapsed
+ */
+static ALWAYS_INLINE u32_t riscv_mcycle_get_32(void)
+{
+	u32_t cycles;
+
+	__asm__ volatile ("csrr %0, mcycle" : "=r" (cycles));
+
+	return cycles;
+}
+
+/**
+ * @brief Read the instructions retired counter
+ *
+ * @return lower 32 bits of the number of instructions retired (minstret CSR)
+ */
+static ALWAYS_INLINE u32_t riscv_minstret_get_32(void)
+{
+	u32_t instret;
+
+	__asm__ volatile ("csrr %0, minstret" : "=r" (instret));
+
+	return instret;
+}
+#endif /* CONFIG_RISCV_HAS_CYCLE_COUNTERS */
+
 #endif /*_ASMLANGUAGE */
 
 #if defined(CONFIG_SOC_RISCV32_PULPINO)
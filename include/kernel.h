@@ -24,6 +24,7 @@
 #include <misc/__assert.h>
 #include <misc/dlist.h>
 #include <misc/slist.h>
+#include <misc/rbtree.h>
 #include <misc/util.h>
 #include <kernel_version.h>
 #include <drivers/rand32.h>
@@ -134,6 +135,16 @@ struct _timeout {
 	sys_dlist_t *wait_q;
 	s32_t delta_ticks_from_prev;
 	_timeout_func_t func;
+#ifdef CONFIG_TIMEOUT_QUEUE_PAIRING_HEAP
+	/*
+	 * With the pairing heap, delta_ticks_from_prev only tracks whether
+	 * the timeout is active: the expiry is kept as an absolute tick value.
+	 */
+	struct _timeout *heap_child;
+	struct _timeout *heap_next;
+	struct _timeout *heap_prev;
+	u32_t expiry;
+#endif
 };
 
 extern s32_t _timeout_remaining_get(struct _timeout *timeout);
@@ -154,7 +165,17 @@ struct __thread_entry {
 struct _thread_base {
 
 	/* this thread's entry in a ready/wait queue */
+#ifdef CONFIG_SCHED_SCALABLE
+	union {
+		/* wait queues, and ready queue without the scalable scheduler */
+		sys_dnode_t k_q_node;
+
+		/* ready queue with the scalable scheduler */
+		sys_rbnode_t k_q_rb_node;
+	};
+#else
 	sys_dnode_t k_q_node;
+#endif
 
 	/* user facing 'thread options'; values defined in include/kernel.h */
 	u8_t user_options;
@@ -192,6 +213,17 @@ struct _thread_base {
 	/* data returned by APIs */
 	void *swap_data;
 
+	/* mutex the thread is pending on, for transitive priority inheritance */
+	struct k_mutex *pended_on_mutex;
+
+#ifdef CONFIG_SCHED_DEADLINE
+	/* absolute deadline, in h/w cycles, among threads of equal prio */
+	u32_t prio_deadline;
+
+	/* wait queue the thread is pending on, to requeue it on a new deadline */
+	_wait_q_t *pended_on;
+#endif
+
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 	/* this thread's entry in a timeout queue */
 	struct _timeout timeout;
@@ -213,6 +245,18 @@ struct _thread_stack_info {
 typedef struct _thread_stack_info _thread_stack_info_t;
 #endif /* CONFIG_THREAD_STACK_INFO */
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+/* Runtime accounting of a thread, updated on each context switch */
+struct _thread_runtime_stats {
+	/* cycles run up to the last time the thread was switched out */
+	u64_t cycles;
+	/* cycle count when the thread was last switched in */
+	u32_t switched_in;
+	u32_t num_switches;
+	u32_t num_preemptions;
+};
+#endif /* CONFIG_THREAD_RUNTIME_STATS */
+
 struct k_thread {
 
 	struct _thread_base base;
@@ -250,6 +294,11 @@ struct k_thread {
 	struct _thread_stack_info stack_info;
 #endif /* CONFIG_THREAD_STACK_INFO */
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+	/* Runtime statistics */
+	struct _thread_runtime_stats rt_stats;
+#endif /* CONFIG_THREAD_RUNTIME_STATS */
+
 	/* arch-specifics: must always be at the end */
 	struct _thread_arch arch;
 };
@@ -636,6 +685,35 @@ extern int  k_thread_priority_get(k_tid_t thread);
  */
 extern void k_thread_priority_set(k_tid_t thread, int prio);
 
+#ifdef CONFIG_SCHED_DEADLINE
+/**
+ * @brief Set a thread's deadline.
+ *
+ * This routine sets the deadline of @a thread, as a number of hardware clock
+ * cycles from now, as returned by k_cycle_get_32(). Among the ready threads of
+ * the same priority, the one with the earliest deadline is scheduled first,
+ * and preempts the others if it is preemptible: this allows an
+ * earliest-deadline-first policy for a group of threads at the same priority.
+ * Threads of the same priority pending on a kernel object are likewise woken
+ * up in deadline order.
+ *
+ * Deadlines never override priorities: a thread of higher priority always
+ * runs before a thread of lower priority, whatever their deadlines. The
+ * deadline is not cleared when reached, nor when the thread runs.
+ *
+ * Deadlines are compared as the difference between them, thus two deadlines
+ * must not be more than 2^31 cycles apart. A thread which never had its
+ * deadline set has a deadline of zero cycles: all threads of a group
+ * scheduled by deadline should have theirs set.
+ *
+ * @param thread ID of thread whose deadline is to be set.
+ * @param deadline Deadline, in h/w cycles from now.
+ *
+ * @return N/A
+ */
+extern void k_thread_deadline_set(k_tid_t thread, int deadline);
+#endif
+
 /**
  * @brief Suspend a thread.
  *
@@ -800,6 +878,43 @@ extern void k_thread_custom_data_set(void *value);
  */
 extern void *k_thread_custom_data_get(void);
 
+/**
+ * @brief Thread runtime statistics.
+ */
+struct k_thread_runtime_stats {
+	/** Hardware clock cycles the thread ran for, interrupts included. */
+	u64_t cycles;
+	/** Number of times the thread was switched in. */
+	u32_t num_switches;
+	/** Number of times the thread was switched out while ready to run,
+	 *  i.e. preempted or yielding.
+	 */
+	u32_t num_preemptions;
+	/** Size of the thread's stack (in bytes), or 0 if unknown. */
+	size_t stack_size;
+	/** Most stack space ever used (in bytes), or 0 if unknown. */
+	size_t stack_max_used;
+};
+
+/**
+ * @brief Get the runtime statistics of a thread.
+ *
+ * This routine reads the runtime statistics of @a thread. The cycles of the
+ * current thread include the time it has been running since it was last
+ * switched in.
+ *
+ * The stack usage is only known when both CONFIG_INIT_STACKS and
+ * CONFIG_THREAD_STACK_INFO are enabled. Getting it scans the stack, the rest
+ * of the statistics is cheap to read.
+ *
+ * @param thread ID of thread.
+ * @param stats Address to hold the statistics.
+ *
+ * @return N/A
+ */
+extern void k_thread_runtime_stats_get(k_tid_t thread,
+				       struct k_thread_runtime_stats *stats);
+
 /**
  * @} end addtogroup thread_apis
  */
@@ -1292,19 +1407,34 @@ extern u32_t k_uptime_delta_32(s64_t *reftime);
 struct k_queue {
 	_wait_q_t wait_q;
 	sys_slist_t data_q;
+#ifdef CONFIG_QUEUE_LOCKFREE_APPEND
+	/* items appended without locking, most recent first */
+	atomic_t lockfree_q;
+#endif
 	_POLL_EVENT;
 
 	_OBJECT_TRACING_NEXT_PTR(k_queue);
 };
 
+#ifdef CONFIG_QUEUE_LOCKFREE_APPEND
+#define _K_QUEUE_LOCKFREE_INIT .lockfree_q = 0,
+#else
+#define _K_QUEUE_LOCKFREE_INIT
+#endif
+
 #define K_QUEUE_INITIALIZER(obj) \
 	{ \
 	.wait_q = SYS_DLIST_STATIC_INIT(&obj.wait_q), \
 	.data_q = SYS_SLIST_STATIC_INIT(&obj.data_q), \
+	_K_QUEUE_LOCKFREE_INIT \
 	_POLL_EVENT_OBJ_INIT \
 	_OBJECT_TRACING_INIT \
 	}
 
+#ifdef CONFIG_QUEUE_LOCKFREE_APPEND
+extern void _k_queue_lockfree_flush(struct k_queue *queue);
+#endif
+
 /**
  * INTERNAL_HIDDEN @endcond
  */
@@ -1356,6 +1486,30 @@ extern void k_queue_cancel_wait(struct k_queue *queue);
  */
 extern void k_queue_append(struct k_queue *queue, void *data);
 
+#ifdef CONFIG_QUEUE_LOCKFREE_APPEND
+/**
+ * @brief Append an element to the end of a queue without locking interrupts.
+ *
+ * This routine appends a data item to @a queue like k_queue_append(), but
+ * links it in with an atomic compare-and-set instead of locking interrupts.
+ * Interrupts are only locked if a thread is waiting on @a queue, to hand it
+ * the data item. Items appended this way are moved to the queue proper the
+ * next time the queue is accessed by any other API, keeping the order in
+ * which all items were appended.
+ *
+ * This allows ISRs feeding a queue at a high rate not to delay other
+ * interrupts, nor the threads consuming the queue.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param queue Address of the queue.
+ * @param data Address of the data item.
+ *
+ * @return N/A
+ */
+extern void k_queue_append_lockfree(struct k_queue *queue, void *data);
+#endif
+
 /**
  * @brief Prepend an element to a queue.
  *
@@ -1455,6 +1609,11 @@ extern void *k_queue_get(struct k_queue *queue, s32_t timeout);
  */
 static inline int k_queue_is_empty(struct k_queue *queue)
 {
+#ifdef CONFIG_QUEUE_LOCKFREE_APPEND
+	if (atomic_get(&queue->lockfree_q)) {
+		return 0;
+	}
+#endif
 	return (int)sys_slist_is_empty(&queue->data_q);
 }
 
@@ -1469,6 +1628,9 @@ static inline int k_queue_is_empty(struct k_queue *queue)
  */
 static inline void *k_queue_peek_head(struct k_queue *queue)
 {
+#ifdef CONFIG_QUEUE_LOCKFREE_APPEND
+	_k_queue_lockfree_flush(queue);
+#endif
 	return sys_slist_peek_head(&queue->data_q);
 }
 
@@ -1483,6 +1645,9 @@ static inline void *k_queue_peek_head(struct k_queue *queue)
  */
 static inline void *k_queue_peek_tail(struct k_queue *queue)
 {
+#ifdef CONFIG_QUEUE_LOCKFREE_APPEND
+	_k_queue_lockfree_flush(queue);
+#endif
 	return sys_slist_peek_tail(&queue->data_q);
 }
 
@@ -1572,6 +1737,25 @@ struct k_fifo {
 #define k_fifo_put(fifo, data) \
 	k_queue_append((struct k_queue *) fifo, data)
 
+#ifdef CONFIG_QUEUE_LOCKFREE_APPEND
+/**
+ * @brief Add an element to a fifo without locking interrupts.
+ *
+ * This routine adds a data item to @a fifo like k_fifo_put(), using an atomic
+ * compare-and-set instead of locking interrupts unless a thread is waiting
+ * on @a fifo. See k_queue_append_lockfree().
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param fifo Address of the fifo.
+ * @param data Address of the data item.
+ *
+ * @return N/A
+ */
+#define k_fifo_put_lockfree(fifo, data) \
+	k_queue_append_lockfree((struct k_queue *) fifo, data)
+#endif
+
 /**
  * @brief Atomically add a list of elements to a fifo.
  *
@@ -2175,10 +2359,168 @@ static inline s32_t k_delayed_work_remaining_get(struct k_delayed_work *work)
 	return _timeout_remaining_get(&work->timeout);
 }
 
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct k_prio_work_q {
+	sys_slist_t pending;
+	_wait_q_t wait_q;
+	u32_t depth;
+	u32_t max_depth;
+	u32_t num_processed;
+	u32_t max_wait;
+};
+
+struct k_prio_work {
+	struct k_work work;
+	int prio;
+	u32_t submit_time;
+	u32_t wait;
+};
+
+extern void _prio_work_submit(struct k_prio_work_q *work_q,
+			      struct k_prio_work *work);
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Initialize a priority work item.
+ *
+ * This routine initializes a work item for a priority workqueue, prior to
+ * its first use. Work items with a lower priority value are processed first,
+ * as for thread priorities; items of equal priority are processed in the
+ * order they were submitted.
+ *
+ * @param work Address of priority work item.
+ * @param handler Function to invoke each time work item is processed. It is
+ *                passed the address of the embedded k_work.
+ * @param prio Priority of the work item.
+ *
+ * @return N/A
+ */
+static inline void k_prio_work_init(struct k_prio_work *work,
+				    k_work_handler_t handler, int prio)
+{
+	k_work_init(&work->work, handler);
+	work->prio = prio;
+	work->wait = 0;
+}
+
+/**
+ * @brief Submit a priority work item.
+ *
+ * This routine submits work item @a work to be processed by the first idle
+ * worker thread of priority workqueue @a work_q. The item is queued after the
+ * pending items of higher or equal priority, and before the others. If the
+ * work item is already pending, this routine has no effect on it.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param work_q Address of priority workqueue.
+ * @param work Address of priority work item.
+ *
+ * @return N/A
+ */
+static inline void k_prio_work_submit_to_queue(struct k_prio_work_q *work_q,
+					       struct k_prio_work *work)
+{
+	if (!atomic_test_and_set_bit(work->work.flags, K_WORK_STATE_PENDING)) {
+		_prio_work_submit(work_q, work);
+	}
+}
+
+/**
+ * @brief Start a priority workqueue.
+ *
+ * This routine starts priority workqueue @a work_q, which spawns
+ * @a num_workers threads, so that a slow work item only holds up one of them.
+ *
+ * @param work_q Address of priority workqueue.
+ * @param threads Array of @a num_workers thread objects.
+ * @param stacks Stacks of the worker threads, as defined by
+ *		K_THREAD_STACK_ARRAY_DEFINE() with @a num_workers members.
+ * @param stack_size Size of each worker thread's stack (in bytes), which
+ *		should be the value of K_THREAD_STACK_SIZEOF() for one member
+ *		of the array.
+ * @param num_workers Number of worker threads.
+ * @param prio Priority of the worker threads.
+ *
+ * @return N/A
+ */
+extern void k_prio_work_q_start(struct k_prio_work_q *work_q,
+				struct k_thread *threads, char *stacks,
+				size_t stack_size, int num_workers, int prio);
+
+/**
+ * @brief Get the number of pending items of a priority workqueue.
+ *
+ * @param work_q Address of priority workqueue.
+ *
+ * @return Number of work items waiting for a worker thread.
+ */
+static inline u32_t k_prio_work_q_depth_get(struct k_prio_work_q *work_q)
+{
+	return work_q->depth;
+}
+
+/**
+ * @brief Get the longest time a work item waited in a priority workqueue.
+ *
+ * This routine returns the longest time elapsed between the submission of a
+ * work item and its handler being called, since the workqueue was started,
+ * along with the highest number of pending items seen.
+ *
+ * @param work_q Address of priority workqueue.
+ * @param max_depth Address to hold the highest number of pending items, or
+ *                  NULL.
+ *
+ * @return Longest wait (in hardware clock cycles).
+ */
+extern u32_t k_prio_work_q_max_wait_get(struct k_prio_work_q *work_q,
+					u32_t *max_depth);
+
+/**
+ * @brief Get the time a priority work item waited for a worker thread.
+ *
+ * If the work item is pending, this routine returns how long it has waited
+ * so far, otherwise it returns how long it waited before its handler was
+ * last called.
+ *
+ * @param work Address of priority work item.
+ *
+ * @return Wait time (in hardware clock cycles). Use
+ *         SYS_CLOCK_HW_CYCLES_TO_NS() to convert it to nanoseconds.
+ */
+extern u32_t k_prio_work_wait_get(struct k_prio_work *work);
+
 /**
  * @} end defgroup workqueue_apis
  */
 
+#ifdef CONFIG_MUTEX_STATS
+/**
+ * @brief Contention statistics of a mutex.
+ *
+ * Times are counted in hardware clock cycles, as returned by
+ * k_cycle_get_32(). Recursive locks by the owner are not accounted for.
+ */
+struct k_mutex_stats {
+	/** Number of times the mutex was acquired */
+	u32_t num_locks;
+	/** Number of lock attempts which found the mutex owned by another
+	 *  thread, whether they waited for it or not
+	 */
+	u32_t num_contended;
+	/** Longest time the mutex was held */
+	u32_t max_hold_time;
+	/** Longest time a thread waited for the mutex, even in vain */
+	u32_t max_wait_time;
+};
+#endif
+
 /**
  * @cond INTERNAL_HIDDEN
  */
@@ -2188,16 +2530,31 @@ struct k_mutex {
 	struct k_thread *owner;
 	u32_t lock_count;
 	int owner_orig_prio;
+#ifdef CONFIG_MUTEX_PRIORITY_CEILING
+	int ceiling;
+#endif
+#ifdef CONFIG_MUTEX_STATS
+	/* when the current owner acquired the mutex */
+	u32_t locked_at;
+	struct k_mutex_stats stats;
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mutex);
 };
 
+#ifdef CONFIG_MUTEX_PRIORITY_CEILING
+#define _MUTEX_CEILING_INIT .ceiling = K_LOWEST_THREAD_PRIO,
+#else
+#define _MUTEX_CEILING_INIT
+#endif
+
 #define K_MUTEX_INITIALIZER(obj) \
 	{ \
 	.wait_q = SYS_DLIST_STATIC_INIT(&obj.wait_q), \
 	.owner = NULL, \
 	.lock_count = 0, \
 	.owner_orig_prio = K_LOWEST_THREAD_PRIO, \
+	_MUTEX_CEILING_INIT \
 	_OBJECT_TRACING_INIT \
 	}
 
@@ -2274,6 +2631,53 @@ extern int k_mutex_lock(struct k_mutex *mutex, s32_t timeout);
  */
 extern void k_mutex_unlock(struct k_mutex *mutex);
 
+#ifdef CONFIG_MUTEX_PRIORITY_CEILING
+/**
+ * @brief Set the priority ceiling of a mutex.
+ *
+ * This routine makes @a mutex use the priority ceiling protocol: a thread
+ * locking the mutex runs at least at priority @a prio until it unlocks it,
+ * whether another thread waits for the mutex or not. This prevents a thread
+ * of intermediate priority from preempting the owner in the first place,
+ * instead of only once a higher priority thread waits for the mutex.
+ *
+ * The ceiling should be the priority of the highest priority thread using the
+ * mutex. Priority inheritance still applies on top of the ceiling.
+ *
+ * The mutex must not be locked.
+ *
+ * @param mutex Address of the mutex.
+ * @param prio Priority ceiling, or K_LOWEST_THREAD_PRIO to disable it.
+ *
+ * @return N/A
+ */
+extern void k_mutex_ceiling_set(struct k_mutex *mutex, int prio);
+#endif
+
+#ifdef CONFIG_MUTEX_STATS
+/**
+ * @brief Get the contention statistics of a mutex.
+ *
+ * This routine takes a consistent snapshot of the statistics of @a mutex.
+ *
+ * @param mutex Address of the mutex.
+ * @param stats Address of the structure to fill.
+ *
+ * @return N/A
+ */
+extern void k_mutex_stats_get(struct k_mutex *mutex,
+			      struct k_mutex_stats *stats);
+
+/**
+ * @brief Reset the contention statistics of a mutex.
+ *
+ * @param mutex Address of the mutex.
+ *
+ * @return N/A
+ */
+extern void k_mutex_stats_reset(struct k_mutex *mutex);
+#endif
+
 /**
  * @} end defgroup mutex_apis
  */
@@ -2282,6 +2686,137 @@ extern void k_mutex_unlock(struct k_mutex *mutex);
  * @cond INTERNAL_HIDDEN
  */
 
+struct k_rwlock {
+	_wait_q_t readers_q;
+	_wait_q_t writers_q;
+	struct k_thread *writer;
+	u32_t readers;
+	int writer_orig_prio;
+
+	_OBJECT_TRACING_NEXT_PTR(k_rwlock);
+};
+
+#define K_RWLOCK_INITIALIZER(obj) \
+	{ \
+	.readers_q = SYS_DLIST_STATIC_INIT(&obj.readers_q), \
+	.writers_q = SYS_DLIST_STATIC_INIT(&obj.writers_q), \
+	.writer = NULL, \
+	.readers = 0, \
+	.writer_orig_prio = K_LOWEST_THREAD_PRIO, \
+	_OBJECT_TRACING_INIT \
+	}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @defgroup rwlock_apis Reader-Writer Lock APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Statically define and initialize a reader-writer lock.
+ *
+ * The lock can be accessed outside the module where it is defined using:
+ *
+ * @code extern struct k_rwlock <name>; @endcode
+ *
+ * @param name Name of the reader-writer lock.
+ */
+#define K_RWLOCK_DEFINE(name) \
+	struct k_rwlock name \
+		__in_section(_k_rwlock, static, name) = \
+		K_RWLOCK_INITIALIZER(name)
+
+/**
+ * @brief Initialize a reader-writer lock.
+ *
+ * This routine initializes a reader-writer lock object, prior to its first
+ * use.
+ *
+ * Upon completion, the lock is neither read-locked nor write-locked.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ *
+ * @return N/A
+ */
+extern void k_rwlock_init(struct k_rwlock *rwlock);
+
+/**
+ * @brief Lock a reader-writer lock for reading.
+ *
+ * This routine locks @a rwlock for reading. Any number of threads can hold
+ * the lock for reading at the same time, as long as no thread holds it for
+ * writing. Writers are preferred: a thread cannot lock it for reading while
+ * a thread waits to lock it for writing, unless it has a higher priority than
+ * all the threads waiting to write.
+ *
+ * A thread must not lock for reading a lock it already holds.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ * @param timeout Waiting period to lock the lock (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Lock locked for reading.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+extern int k_rwlock_read_lock(struct k_rwlock *rwlock, s32_t timeout);
+
+/**
+ * @brief Unlock a reader-writer lock locked for reading.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ *
+ * @return N/A
+ */
+extern void k_rwlock_read_unlock(struct k_rwlock *rwlock);
+
+/**
+ * @brief Lock a reader-writer lock for writing.
+ *
+ * This routine locks @a rwlock for writing, which gives the calling thread
+ * exclusive access, waiting until no other thread holds it for reading or
+ * writing.
+ *
+ * The writer is eligible for priority inheritance, like the owner of a
+ * mutex: it runs at the priority of the highest priority thread waiting on
+ * the lock until it unlocks it. The readers are not, since the lock does not
+ * keep track of them.
+ *
+ * A thread must not lock for writing a lock it already holds.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ * @param timeout Waiting period to lock the lock (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Lock locked for writing.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+extern int k_rwlock_write_lock(struct k_rwlock *rwlock, s32_t timeout);
+
+/**
+ * @brief Unlock a reader-writer lock locked for writing.
+ *
+ * The lock must be held for writing by the calling thread.
+ *
+ * @param rwlock Address of the reader-writer lock.
+ *
+ * @return N/A
+ */
+extern void k_rwlock_write_unlock(struct k_rwlock *rwlock);
+
+/**
+ * @} end defgroup rwlock_apis
+ */
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
 struct k_sem {
 	_wait_q_t wait_q;
 	unsigned int count;
@@ -2668,6 +3203,59 @@ extern int k_msgq_put(struct k_msgq *q, void *data, s32_t timeout);
  */
 extern int k_msgq_get(struct k_msgq *q, void *data, s32_t timeout);
 
+/**
+ * @brief Send several messages to a message queue.
+ *
+ * This routine sends up to @a num_msgs consecutive messages from @a data to
+ * message queue @a q, with interrupts locked only once. Messages are first
+ * given to threads waiting to receive, then queued until the ring buffer is
+ * full; threads woken up are rescheduled once for the whole batch.
+ *
+ * If no message can be sent at all, the routine waits like k_msgq_put() for
+ * the first one only.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param q Address of the message queue.
+ * @param data Pointer to the messages, stored back to back.
+ * @param num_msgs Number of messages to send.
+ * @param timeout Waiting period to send the first message (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of messages sent, which may be lower than @a num_msgs.
+ * @retval -ENOMSG Returned without waiting or queue purged.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+extern int k_msgq_put_n(struct k_msgq *q, void *data, u32_t num_msgs,
+			s32_t timeout);
+
+/**
+ * @brief Receive several messages from a message queue.
+ *
+ * This routine receives up to @a num_msgs messages from message queue @a q
+ * into @a data, with interrupts locked only once. Space freed in the ring
+ * buffer is refilled from threads waiting to send, and those are rescheduled
+ * once for the whole batch.
+ *
+ * If no message is available, the routine waits like k_msgq_get() for the
+ * first one only.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param q Address of the message queue.
+ * @param data Address of area to hold @a num_msgs messages, back to back.
+ * @param num_msgs Maximum number of messages to receive.
+ * @param timeout Waiting period to receive the first message (in
+ *                milliseconds), or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @return Number of messages received, which may be lower than @a num_msgs.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+extern int k_msgq_get_n(struct k_msgq *q, void *data, u32_t num_msgs,
+			s32_t timeout);
+
 /**
  * @brief Purge a message queue.
  *
@@ -3063,6 +3651,11 @@ extern int k_pipe_get(struct k_pipe *pipe, void *data,
  * Once all of the data in the block has been written to the pipe, it will
  * free the memory block @a block and give the semaphore @a sem (if specified).
  *
+ * If a thread is waiting in k_pipe_block_get() on an empty pipe, the memory
+ * block itself is handed to it without copying the data, and it becomes
+ * responsible for freeing the block. The same happens when such a reader
+ * finds the block first in the pipe.
+ *
  * @param pipe Address of the pipe.
  * @param block Memory block containing data to send
  * @param size Number of data bytes in memory block to send
@@ -3073,10 +3666,67 @@ extern int k_pipe_get(struct k_pipe *pipe, void *data,
 extern void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 			     size_t size, struct k_sem *sem);
 
+/**
+ * @brief Read memory block from a pipe.
+ *
+ * This routine reads data from @a pipe into a memory block, taking over
+ * the memory block written with k_pipe_block_put() when it is the next data
+ * to read and holds at most @a max_bytes bytes, in which case no data is
+ * copied. Otherwise, a block of @a max_bytes bytes is allocated from
+ * @a pool and up to @a max_bytes bytes of data, as available, are copied
+ * into it.
+ *
+ * The caller must free the memory block with k_mem_pool_free() once done
+ * with the data.
+ *
+ * @param pipe Address of the pipe.
+ * @param pool Memory pool to allocate a block from when copying data.
+ * @param block Address of the area to hold the memory block descriptor.
+ * @param max_bytes Maximum number of data bytes to read.
+ * @param bytes_read Address of area to hold the number of bytes read.
+ * @param timeout Waiting period to wait for data to be available (in
+ *                milliseconds), or one of the special values K_NO_WAIT
+ *                and K_FOREVER.
+ *
+ * @retval 0 At least one data byte was read into @a block.
+ * @retval -EIO Returned without waiting; no data was available.
+ * @retval -EAGAIN Waiting period timed out; no data was read.
+ * @retval -ENOMEM Data was available but no block could be allocated.
+ */
+extern int k_pipe_block_get(struct k_pipe *pipe, struct k_mem_pool *pool,
+			    struct k_mem_block *block, size_t max_bytes,
+			    size_t *bytes_read, s32_t timeout);
+
 /**
  * @} end defgroup pipe_apis
  */
 
+#ifdef CONFIG_MEM_ALLOC_STATS
+/**
+ * @brief Allocation statistics of a memory slab or memory pool.
+ *
+ * Usage is counted in blocks for memory slabs, and in bytes for memory
+ * pools, where it is the size of the blocks handed out, not the size
+ * requested.
+ */
+struct k_mem_alloc_stats {
+	/** Number of successful allocations */
+	u32_t num_allocs;
+	/** Number of blocks freed */
+	u32_t num_frees;
+	/** Number of allocations which failed or timed out */
+	u32_t num_failures;
+	/** Current usage */
+	u32_t used;
+	/** Highest usage since boot or the last reset */
+	u32_t max_used;
+	/** Number of allocations which had to wait */
+	u32_t num_waits;
+	/** Cumulative time spent waiting by allocations (in milliseconds) */
+	u32_t wait_time;
+};
+#endif
+
 /**
  * @cond INTERNAL_HIDDEN
  */
@@ -3088,6 +3738,11 @@ struct k_mem_slab {
 	char *buffer;
 	char *free_list;
 	u32_t num_used;
+	/* blocks never allocated so far are not linked on the free list */
+	u32_t num_carved;
+#ifdef CONFIG_MEM_ALLOC_STATS
+	struct k_mem_alloc_stats stats;
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mem_slab);
 };
@@ -3101,6 +3756,7 @@ struct k_mem_slab {
 	.buffer = slab_buffer, \
 	.free_list = NULL, \
 	.num_used = 0, \
+	.num_carved = 0, \
 	_OBJECT_TRACING_INIT \
 	}
 
@@ -3224,6 +3880,34 @@ static inline u32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 	return slab->num_blocks - slab->num_used;
 }
 
+#ifdef CONFIG_MEM_ALLOC_STATS
+/**
+ * @brief Get the allocation statistics of a memory slab.
+ *
+ * This routine takes a consistent snapshot of the statistics of @a slab,
+ * which usage is counted in blocks.
+ *
+ * @param slab Address of the memory slab.
+ * @param stats Address of the structure to fill.
+ *
+ * @return N/A
+ */
+extern void k_mem_slab_stats_get(struct k_mem_slab *slab,
+				 struct k_mem_alloc_stats *stats);
+
+/**
+ * @brief Reset the allocation statistics of a memory slab.
+ *
+ * This routine clears the counters of @a slab, and sets its highest usage
+ * to its current usage.
+ *
+ * @param slab Address of the memory slab.
+ *
+ * @return N/A
+ */
+extern void k_mem_slab_stats_reset(struct k_mem_slab *slab);
+#endif
+
 /**
  * @} end defgroup mem_slab_apis
  */
@@ -3244,10 +3928,15 @@ struct k_mem_pool {
 	void *buf;
 	size_t max_sz;
 	u16_t n_max;
+	/* largest blocks never allocated so far are not on the free list */
+	u16_t n_carved;
 	u8_t n_levels;
 	u8_t max_inline_level;
 	struct k_mem_pool_lvl *levels;
 	_wait_q_t wait_q;
+#ifdef CONFIG_MEM_ALLOC_STATS
+	struct k_mem_alloc_stats stats;
+#endif
 };
 
 #define _ALIGN4(n) ((((n)+3)/4)*4)
@@ -3345,6 +4034,7 @@ struct k_mem_pool {
 		.n_max = nmax,						\
 		.n_levels = _MPOOL_LVLS(maxsz, minsz),			\
 		.levels = _mpool_lvls_##name,				\
+		.wait_q = SYS_DLIST_STATIC_INIT(&name.wait_q),		\
 	}
 
 /**
@@ -3379,6 +4069,34 @@ extern int k_mem_pool_alloc(struct k_mem_pool *pool, struct k_mem_block *block,
  */
 extern void k_mem_pool_free(struct k_mem_block *block);
 
+#ifdef CONFIG_MEM_ALLOC_STATS
+/**
+ * @brief Get the allocation statistics of a memory pool.
+ *
+ * This routine takes a consistent snapshot of the statistics of @a pool,
+ * which usage is counted in bytes.
+ *
+ * @param pool Address of the memory pool.
+ * @param stats Address of the structure to fill.
+ *
+ * @return N/A
+ */
+extern void k_mem_pool_stats_get(struct k_mem_pool *pool,
+				 struct k_mem_alloc_stats *stats);
+
+/**
+ * @brief Reset the allocation statistics of a memory pool.
+ *
+ * This routine clears the counters of @a pool, and sets its highest usage
+ * to its current usage.
+ *
+ * @param pool Address of the memory pool.
+ *
+ * @return N/A
+ */
+extern void k_mem_pool_stats_reset(struct k_mem_pool *pool);
+#endif
+
 /**
  * @brief Defragment a memory pool.
  *
@@ -3426,6 +4144,60 @@ extern void *k_malloc(size_t size);
  */
 extern void k_free(void *ptr);
 
+#ifdef CONFIG_HEAP_MEM_POOL_CACHE
+
+/**
+ * @brief Number of size classes of the heap memory pool cache.
+ *
+ * Class @a n holds blocks of (32 << @a n) bytes, the hidden block descriptor
+ * of k_malloc() included.
+ */
+#define K_HEAP_CACHE_NUM_CLASSES 5
+
+/**
+ * @brief Heap memory pool cache statistics of a size class.
+ *
+ * Allocations of a size class are either hits, served from the free blocks
+ * of the class, refills, served after carving a heap memory pool block into
+ * free blocks of the class, or misses, served by the heap memory pool
+ * directly (if at all) because it had no block left to carve.
+ *
+ * The difference between the size of the blocks in use and the number of
+ * bytes requested gives the memory lost to internal fragmentation, and the
+ * free blocks are the memory held by the class but available to it only.
+ */
+struct k_heap_cache_stats {
+	/** Size of the blocks of the class, including the block descriptor */
+	size_t block_size;
+	/** Number of blocks carved from the heap memory pool */
+	u32_t num_blocks;
+	/** Number of blocks currently allocated */
+	u32_t num_used;
+	/** Number of allocations served from a free block */
+	u32_t hits;
+	/** Number of allocations which carved a new heap memory pool block */
+	u32_t refills;
+	/** Number of allocations which could not be served by the class */
+	u32_t misses;
+	/** Number of bytes requested by the allocations currently in use */
+	size_t bytes_requested;
+};
+
+/**
+ * @brief Get the heap memory pool cache statistics of a size class.
+ *
+ * @param class_idx Index of the size class, lower than
+ * K_HEAP_CACHE_NUM_CLASSES.
+ * @param stats Address of the structure to fill.
+ *
+ * @retval 0 Statistics filled.
+ * @retval -EINVAL Invalid size class.
+ */
+extern int k_heap_cache_stats_get(unsigned int class_idx,
+				  struct k_heap_cache_stats *stats);
+
+#endif /* CONFIG_HEAP_MEM_POOL_CACHE */
+
 /**
  * @} end defgroup heap_apis
  */
@@ -3438,9 +4210,14 @@ extern void k_free(void *ptr);
 #define _INIT_OBJ_POLL_EVENT(obj) do { } while ((0))
 #endif
 
+struct k_poll_set;
+
 /* private - implementation data created as needed, per-type */
 struct _poller {
 	struct k_thread *thread;
+
+	/* poll set the events belong to, NULL for k_poll() */
+	struct k_poll_set *set;
 };
 
 /* private - types bit positions */
@@ -3490,6 +4267,7 @@ enum _poll_states_bits {
 	       + _POLL_NUM_TYPES \
 	       + _POLL_NUM_STATES \
 	       + 1 /* modes */ \
+	       + 1 /* queued */ \
 	      ))
 
 #if _POLL_EVENT_NUM_UNUSED_BITS < 0
@@ -3568,6 +4346,9 @@ struct k_poll_event {
 	/* mode of operation, from enum k_poll_modes */
 	u32_t mode:1;
 
+	/* PRIVATE - DO NOT TOUCH - in the ready list of a poll set */
+	u32_t queued:1;
+
 	/* unused bits in 32-bit word */
 	u32_t unused:_POLL_EVENT_NUM_UNUSED_BITS;
 
@@ -3579,14 +4360,33 @@ struct k_poll_event {
 		struct k_fifo *fifo;
 		struct k_queue *queue;
 	};
+
+	/* PRIVATE - DO NOT TOUCH - link in the ready list of a poll set */
+	sys_snode_t ready_node;
+};
+
+/* public - poll set object */
+struct k_poll_set {
+	/* PRIVATE - DO NOT TOUCH */
+	struct _poller poller;
+	sys_slist_t ready;
+	_wait_q_t wait_q;
 };
 
+#define K_POLL_SET_INITIALIZER(obj) \
+	{ \
+	.poller = { .thread = NULL, .set = &obj }, \
+	.ready = SYS_SLIST_STATIC_INIT(&obj.ready), \
+	.wait_q = SYS_DLIST_STATIC_INIT(&obj.wait_q), \
+	}
+
 #define K_POLL_EVENT_INITIALIZER(event_type, event_mode, event_obj) \
 	{ \
 	.poller = NULL, \
 	.type = event_type, \
 	.state = K_POLL_STATE_NOT_READY, \
 	.mode = event_mode, \
+	.queued = 0, \
 	.unused = 0, \
 	{ .obj = event_obj }, \
 	}
@@ -3598,6 +4398,7 @@ struct k_poll_event {
 	.tag = event_tag, \
 	.state = K_POLL_STATE_NOT_READY, \
 	.mode = event_mode, \
+	.queued = 0, \
 	.unused = 0, \
 	{ .obj = event_obj }, \
 	}
@@ -3699,6 +4500,88 @@ extern void k_poll_signal_init(struct k_poll_signal *signal);
 
 extern int k_poll_signal(struct k_poll_signal *signal, int result);
 
+/**
+ * @brief Initialize a poll set.
+ *
+ * A poll set is an alternative to k_poll() for a thread waiting on many
+ * events over and over: events are added to the set once and stay registered
+ * on their objects until removed, instead of being registered and
+ * unregistered on every call to k_poll().
+ *
+ * @param set A poll set.
+ *
+ * @return N/A
+ */
+
+extern void k_poll_set_init(struct k_poll_set *set);
+
+/**
+ * @brief Add a poll event to a poll set.
+ *
+ * This routine registers @a event on its object until it is removed from
+ * @a set with k_poll_set_remove(). As with k_poll(), only one event, be it in
+ * a poll set or in a k_poll() call, can be registered on an object at a given
+ * time.
+ *
+ * If the event condition is already fulfilled, the event is reported ready
+ * by the next call to k_poll_set_wait().
+ *
+ * @param set A poll set.
+ * @param event A poll event initialized with k_poll_event_init(). It must not
+ *              be modified or reused while it is in the set.
+ *
+ * @retval 0 Event added.
+ * @retval -EADDRINUSE The object of the event already had a poller.
+ */
+
+extern int k_poll_set_add(struct k_poll_set *set, struct k_poll_event *event);
+
+/**
+ * @brief Remove a poll event from a poll set.
+ *
+ * This routine unregisters @a event from its object. If the event was ready
+ * but not reported yet, it is discarded.
+ *
+ * @param set A poll set.
+ * @param event A poll event previously added to @a set.
+ *
+ * @return N/A
+ */
+
+extern void k_poll_set_remove(struct k_poll_set *set,
+			      struct k_poll_event *event);
+
+/**
+ * @brief Wait for events of a poll set to be ready.
+ *
+ * This routine returns the events of @a set which were signaled since they
+ * were last reported, in the order they were signaled. Readiness is
+ * edge-triggered: an event is reported once per batch of signals of its
+ * object, and is not reported again until its object is signaled again. For
+ * example, a queue event is reported when data is added to the queue, so the
+ * caller should drain the queue rather than expect the event to be reported
+ * again while the queue is not empty.
+ *
+ * The state field of a reported event holds the states signaled since it was
+ * last reported. Unlike with k_poll(), it does not have to be reset.
+ *
+ * The cost of this routine only depends on the number of ready events, not on
+ * the number of events in the set.
+ *
+ * @param set A poll set.
+ * @param events Array to hold the addresses of the ready events.
+ * @param max_events Size of the @a events array. Ready events that do not fit
+ *                   are reported by the next call.
+ * @param timeout Waiting period for an event to be ready (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of ready events stored in @a events.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+
+extern int k_poll_set_wait(struct k_poll_set *set, struct k_poll_event **events,
+			   int max_events, s32_t timeout);
+
 /* private internal function */
 extern int _handle_obj_poll_event(struct k_poll_event **obj_poll_event,
 				  u32_t state);
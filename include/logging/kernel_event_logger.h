@@ -30,6 +30,34 @@ extern "C" {
 extern struct event_logger sys_k_event_logger;
 extern int _sys_k_event_logger_mask;
 
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_TRACE
+/**
+ * @brief Record of the binary trace backend.
+ *
+ * Records are written in the native byte order of the CPU, and the
+ * timestamps come from the same source as the event logger ones.
+ */
+struct sys_k_trace_record {
+	/** Sequence number of the record plus one, set once it is complete */
+	u32_t seq;
+	/** Time of the event */
+	u32_t timestamp;
+	/** Event ID, as for the event logger */
+	u16_t event_id;
+	/** Number of events dropped before this one, saturated */
+	u16_t dropped;
+	/** Event data following the timestamp in the event logger format */
+	u32_t data[2];
+};
+
+extern void _sys_k_trace_put(u16_t event_id, u32_t data0, u32_t data1);
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_TRACE_RAM
+extern struct sys_k_trace_record
+	sys_k_trace_dump[CONFIG_KERNEL_EVENT_LOGGER_TRACE_RAM_RECORDS];
+#endif
+#endif /* CONFIG_KERNEL_EVENT_LOGGER_TRACE */
+
 #ifdef CONFIG_KERNEL_EVENT_LOGGER_SLEEP
 extern void _sys_k_event_logger_enter_sleep(void);
 extern void _sys_k_event_logger_exit_sleep(void);
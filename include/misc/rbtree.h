@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * @brief Header where red-black tree utility code is found
+ *
+ * The tree is intrusive: a sys_rbnode_t is embedded in the structures to
+ * sort, and the ordering is defined by a "less than" function given when
+ * initializing the tree. Nodes which compare equal are kept in the order they
+ * were inserted, the last one inserted being the greatest.
+ *
+ * Insertion and removal are O(log n), finding the minimum or maximum is
+ * O(log n), and stepping to the next or previous node is O(1) amortized.
+ * No operation uses recursion.
+ */
+
+#ifndef __RBTREE_H__
+#define __RBTREE_H__
+
+#include <stddef.h>
+#include <zephyr/types.h>
+#include <misc/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct _rbnode {
+	struct _rbnode *left;
+	struct _rbnode *right;
+	struct _rbnode *parent;
+	u8_t red;
+};
+
+typedef struct _rbnode sys_rbnode_t;
+
+/**
+ * @brief Comparison function of a red-black tree
+ *
+ * @return non-zero if a must be sorted before b, 0 otherwise
+ */
+typedef int (*sys_rb_lessthan_t)(sys_rbnode_t *a, sys_rbnode_t *b);
+
+struct _rbtree {
+	sys_rbnode_t *root;
+	sys_rb_lessthan_t lessthan;
+};
+
+typedef struct _rbtree sys_rbtree_t;
+
+/**
+ * @brief Provide the primitive to iterate on a tree, in order
+ * Note: the loop is unsafe and thus __rn should not be removed
+ *
+ * User _MUST_ add the loop statement curly braces enclosing its own code:
+ *
+ *     SYS_RB_FOR_EACH_NODE(t, n) {
+ *         <user code>
+ *     }
+ *
+ * @param __rt A pointer on a sys_rbtree_t to iterate on
+ * @param __rn A sys_rbnode_t pointer to peek each node of the tree
+ */
+#define SYS_RB_FOR_EACH_NODE(__rt, __rn)				\
+	for (__rn = sys_rb_get_min(__rt); __rn;				\
+	     __rn = sys_rb_next(__rn))
+
+/**
+ * @brief Provide the primitive to iterate on a tree under a container, in
+ * order
+ * Note: the loop is unsafe and thus __cn should not be detached
+ *
+ * User _MUST_ add the loop statement curly braces enclosing its own code:
+ *
+ *     SYS_RB_FOR_EACH_CONTAINER(t, c, n) {
+ *         <user code>
+ *     }
+ *
+ * @param __rt A pointer on a sys_rbtree_t to iterate on
+ * @param __cn A pointer to peek each entry of the tree
+ * @param __n The field name of sys_rbnode_t within the container struct
+ */
+#define SYS_RB_FOR_EACH_CONTAINER(__rt, __cn, __n)			\
+	for (__cn = SYS_RB_CONTAINER(sys_rb_get_min(__rt), __cn, __n);	\
+	     __cn;							\
+	     __cn = SYS_RB_CONTAINER(sys_rb_next(&__cn->__n), __cn, __n))
+
+/*
+ * @brief Get a pointer to the container of a node, or NULL if the node is NULL
+ *
+ * @param __rn A pointer on a sys_rbnode_t to get its container
+ * @param __cn Container struct type pointer
+ * @param __n The field name of sys_rbnode_t within the container struct
+ */
+#define SYS_RB_CONTAINER(__rn, __cn, __n) \
+	((__rn) ? CONTAINER_OF(__rn, __typeof__(*(__cn)), __n) : NULL)
+
+/**
+ * @brief Initialize a tree
+ *
+ * @param tree A pointer on the tree to initialize
+ * @param lessthan Function defining the order of the nodes in the tree
+ */
+static inline void sys_rb_init(sys_rbtree_t *tree, sys_rb_lessthan_t lessthan)
+{
+	tree->root = NULL;
+	tree->lessthan = lessthan;
+}
+
+#define SYS_RB_STATIC_INIT(lessthan_fn) {.root = NULL, .lessthan = lessthan_fn}
+
+/**
+ * @brief Test if the given tree is empty
+ *
+ * @param tree A pointer on the tree to test
+ *
+ * @return a boolean, true if it's empty, false otherwise
+ */
+static inline int sys_rb_is_empty(sys_rbtree_t *tree)
+{
+	return !tree->root;
+}
+
+/**
+ * @brief Insert a node in the tree
+ *
+ * The node is inserted after any node it compares equal to.
+ *
+ * @param tree A pointer on the tree to affect
+ * @param node A pointer on the node to insert, must not be in a tree
+ */
+extern void sys_rb_insert(sys_rbtree_t *tree, sys_rbnode_t *node);
+
+/**
+ * @brief Remove a node from the tree
+ *
+ * @param tree A pointer on the tree to affect
+ * @param node A pointer on the node to remove, must be in the tree
+ */
+extern void sys_rb_remove(sys_rbtree_t *tree, sys_rbnode_t *node);
+
+/**
+ * @brief Get the smallest node of the tree
+ *
+ * @param tree A pointer on the tree to look into
+ *
+ * @return A pointer on the smallest node, or NULL if the tree is empty
+ */
+extern sys_rbnode_t *sys_rb_get_min(sys_rbtree_t *tree);
+
+/**
+ * @brief Get the greatest node of the tree
+ *
+ * @param tree A pointer on the tree to look into
+ *
+ * @return A pointer on the greatest node, or NULL if the tree is empty
+ */
+extern sys_rbnode_t *sys_rb_get_max(sys_rbtree_t *tree);
+
+/**
+ * @brief Get the node following a node in the tree order
+ *
+ * @param node A pointer on a node in a tree
+ *
+ * @return A pointer on the next node, or NULL if node is the greatest one
+ */
+extern sys_rbnode_t *sys_rb_next(sys_rbnode_t *node);
+
+/**
+ * @brief Get the node preceding a node in the tree order
+ *
+ * @param node A pointer on a node in a tree
+ *
+ * @return A pointer on the previous node, or NULL if node is the smallest one
+ */
+extern sys_rbnode_t *sys_rb_prev(sys_rbnode_t *node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RBTREE_H__ */
@@ -68,7 +68,10 @@ struct net_pkt {
 	u8_t ip_hdr_len;	/* pre-filled in order to avoid func call */
 
 #if defined(CONFIG_NET_TCP)
-	sys_snode_t sent_list;
+	sys_snode_t sent_list;	/* For outgoing packet: TCP retransmit
+				 * queue. For incoming packet: TCP out of
+				 * order queue.
+				 */
 #endif
 
 	u8_t sent_or_eof: 1;	/* For outgoing packet: is this sent or not
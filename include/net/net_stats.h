@@ -113,6 +113,19 @@ struct net_stats_tcp {
 	/** Number of retransmitted TCP segments. */
 	net_stats_t rexmit;
 
+	/** Number of received TCP segments held out of order. */
+	net_stats_t ooo;
+
+	/** Number of TCP segments held out of order and passed on once the
+	 * missing data was received.
+	 */
+	net_stats_t ooo_merged;
+
+	/** Number of out of order TCP segments dropped, because too many of
+	 * them were held or because their data was received again.
+	 */
+	net_stats_t ooo_drop;
+
 	/** Number of dropped connection attempts because too few connections
 	 * were available.
 	 */
@@ -65,15 +65,31 @@ struct _ready_q {
 	/* always contains next thread to run: cannot be NULL */
 	struct k_thread *cache;
 
+#ifdef CONFIG_SCHED_SCALABLE
+	/* all ready threads, sorted by priority, then deadline */
+	sys_rbtree_t tree;
+#else
 	/* bitmap of priorities that contain at least one ready thread */
 	u32_t prio_bmap[K_NUM_PRIO_BITMAPS];
 
 	/* ready queues, one per priority */
 	sys_dlist_t q[K_NUM_PRIORITIES];
+#endif
 };
 
 typedef struct _ready_q _ready_q_t;
 
+#ifdef CONFIG_TIMEOUT_QUEUE_PAIRING_HEAP
+struct _timeout_heap {
+
+	/* timeout expiring the soonest, NULL if the heap is empty */
+	struct _timeout *root;
+
+	/* ticks announced so far: time base of the timeouts' expiry */
+	u32_t now;
+};
+#endif
+
 struct _kernel {
 
 	/* nested interrupt count */
@@ -87,8 +103,12 @@ struct _kernel {
 
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 	/* queue of timeouts */
+#ifdef CONFIG_TIMEOUT_QUEUE_PAIRING_HEAP
+	struct _timeout_heap timeout_q;
+#else
 	sys_dlist_t timeout_q;
 #endif
+#endif
 
 #ifdef CONFIG_SYS_POWER_MANAGEMENT
 	s32_t idle; /* Number of ticks for kernel idling */
@@ -146,6 +166,10 @@ extern void _init_thread_base(struct _thread_base *thread_base,
 			      int priority, u32_t initial_state,
 			      unsigned int options);
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+extern void _thread_runtime_stats_tick(void);
+#endif
+
 static ALWAYS_INLINE void _new_thread_init(struct k_thread *thread,
 					    char *pStack, size_t stackSize,
 					    int prio, unsigned int options)
@@ -181,6 +205,13 @@ static ALWAYS_INLINE void _new_thread_init(struct k_thread *thread,
 	thread->stack_info.start = (u32_t)pStack;
 	thread->stack_info.size = (u32_t)stackSize;
 #endif /* CONFIG_THREAD_STACK_INFO */
+
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+	thread->rt_stats.cycles = 0;
+	thread->rt_stats.switched_in = 0;
+	thread->rt_stats.num_switches = 0;
+	thread->rt_stats.num_preemptions = 0;
+#endif /* CONFIG_THREAD_RUNTIME_STATS */
 }
 
 #if defined(CONFIG_THREAD_MONITOR)
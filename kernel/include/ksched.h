@@ -23,10 +23,15 @@ extern void k_sched_unlock(void);
 extern void _pend_thread(struct k_thread *thread,
 			 _wait_q_t *wait_q, s32_t timeout);
 extern void _pend_current_thread(_wait_q_t *wait_q, s32_t timeout);
+extern void _reorder_pending_thread(struct k_thread *thread,
+				   _wait_q_t *wait_q);
 extern void _move_thread_to_end_of_prio_q(struct k_thread *thread);
 extern int __must_switch_threads(void);
 extern int _is_thread_time_slicing(struct k_thread *thread);
 extern void _update_time_slice_before_swap(void);
+#ifdef CONFIG_SCHED_SCALABLE
+extern int _ready_q_lessthan(sys_rbnode_t *a, sys_rbnode_t *b);
+#endif
 #ifdef _NON_OPTIMIZED_TICKS_PER_SEC
 extern s32_t _ms_to_ticks(s32_t ms);
 #endif
@@ -121,6 +126,13 @@ static inline int _is_prio_lower(int prio1, int prio2)
 static inline int _is_t1_higher_prio_than_t2(struct k_thread *t1,
 					     struct k_thread *t2)
 {
+#ifdef CONFIG_SCHED_DEADLINE
+	/* among threads of equal priority, the earliest deadline wins */
+	if (t1->base.prio == t2->base.prio) {
+		return (s32_t)(t1->base.prio_deadline -
+			       t2->base.prio_deadline) < 0;
+	}
+#endif
 	return _is_prio1_higher_than_prio2(t1->base.prio, t2->base.prio);
 }
 
@@ -199,6 +211,13 @@ static inline int _get_ready_q_q_index(int prio)
 
 /* find out the currently highest priority where a thread is ready to run */
 /* interrupts must be locked */
+#ifdef CONFIG_SCHED_SCALABLE
+static inline int _get_highest_ready_prio(void)
+{
+	/* the cache always holds the first thread of the ready queue */
+	return _ready_q.cache->base.prio;
+}
+#else
 static inline int _get_highest_ready_prio(void)
 {
 	int bitmap = 0;
@@ -224,6 +243,7 @@ static inline int _get_highest_ready_prio(void)
 
 	return abs_prio - _NUM_COOP_PRIO;
 }
+#endif
 
 /*
  * Checks if current thread must be context-switched out. The caller must
@@ -357,6 +377,10 @@ static inline void _mark_thread_as_pending(struct k_thread *thread)
 static inline void _mark_thread_as_not_pending(struct k_thread *thread)
 {
 	thread->base.thread_state &= ~_THREAD_PENDING;
+
+#ifdef CONFIG_SCHED_DEADLINE
+	thread->base.pended_on = NULL;
+#endif
 }
 
 /* check if a thread is pending */
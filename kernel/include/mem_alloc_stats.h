@@ -0,0 +1,78 @@
+/* allocation statistics of memory slabs and memory pools */
+
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _kernel_include_mem_alloc_stats__h_
+#define _kernel_include_mem_alloc_stats__h_
+
+#include <kernel.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef CONFIG_MEM_ALLOC_STATS
+
+/* all the routines below must be called with interrupts locked */
+
+static inline void _mem_stats_alloc(struct k_mem_alloc_stats *stats,
+				    u32_t amount)
+{
+	stats->num_allocs++;
+	stats->used += amount;
+	if (stats->used > stats->max_used) {
+		stats->max_used = stats->used;
+	}
+}
+
+static inline void _mem_stats_free(struct k_mem_alloc_stats *stats,
+				   u32_t amount)
+{
+	stats->num_frees++;
+	stats->used -= amount;
+}
+
+static inline void _mem_stats_fail(struct k_mem_alloc_stats *stats)
+{
+	stats->num_failures++;
+}
+
+/* account for an allocation which started waiting at 'start' (in ms) */
+static inline void _mem_stats_wait(struct k_mem_alloc_stats *stats,
+				   u32_t start)
+{
+	stats->num_waits++;
+	stats->wait_time += k_uptime_get_32() - start;
+}
+
+static inline void _mem_stats_reset(struct k_mem_alloc_stats *stats)
+{
+	u32_t used = stats->used;
+
+	memset(stats, 0, sizeof(*stats));
+	stats->used = used;
+	stats->max_used = used;
+}
+
+#define _MEM_STATS_ALLOC(obj, amount) _mem_stats_alloc(&(obj)->stats, amount)
+#define _MEM_STATS_FREE(obj, amount) _mem_stats_free(&(obj)->stats, amount)
+#define _MEM_STATS_FAIL(obj) _mem_stats_fail(&(obj)->stats)
+
+#else
+
+#define _MEM_STATS_ALLOC(obj, amount) do { } while ((0))
+#define _MEM_STATS_FREE(obj, amount) do { } while ((0))
+#define _MEM_STATS_FAIL(obj) do { } while ((0))
+
+#endif /* CONFIG_MEM_ALLOC_STATS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _kernel_include_mem_alloc_stats__h_ */
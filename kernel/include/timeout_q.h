@@ -116,13 +116,175 @@ static inline void _handle_expired_timeouts(sys_dlist_t *expired)
 	}
 }
 
-/* returns _INACTIVE if the timer is not active */
-static inline int _abort_timeout(struct _timeout *timeout)
+#ifdef CONFIG_TIMEOUT_QUEUE_PAIRING_HEAP
+
+/*
+ * Pairing heap backend: each timeout records the absolute tick at which it
+ * expires, relative to _timeout_q.now, which advances as ticks are announced.
+ * Inserting is O(1) and removing is O(log n) amortized, instead of the O(n)
+ * walk of the delta list, both with interrupts locked.
+ *
+ * Timeouts expiring on the same tick are not guaranteed to be handled in the
+ * order they were queued.
+ */
+
+extern void _timeout_heap_insert(struct _timeout *timeout);
+extern void _timeout_heap_remove(struct _timeout *timeout);
+
+static inline struct _timeout *_timeout_q_first(void)
 {
-	if (timeout->delta_ticks_from_prev == _INACTIVE) {
-		return _INACTIVE;
+	return _timeout_q.root;
+}
+
+/* number of ticks before the timeout expires, must be in the queue */
+static inline s32_t _timeout_ticks_left(struct _timeout *timeout)
+{
+	/* tick count wraps around: only the distance is meaningful */
+	return (s32_t)(timeout->expiry - _timeout_q.now);
+}
+
+static inline int _timeout_has_expired(struct _timeout *timeout)
+{
+	return _timeout_ticks_left(timeout) <= 0;
+}
+
+static inline void _timeout_q_elapse(s32_t ticks)
+{
+	_timeout_q.now += ticks;
+}
+
+static inline void _timeout_q_insert(struct _timeout *timeout, s32_t ticks)
+{
+	timeout->expiry = _timeout_q.now + ticks;
+	_timeout_heap_insert(timeout);
+}
+
+static inline void _timeout_q_remove(struct _timeout *timeout)
+{
+	_timeout_heap_remove(timeout);
+}
+
+/* expired timeouts are dequeued in expiry order: keep that order */
+static inline void _timeout_q_add_expired(sys_dlist_t *expired,
+					  struct _timeout *timeout)
+{
+	sys_dlist_append(expired, &timeout->node);
+}
+
+static inline void _dump_timeout(struct _timeout *timeout, int extra_tab)
+{
+#ifdef CONFIG_KERNEL_DEBUG
+	char *tab = extra_tab ? "\t" : "";
+
+	K_DEBUG("%stimeout %p, child: %p, next: %p, prev: %p\n"
+		"%s\tthread: %p, wait_q: %p\n"
+		"%s\texpiry: %u\n"
+		"%s\tfunction: %p\n",
+		tab, timeout, timeout->heap_child, timeout->heap_next,
+		timeout->heap_prev,
+		tab, timeout->thread, timeout->wait_q,
+		tab, timeout->expiry,
+		tab, timeout->func);
+#endif
+}
+
+static inline void _dump_timeout_q(void)
+{
+#ifdef CONFIG_KERNEL_DEBUG
+	K_DEBUG("_timeout_q: %p, root: %p, now: %u\n",
+		&_timeout_q, _timeout_q.root, _timeout_q.now);
+
+	if (_timeout_q.root) {
+		_dump_timeout(_timeout_q.root, 1);
 	}
+#endif
+}
+
+#else /* CONFIG_TIMEOUT_QUEUE_PAIRING_HEAP */
+
+/*
+ * Delta list backend: each timeout records the number of ticks between its
+ * expiry and the expiry of the timeout preceding it in _timeout_q.
+ */
+
+static inline struct _timeout *_timeout_q_first(void)
+{
+	return (struct _timeout *)sys_dlist_peek_head(&_timeout_q);
+}
 
+/* number of ticks before the timeout expires, must be in the queue */
+static inline s32_t _timeout_ticks_left(struct _timeout *timeout)
+{
+	/*
+	 * compute remaining ticks by walking the timeout list
+	 * and summing up the various tick deltas involved
+	 */
+	struct _timeout *t = _timeout_q_first();
+	s32_t ticks = t->delta_ticks_from_prev;
+
+	while (t != timeout) {
+		t = (struct _timeout *)sys_dlist_peek_next(&_timeout_q,
+							   &t->node);
+		ticks += t->delta_ticks_from_prev;
+	}
+
+	return ticks;
+}
+
+/*
+ * We know that no new timeout will be prepended in front of a timeout which
+ * delta is 0, since timeouts of 0 ticks are prohibited.
+ */
+static inline int _timeout_has_expired(struct _timeout *timeout)
+{
+	return timeout->delta_ticks_from_prev == 0;
+}
+
+static inline void _timeout_q_elapse(s32_t ticks)
+{
+	struct _timeout *head = _timeout_q_first();
+
+	if (head) {
+		head->delta_ticks_from_prev -= ticks;
+	}
+}
+
+/*
+ * If the new timeout is expiring on the same system clock tick as other
+ * timeouts already present in the _timeout_q, it is be _prepended_ to these
+ * timeouts. This allows exiting the loop sooner, which is good, since
+ * interrupts are locked while trying to find the insert point. Note that the
+ * timeouts are then processed in the _reverse order_ if they expire on the
+ * same tick.
+ *
+ * This should not cause problems to applications, unless they really expect
+ * two timeouts queued very close to one another to expire in the same order
+ * they were queued. This could be changed at the cost of potential longer
+ * interrupt latency.
+ */
+static inline void _timeout_q_insert(struct _timeout *timeout, s32_t ticks)
+{
+	s32_t *delta = &timeout->delta_ticks_from_prev;
+	struct _timeout *in_q;
+
+	*delta = ticks;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&_timeout_q, in_q, node) {
+		if (*delta <= in_q->delta_ticks_from_prev) {
+			in_q->delta_ticks_from_prev -= *delta;
+			sys_dlist_insert_before(&_timeout_q, &in_q->node,
+						&timeout->node);
+			return;
+		}
+
+		*delta -= in_q->delta_ticks_from_prev;
+	}
+
+	sys_dlist_append(&_timeout_q, &timeout->node);
+}
+
+static inline void _timeout_q_remove(struct _timeout *timeout)
+{
 	if (!sys_dlist_is_tail(&_timeout_q, &timeout->node)) {
 		sys_dnode_t *next_node =
 			sys_dlist_peek_next(&_timeout_q, &timeout->node);
@@ -131,15 +293,19 @@ static inline int _abort_timeout(struct _timeout *timeout)
 		next->delta_ticks_from_prev += timeout->delta_ticks_from_prev;
 	}
 	sys_dlist_remove(&timeout->node);
-	timeout->delta_ticks_from_prev = _INACTIVE;
-
-	return 0;
 }
 
-/* returns _INACTIVE if the timer has already expired */
-static inline int _abort_thread_timeout(struct k_thread *thread)
+/*
+ * Reverse the order that that were queued in the timeout_q: timeouts expiring
+ * on the same ticks are queued in the reverse order, time-wise, that they are
+ * added to shorten the amount of time with interrupts locked while walking the
+ * timeout_q. By reversing the order _again_ when building the expired queue,
+ * they end up being processed in the same order they were added, time-wise.
+ */
+static inline void _timeout_q_add_expired(sys_dlist_t *expired,
+					  struct _timeout *timeout)
 {
-	return _abort_timeout(&thread->base.timeout);
+	sys_dlist_prepend(expired, &timeout->node);
 }
 
 static inline void _dump_timeout(struct _timeout *timeout, int extra_tab)
@@ -172,23 +338,32 @@ static inline void _dump_timeout_q(void)
 #endif
 }
 
+#endif /* CONFIG_TIMEOUT_QUEUE_PAIRING_HEAP */
+
+/* returns _INACTIVE if the timer is not active */
+static inline int _abort_timeout(struct _timeout *timeout)
+{
+	if (timeout->delta_ticks_from_prev == _INACTIVE) {
+		return _INACTIVE;
+	}
+
+	_timeout_q_remove(timeout);
+	timeout->delta_ticks_from_prev = _INACTIVE;
+
+	return 0;
+}
+
+/* returns _INACTIVE if the timer has already expired */
+static inline int _abort_thread_timeout(struct k_thread *thread)
+{
+	return _abort_timeout(&thread->base.timeout);
+}
+
 /*
  * Add timeout to timeout queue. Record waiting thread and wait queue if any.
  *
  * Cannot handle timeout == 0 and timeout == K_FOREVER.
  *
- * If the new timeout is expiring on the same system clock tick as other
- * timeouts already present in the _timeout_q, it is be _prepended_ to these
- * timeouts. This allows exiting the loop sooner, which is good, since
- * interrupts are locked while trying to find the insert point. Note that the
- * timeouts are then processed in the _reverse order_ if they expire on the
- * same tick.
- *
- * This should not cause problems to applications, unless they really expect
- * two timeouts queued very close to one another to expire in the same order
- * they were queued. This could be changed at the cost of potential longer
- * interrupt latency.
- *
  * Must be called with interrupts locked.
  */
 
@@ -207,9 +382,6 @@ static inline void _add_timeout(struct k_thread *thread,
 	_dump_timeout(timeout, 0);
 	_dump_timeout_q();
 
-	s32_t *delta = &timeout->delta_ticks_from_prev;
-	struct _timeout *in_q;
-
 #ifdef CONFIG_TICKLESS_KERNEL
 	/*
 	 * If some time has already passed since timer was last
@@ -222,24 +394,13 @@ static inline void _add_timeout(struct k_thread *thread,
 	u32_t program_time = _get_program_time();
 
 	if (program_time > 0) {
-		*delta += _get_elapsed_program_time();
+		timeout_in_ticks += _get_elapsed_program_time();
 	}
-	adjusted_timeout = *delta;
+	adjusted_timeout = timeout_in_ticks;
 #endif
-	SYS_DLIST_FOR_EACH_CONTAINER(&_timeout_q, in_q, node) {
-		if (*delta <= in_q->delta_ticks_from_prev) {
-			in_q->delta_ticks_from_prev -= *delta;
-			sys_dlist_insert_before(&_timeout_q, &in_q->node,
-						&timeout->node);
-			goto inserted;
-		}
 
-		*delta -= in_q->delta_ticks_from_prev;
-	}
-
-	sys_dlist_append(&_timeout_q, &timeout->node);
+	_timeout_q_insert(timeout, timeout_in_ticks);
 
-inserted:
 	K_DEBUG("after adding timeout %p\n", timeout);
 	_dump_timeout(timeout, 0);
 	_dump_timeout_q();
@@ -270,10 +431,9 @@ static inline void _add_thread_timeout(struct k_thread *thread,
 
 static inline s32_t _get_next_timeout_expiry(void)
 {
-	struct _timeout *t = (struct _timeout *)
-			     sys_dlist_peek_head(&_timeout_q);
+	struct _timeout *t = _timeout_q_first();
 
-	return t ? t->delta_ticks_from_prev : K_FOREVER;
+	return t ? _timeout_ticks_left(t) : K_FOREVER;
 }
 
 #ifdef __cplusplus
@@ -100,7 +100,12 @@ k_tid_t const _idle_thread = (k_tid_t)&_idle_thread_s;
 #endif
 K_THREAD_STACK_DEFINE(_interrupt_stack, CONFIG_ISR_STACK_SIZE);
 
-#ifdef CONFIG_SYS_CLOCK_EXISTS
+#if defined(CONFIG_TIMEOUT_QUEUE_PAIRING_HEAP)
+	#define initialize_timeouts() do { \
+		_timeout_q.root = NULL; \
+		_timeout_q.now = 0; \
+	} while ((0))
+#elif defined(CONFIG_SYS_CLOCK_EXISTS)
 	#include <misc/dlist.h>
 	#define initialize_timeouts() do { \
 		sys_dlist_init(&_timeout_q); \
@@ -266,9 +271,13 @@ static void prepare_multithreading(struct k_thread *dummy_thread)
 
 	/* ready the init/main and idle threads */
 
+#ifdef CONFIG_SCHED_SCALABLE
+	sys_rb_init(&_ready_q.tree, _ready_q_lessthan);
+#else
 	for (int ii = 0; ii < K_NUM_PRIORITIES; ii++) {
 		sys_dlist_init(&_ready_q.q[ii]);
 	}
+#endif
 
 	/*
 	 * prime the cache with the main thread since:
@@ -30,12 +30,35 @@ struct k_mbox_async {
 /* array of asynchronous message descriptors */
 static struct k_mbox_async __noinit async_msg[CONFIG_NUM_MBOX_ASYNC_MSGS];
 
-/* stack of unused asynchronous message descriptors */
+/* stack of freed asynchronous message descriptors */
 K_STACK_DEFINE(async_msg_free, CONFIG_NUM_MBOX_ASYNC_MSGS);
 
-/* allocate an asynchronous message descriptor */
-static inline void _mbox_async_alloc(struct k_mbox_async **async)
+/* number of descriptors ever allocated, the others are not on the stack */
+static int async_msg_carved;
+
+/*
+ * Allocate an asynchronous message descriptor. The descriptors never used so
+ * far are taken first, and set up then rather than at boot.
+ *
+ * A dummy thread requires minimal initialization, since it never gets to
+ * execute. The _THREAD_DUMMY flag is sufficient to distinguish a dummy
+ * thread from a real one. The threads are *not* added to the kernel's list
+ * of known threads.
+ */
+static void _mbox_async_alloc(struct k_mbox_async **async)
 {
+	unsigned int key = irq_lock();
+
+	if (async_msg_carved < CONFIG_NUM_MBOX_ASYNC_MSGS) {
+		*async = &async_msg[async_msg_carved++];
+		irq_unlock(key);
+
+		_init_thread_base(&(*async)->thread, 0, _THREAD_DUMMY, 0);
+		return;
+	}
+
+	irq_unlock(key);
+
 	k_stack_pop(&async_msg_free, (u32_t *)async, K_FOREVER);
 }
 
@@ -54,53 +77,27 @@ extern struct k_mbox _k_mbox_list_end[];
 struct k_mbox *_trace_list_k_mbox;
 #endif	/* CONFIG_OBJECT_TRACING */
 
-#if (CONFIG_NUM_MBOX_ASYNC_MSGS > 0) || \
-	defined(CONFIG_OBJECT_TRACING)
+#ifdef CONFIG_OBJECT_TRACING
 
 /*
- * Do run-time initialization of mailbox object subsystem.
+ * Complete initialization of statically defined mailboxes.
  */
 static int init_mbox_module(struct device *dev)
 {
 	ARG_UNUSED(dev);
 
-#if (CONFIG_NUM_MBOX_ASYNC_MSGS > 0)
-	/*
-	 * Create pool of asynchronous message descriptors.
-	 *
-	 * A dummy thread requires minimal initialization, since it never gets
-	 * to execute. The _THREAD_DUMMY flag is sufficient to distinguish a
-	 * dummy thread from a real one. The threads are *not* added to the
-	 * kernel's list of known threads.
-	 *
-	 * Once initialized, the address of each descriptor is added to a stack
-	 * that governs access to them.
-	 */
-
-	int i;
-
-	for (i = 0; i < CONFIG_NUM_MBOX_ASYNC_MSGS; i++) {
-		_init_thread_base(&async_msg[i].thread, 0, _THREAD_DUMMY, 0);
-		k_stack_push(&async_msg_free, (u32_t)&async_msg[i]);
-	}
-#endif /* CONFIG_NUM_MBOX_ASYNC_MSGS > 0 */
-
-	/* Complete initialization of statically defined mailboxes. */
-
-#ifdef CONFIG_OBJECT_TRACING
 	struct k_mbox *mbox;
 
 	for (mbox = _k_mbox_list_start; mbox < _k_mbox_list_end; mbox++) {
 		SYS_TRACING_OBJ_INIT(k_mbox, mbox);
 	}
-#endif /* CONFIG_OBJECT_TRACING */
 
 	return 0;
 }
 
 SYS_INIT(init_mbox_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 
-#endif /* CONFIG_NUM_MBOX_ASYNC_MSGS or CONFIG_OBJECT_TRACING */
+#endif /* CONFIG_OBJECT_TRACING */
 
 void k_mbox_init(struct k_mbox *mbox_ptr)
 {
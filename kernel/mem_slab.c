@@ -13,36 +13,13 @@
 #include <misc/dlist.h>
 #include <ksched.h>
 #include <init.h>
+#include <mem_alloc_stats.h>
 
 extern struct k_mem_slab _k_mem_slab_list_start[];
 extern struct k_mem_slab _k_mem_slab_list_end[];
 
 #ifdef CONFIG_OBJECT_TRACING
 struct k_mem_slab *_trace_list_k_mem_slab;
-#endif	/* CONFIG_OBJECT_TRACING */
-
-/**
- * @brief Initialize kernel memory slab subsystem.
- *
- * Perform any initialization of memory slabs that wasn't done at build time.
- * Currently this just involves creating the list of free blocks for each slab.
- *
- * @return N/A
- */
-static void create_free_list(struct k_mem_slab *slab)
-{
-	u32_t j;
-	char *p;
-
-	slab->free_list = NULL;
-	p = slab->buffer;
-
-	for (j = 0; j < slab->num_blocks; j++) {
-		*(char **)p = slab->free_list;
-		slab->free_list = p;
-		p += slab->block_size;
-	}
-}
 
 /**
  * @brief Complete initialization of statically defined memory slabs.
@@ -60,7 +37,6 @@ static int init_mem_slab_module(struct device *dev)
 	for (slab = _k_mem_slab_list_start;
 	     slab < _k_mem_slab_list_end;
 	     slab++) {
-		create_free_list(slab);
 		SYS_TRACING_OBJ_INIT(k_mem_slab, slab);
 	}
 	return 0;
@@ -68,6 +44,31 @@ static int init_mem_slab_module(struct device *dev)
 
 SYS_INIT(init_mem_slab_module, PRE_KERNEL_1,
 	 CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+#endif	/* CONFIG_OBJECT_TRACING */
+
+/*
+ * Take a free block, or return NULL if there is none.
+ *
+ * The free list only links the blocks that were freed: the blocks never
+ * allocated so far are carved from the end of the buffer in use, so that a
+ * slab is usable as initialized at build time, without a pass over its
+ * buffer at boot.
+ *
+ * Interrupts must be locked when calling this function.
+ */
+static char *take_free_block(struct k_mem_slab *slab)
+{
+	char *block = slab->free_list;
+
+	if (block != NULL) {
+		slab->free_list = *(char **)block;
+	} else if (slab->num_carved < slab->num_blocks) {
+		block = slab->buffer + slab->num_carved * slab->block_size;
+		slab->num_carved++;
+	}
+
+	return block;
+}
 
 void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 		    size_t block_size, u32_t num_blocks)
@@ -75,8 +76,12 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->num_blocks = num_blocks;
 	slab->block_size = block_size;
 	slab->buffer = buffer;
+	slab->free_list = NULL;
 	slab->num_used = 0;
-	create_free_list(slab);
+	slab->num_carved = 0;
+#ifdef CONFIG_MEM_ALLOC_STATS
+	memset(&slab->stats, 0, sizeof(slab->stats));
+#endif
 	sys_dlist_init(&slab->wait_q);
 	SYS_TRACING_OBJ_INIT(k_mem_slab, slab);
 }
@@ -84,25 +89,42 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 {
 	unsigned int key = irq_lock();
+	char *block = take_free_block(slab);
 	int result;
 
-	if (slab->free_list != NULL) {
+	if (block != NULL) {
 		/* take a free block */
-		*mem = slab->free_list;
-		slab->free_list = *(char **)(slab->free_list);
+		*mem = block;
 		slab->num_used++;
+		_MEM_STATS_ALLOC(slab, 1);
 		result = 0;
 	} else if (timeout == K_NO_WAIT) {
 		/* don't wait for a free block to become available */
 		*mem = NULL;
+		_MEM_STATS_FAIL(slab);
 		result = -ENOMEM;
 	} else {
+#ifdef CONFIG_MEM_ALLOC_STATS
+		u32_t wait_start = k_uptime_get_32();
+#endif
+
 		/* wait for a free block or timeout */
 		_pend_current_thread(&slab->wait_q, timeout);
 		result = _Swap(key);
 		if (result == 0) {
 			*mem = _current->base.swap_data;
 		}
+
+#ifdef CONFIG_MEM_ALLOC_STATS
+		key = irq_lock();
+		_mem_stats_wait(&slab->stats, wait_start);
+		if (result == 0) {
+			_MEM_STATS_ALLOC(slab, 1);
+		} else {
+			_MEM_STATS_FAIL(slab);
+		}
+		irq_unlock(key);
+#endif
 		return result;
 	}
 
@@ -116,6 +138,9 @@ void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 	int key = irq_lock();
 	struct k_thread *pending_thread = _unpend_first_thread(&slab->wait_q);
 
+	/* a block handed to a waiting thread is counted as allocated again */
+	_MEM_STATS_FREE(slab, 1);
+
 	if (pending_thread) {
 		_set_thread_return_value_with_data(pending_thread, 0, *mem);
 		_abort_thread_timeout(pending_thread);
@@ -132,3 +157,22 @@ void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 
 	irq_unlock(key);
 }
+
+#ifdef CONFIG_MEM_ALLOC_STATS
+void k_mem_slab_stats_get(struct k_mem_slab *slab,
+			  struct k_mem_alloc_stats *stats)
+{
+	int key = irq_lock();
+
+	*stats = slab->stats;
+	irq_unlock(key);
+}
+
+void k_mem_slab_stats_reset(struct k_mem_slab *slab)
+{
+	int key = irq_lock();
+
+	_mem_stats_reset(&slab->stats);
+	irq_unlock(key);
+}
+#endif /* CONFIG_MEM_ALLOC_STATS */
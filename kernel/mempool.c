@@ -9,6 +9,7 @@
 #include <wait_q.h>
 #include <init.h>
 #include <string.h>
+#include <mem_alloc_stats.h>
 
 /* Linker-defined symbols bound the static pool structs */
 extern struct k_mem_pool _k_mem_pool_list_start[];
@@ -38,7 +39,8 @@ static int block_num(struct k_mem_pool *p, void *block, int sz)
 
 static bool level_empty(struct k_mem_pool *p, int l)
 {
-	return sys_dlist_is_empty(&p->levels[l].free_list);
+	return sys_dlist_is_empty(&p->levels[l].free_list) &&
+	       (l > 0 || p->n_carved == p->n_max);
 }
 
 /* Places a 32 bit output pointer in word, and an integer bit index
@@ -91,14 +93,17 @@ static bool block_fits(struct k_mem_pool *p, void *block, size_t bsz)
 	return (block + bsz - 1 - p->buf) < buf_size(p);
 }
 
+/*
+ * Only the level descriptors are set up at boot: the largest blocks are
+ * carved from the buffer as they are first allocated, rather than all put on
+ * the free list, thus the boot time does not depend on the pool size.
+ */
 static void init_mem_pool(struct k_mem_pool *p)
 {
 	int i;
 	size_t buflen = p->n_max * p->max_sz, sz = p->max_sz;
 	u32_t *bits = p->buf + buflen;
 
-	sys_dlist_init(&p->wait_q);
-
 	for (i = 0; i < p->n_levels; i++) {
 		int nblocks = buflen / sz;
 
@@ -113,13 +118,6 @@ static void init_mem_pool(struct k_mem_pool *p)
 
 		sz = _ALIGN4(sz / 4);
 	}
-
-	for (i = 0; i < p->n_max; i++) {
-		void *block = block_ptr(p, p->max_sz, i);
-
-		sys_dlist_append(&p->levels[0].free_list, block);
-		set_free_bit(p, 0, i);
-	}
 }
 
 int init_static_pools(struct device *unused)
@@ -157,6 +155,9 @@ static void *alloc_block(struct k_mem_pool *p, int l, size_t lsz)
 	block = sys_dlist_get(&p->levels[l].free_list);
 	if (block) {
 		clear_free_bit(p, l, block_num(p, block, lsz));
+	} else if (l == 0 && p->n_carved < p->n_max) {
+		/* never allocated so far, thus never marked free either */
+		block = block_ptr(p, lsz, p->n_carved++);
 	}
 	irq_unlock(key);
 
@@ -287,11 +288,53 @@ static int pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
 	return 0;
 }
 
+#if defined(CONFIG_MEM_ALLOC_STATS) || defined(CONFIG_HEAP_MEM_POOL_CACHE)
+static size_t level_size(struct k_mem_pool *p, int level)
+{
+	size_t lsz = _ALIGN4(p->max_sz);
+
+	while (level--) {
+		lsz = _ALIGN4(lsz / 4);
+	}
+
+	return lsz;
+}
+#endif
+
+#ifdef CONFIG_MEM_ALLOC_STATS
+/* account for an allocation attempt, which waited since 'wait_start' */
+static void alloc_stats(struct k_mem_pool *p, struct k_mem_block *block,
+			int ret, bool waited, u32_t wait_start)
+{
+	int key = irq_lock();
+
+	if (waited) {
+		_mem_stats_wait(&p->stats, wait_start);
+	}
+
+	if (ret == 0) {
+		_MEM_STATS_ALLOC(p, level_size(p, block->id.level));
+	} else {
+		_MEM_STATS_FAIL(p);
+	}
+
+	irq_unlock(key);
+}
+#else
+static inline void alloc_stats(struct k_mem_pool *p,
+			       struct k_mem_block *block,
+			       int ret, bool waited, u32_t wait_start)
+{
+}
+#endif
+
 int k_mem_pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
 		     size_t size, s32_t timeout)
 {
 	int ret, key;
 	s64_t end = 0;
+	bool waited = false;
+	u32_t wait_start = 0;
 
 	__ASSERT(!(_is_in_isr() && timeout != K_NO_WAIT), "");
 
@@ -304,9 +347,15 @@ int k_mem_pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
 
 		if (ret == 0 || timeout == K_NO_WAIT ||
 		    ret == -EAGAIN || (ret && ret != -ENOMEM)) {
+			alloc_stats(p, block, ret, waited, wait_start);
 			return ret;
 		}
 
+		if (IS_ENABLED(CONFIG_MEM_ALLOC_STATS) && !waited) {
+			waited = true;
+			wait_start = k_uptime_get_32();
+		}
+
 		key = irq_lock();
 		_pend_current_thread(&p->wait_q, timeout);
 		_Swap(key);
@@ -320,6 +369,7 @@ int k_mem_pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
 		}
 	}
 
+	alloc_stats(p, block, -EAGAIN, waited, wait_start);
 	return -EAGAIN;
 }
 
@@ -348,6 +398,8 @@ void k_mem_pool_free(struct k_mem_block *block)
 	 */
 	key = irq_lock();
 
+	_MEM_STATS_FREE(p, lsizes[block->id.level]);
+
 	while (!sys_dlist_is_empty(&p->wait_q)) {
 		struct k_thread *th = (void *)sys_dlist_peek_head(&p->wait_q);
 
@@ -364,6 +416,25 @@ void k_mem_pool_free(struct k_mem_block *block)
 	}
 }
 
+#ifdef CONFIG_MEM_ALLOC_STATS
+void k_mem_pool_stats_get(struct k_mem_pool *pool,
+			  struct k_mem_alloc_stats *stats)
+{
+	int key = irq_lock();
+
+	*stats = pool->stats;
+	irq_unlock(key);
+}
+
+void k_mem_pool_stats_reset(struct k_mem_pool *pool)
+{
+	int key = irq_lock();
+
+	_mem_stats_reset(&pool->stats);
+	irq_unlock(key);
+}
+#endif /* CONFIG_MEM_ALLOC_STATS */
+
 #if (CONFIG_HEAP_MEM_POOL_SIZE > 0)
 
 /*
@@ -376,6 +447,147 @@ void k_mem_pool_free(struct k_mem_block *block)
 K_MEM_POOL_DEFINE(_heap_mem_pool, 64, CONFIG_HEAP_MEM_POOL_SIZE, 1, 4);
 #define _HEAP_MEM_POOL (&_heap_mem_pool)
 
+#ifdef CONFIG_HEAP_MEM_POOL_CACHE
+
+/*
+ * Size class cache in front of the heap memory pool. Each class keeps its
+ * free blocks in a memory slab, which starts empty and is grown by carving
+ * whole heap memory pool blocks into blocks of the class; these are never
+ * given back to the pool.
+ *
+ * Cached blocks start with the same hidden descriptor as the ones allocated
+ * from the pool, with a NULL data pointer to tell them apart, the index of
+ * the class in the level field and the size requested in the block field.
+ */
+
+#define CACHE_MIN_BLOCK_SIZE 32
+#define CACHE_MAX_BLOCK_SIZE \
+	(CACHE_MIN_BLOCK_SIZE << (K_HEAP_CACHE_NUM_CLASSES - 1))
+
+struct heap_cache {
+	struct k_mem_slab slab;
+	atomic_t hits;
+	atomic_t refills;
+	atomic_t misses;
+	atomic_t bytes_requested;
+};
+
+#define HEAP_CACHE_INITIALIZER(i) \
+	{ \
+	.slab = K_MEM_SLAB_INITIALIZER(heap_cache[i].slab, NULL, \
+				       CACHE_MIN_BLOCK_SIZE << (i), 0), \
+	}
+
+static struct heap_cache heap_cache[K_HEAP_CACHE_NUM_CLASSES] = {
+	HEAP_CACHE_INITIALIZER(0),
+	HEAP_CACHE_INITIALIZER(1),
+	HEAP_CACHE_INITIALIZER(2),
+	HEAP_CACHE_INITIALIZER(3),
+	HEAP_CACHE_INITIALIZER(4),
+};
+
+/* carve a heap memory pool block into free blocks of a size class */
+static int cache_refill(struct heap_cache *c)
+{
+	struct k_mem_slab *slab = &c->slab;
+	struct k_mem_block block;
+	size_t size = max(CONFIG_HEAP_MEM_POOL_CACHE_REFILL_SIZE,
+			  slab->block_size);
+	size_t lsz;
+	char *p;
+	int key;
+
+	if (k_mem_pool_alloc(_HEAP_MEM_POOL, &block, size, K_NO_WAIT) != 0) {
+		return -ENOMEM;
+	}
+
+	/* the pool block may be larger than asked for: carve all of it */
+	lsz = level_size(_HEAP_MEM_POOL, block.id.level);
+
+	key = irq_lock();
+
+	/* the slab has no buffer to carve from: link all the blocks */
+	for (p = block.data; p + slab->block_size <= (char *)block.data + lsz;
+	     p += slab->block_size) {
+		*(char **)p = slab->free_list;
+		slab->free_list = p;
+		slab->num_blocks++;
+		slab->num_carved++;
+	}
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+static void *cache_alloc(size_t size)
+{
+	struct heap_cache *c = heap_cache;
+	struct k_mem_block *desc;
+	void *mem;
+
+	while (c->slab.block_size < size) {
+		c++;
+	}
+
+	if (k_mem_slab_alloc(&c->slab, &mem, K_NO_WAIT) == 0) {
+		atomic_inc(&c->hits);
+	} else if (cache_refill(c) == 0 &&
+		   k_mem_slab_alloc(&c->slab, &mem, K_NO_WAIT) == 0) {
+		atomic_inc(&c->refills);
+	} else {
+		atomic_inc(&c->misses);
+		return NULL;
+	}
+
+	atomic_add(&c->bytes_requested, size);
+
+	desc = mem;
+	desc->data = NULL;
+	desc->id.pool = 0;
+	desc->id.level = c - heap_cache;
+	desc->id.block = size;
+
+	return desc;
+}
+
+static void cache_free(struct k_mem_block *desc)
+{
+	struct heap_cache *c = &heap_cache[desc->id.level];
+
+	atomic_sub(&c->bytes_requested, desc->id.block);
+	k_mem_slab_free(&c->slab, (void **)&desc);
+}
+
+int k_heap_cache_stats_get(unsigned int class_idx,
+			   struct k_heap_cache_stats *stats)
+{
+	struct heap_cache *c;
+	int key;
+
+	if (class_idx >= K_HEAP_CACHE_NUM_CLASSES) {
+		return -EINVAL;
+	}
+
+	c = &heap_cache[class_idx];
+
+	key = irq_lock();
+
+	stats->block_size = c->slab.block_size;
+	stats->num_blocks = c->slab.num_blocks;
+	stats->num_used = c->slab.num_used;
+	stats->hits = atomic_get(&c->hits);
+	stats->refills = atomic_get(&c->refills);
+	stats->misses = atomic_get(&c->misses);
+	stats->bytes_requested = atomic_get(&c->bytes_requested);
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+#endif /* CONFIG_HEAP_MEM_POOL_CACHE */
+
 void *k_malloc(size_t size)
 {
 	struct k_mem_block block;
@@ -385,6 +597,19 @@ void *k_malloc(size_t size)
 	 * descriptor, as well as the space the caller requested
 	 */
 	size += sizeof(struct k_mem_block);
+
+#ifdef CONFIG_HEAP_MEM_POOL_CACHE
+	if (size <= CACHE_MAX_BLOCK_SIZE) {
+		void *mem = cache_alloc(size);
+
+		if (mem) {
+			return (char *)mem + sizeof(struct k_mem_block);
+		}
+
+		/* no pool block left to carve, a smaller one may still do */
+	}
+#endif
+
 	if (k_mem_pool_alloc(_HEAP_MEM_POOL, &block, size, K_NO_WAIT) != 0) {
 		return NULL;
 	}
@@ -403,6 +628,13 @@ void k_free(void *ptr)
 		/* point to hidden block descriptor at start of block */
 		ptr = (char *)ptr - sizeof(struct k_mem_block);
 
+#ifdef CONFIG_HEAP_MEM_POOL_CACHE
+		if (((struct k_mem_block *)ptr)->data == NULL) {
+			cache_free(ptr);
+			return;
+		}
+#endif
+
 		/* return block to the heap memory pool */
 		k_mem_pool_free(ptr);
 	}
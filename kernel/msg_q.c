@@ -19,6 +19,7 @@
 #include <wait_q.h>
 #include <misc/dlist.h>
 #include <init.h>
+#include <misc/util.h>
 
 extern struct k_msgq _k_msgq_list_start[];
 extern struct k_msgq _k_msgq_list_end[];
@@ -162,6 +163,170 @@ int k_msgq_get(struct k_msgq *q, void *data, s32_t timeout)
 	return result;
 }
 
+/*
+ * Copy messages into the ring buffer, which must have room for them, in at
+ * most two chunks: up to the end of the buffer, then from its start.
+ */
+static void ring_write(struct k_msgq *q, char *src, u32_t num_msgs)
+{
+	size_t len = num_msgs * q->msg_size;
+	size_t chunk = min(len, (size_t)(q->buffer_end - q->write_ptr));
+
+	memcpy(q->write_ptr, src, chunk);
+	memcpy(q->buffer_start, src + chunk, len - chunk);
+
+	q->write_ptr += chunk;
+	if (q->write_ptr == q->buffer_end) {
+		q->write_ptr = q->buffer_start + (len - chunk);
+	}
+	q->used_msgs += num_msgs;
+}
+
+/* copy queued messages out of the ring buffer, in at most two chunks */
+static void ring_read(struct k_msgq *q, char *dst, u32_t num_msgs)
+{
+	size_t len = num_msgs * q->msg_size;
+	size_t chunk = min(len, (size_t)(q->buffer_end - q->read_ptr));
+
+	memcpy(dst, q->read_ptr, chunk);
+	memcpy(dst + chunk, q->buffer_start, len - chunk);
+
+	q->read_ptr += chunk;
+	if (q->read_ptr == q->buffer_end) {
+		q->read_ptr = q->buffer_start + (len - chunk);
+	}
+	q->used_msgs -= num_msgs;
+}
+
+int k_msgq_put_n(struct k_msgq *q, void *data, u32_t num_msgs,
+		 s32_t timeout)
+{
+	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	unsigned int key = irq_lock();
+	struct k_thread *pending_thread;
+	char *src = data;
+	u32_t count = 0;
+	int woken = 0;
+	int result;
+
+	if (num_msgs == 0) {
+		irq_unlock(key);
+		return 0;
+	}
+
+	/*
+	 * Threads can only be waiting to receive while the queue is empty:
+	 * hand them the first messages directly, then queue the rest.
+	 */
+	if (q->used_msgs < q->max_msgs) {
+		while (count < num_msgs) {
+			pending_thread = _unpend_first_thread(&q->wait_q);
+			if (!pending_thread) {
+				break;
+			}
+
+			memcpy(pending_thread->base.swap_data, src,
+			       q->msg_size);
+			_set_thread_return_value(pending_thread, 0);
+			_abort_thread_timeout(pending_thread);
+			_ready_thread(pending_thread);
+
+			src += q->msg_size;
+			count++;
+			woken = 1;
+		}
+	}
+
+	if (count < num_msgs && q->used_msgs < q->max_msgs) {
+		u32_t n = min(num_msgs - count, q->max_msgs - q->used_msgs);
+
+		ring_write(q, src, n);
+		count += n;
+	}
+
+	if (count > 0) {
+		/* reschedule once for all the threads woken up */
+		if (woken && !_is_in_isr() && _must_switch_threads()) {
+			_Swap(key);
+			return count;
+		}
+		irq_unlock(key);
+		return count;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		/* don't wait for message space to become available */
+		irq_unlock(key);
+		return -ENOMSG;
+	}
+
+	/* wait for the first message to be sent, like k_msgq_put() */
+	_pend_current_thread(&q->wait_q, timeout);
+	_current->base.swap_data = data;
+	result = _Swap(key);
+
+	return result == 0 ? 1 : result;
+}
+
+int k_msgq_get_n(struct k_msgq *q, void *data, u32_t num_msgs,
+		 s32_t timeout)
+{
+	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	unsigned int key = irq_lock();
+	struct k_thread *pending_thread;
+	char *dst = data;
+	u32_t count = 0;
+	int woken = 0;
+	int result;
+
+	while (count < num_msgs && q->used_msgs > 0) {
+		u32_t n = min(num_msgs - count, q->used_msgs);
+
+		ring_read(q, dst, n);
+		dst += n * q->msg_size;
+		count += n;
+
+		/* refill the freed space from threads waiting to send */
+		while (q->used_msgs < q->max_msgs) {
+			pending_thread = _unpend_first_thread(&q->wait_q);
+			if (!pending_thread) {
+				break;
+			}
+
+			ring_write(q, pending_thread->base.swap_data, 1);
+			_set_thread_return_value(pending_thread, 0);
+			_abort_thread_timeout(pending_thread);
+			_ready_thread(pending_thread);
+			woken = 1;
+		}
+	}
+
+	if (count > 0 || num_msgs == 0) {
+		/* reschedule once for all the threads woken up */
+		if (woken && !_is_in_isr() && _must_switch_threads()) {
+			_Swap(key);
+			return count;
+		}
+		irq_unlock(key);
+		return count;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		/* don't wait for a message to become available */
+		irq_unlock(key);
+		return -ENOMSG;
+	}
+
+	/* wait for the first message to be received, like k_msgq_get() */
+	_pend_current_thread(&q->wait_q, timeout);
+	_current->base.swap_data = data;
+	result = _Swap(key);
+
+	return result == 0 ? 1 : result;
+}
+
 void k_msgq_purge(struct k_msgq *q)
 {
 	unsigned int key = irq_lock();
@@ -11,7 +11,15 @@
  *
  * Mutexes implement a priority inheritance algorithm that boosts the priority
  * level of the owning thread to match the priority level of the highest
- * priority thread waiting on the mutex.
+ * priority thread waiting on the mutex. The inheritance is transitive: if the
+ * owner is itself waiting on another mutex, the owner of that mutex inherits
+ * the priority too, and so on, up to CONFIG_MUTEX_INHERITANCE_DEPTH mutexes.
+ * Each thread records the mutex it is pending on for that purpose, and the
+ * threads waiting along the chain are moved to their new place in the
+ * priority-ordered wait queues.
+ *
+ * With CONFIG_MUTEX_PRIORITY_CEILING, a mutex can also be given a priority
+ * ceiling, which its owner runs at as soon as it locks it.
  *
  * Each mutex that contributes to priority inheritance must be released in the
  * reverse order in which is was acquired.  Furthermore each subsequent mutex
@@ -35,6 +43,7 @@
 #include <debug/object_tracing_common.h>
 #include <errno.h>
 #include <init.h>
+#include <string.h>
 
 #define RECORD_STATE_CHANGE(mutex) do { } while ((0))
 #define RECORD_CONFLICT(mutex) do { } while ((0))
@@ -74,20 +83,88 @@ void k_mutex_init(struct k_mutex *mutex)
 	/* initialized upon first use */
 	/* mutex->owner_orig_prio = 0; */
 
+#ifdef CONFIG_MUTEX_PRIORITY_CEILING
+	mutex->ceiling = K_LOWEST_THREAD_PRIO;
+#endif
+#ifdef CONFIG_MUTEX_STATS
+	memset(&mutex->stats, 0, sizeof(mutex->stats));
+#endif
+
 	sys_dlist_init(&mutex->wait_q);
 
 	SYS_TRACING_OBJ_INIT(k_mutex, mutex);
 }
 
-static int new_prio_for_inheritance(int target, int limit)
+#ifdef CONFIG_MUTEX_PRIORITY_CEILING
+void k_mutex_ceiling_set(struct k_mutex *mutex, int prio)
+{
+	__ASSERT(mutex->lock_count == 0, "");
+
+	mutex->ceiling = prio;
+}
+
+static inline int ceiling_prio(struct k_mutex *mutex, int prio)
+{
+	return _is_prio_higher(mutex->ceiling, prio) ? mutex->ceiling : prio;
+}
+#else
+#define ceiling_prio(mutex, prio) (prio)
+#endif
+
+#ifdef CONFIG_MUTEX_STATS
+static inline void stats_locked(struct k_mutex *mutex)
 {
-	int new_prio = _is_prio_higher(target, limit) ? target : limit;
+	mutex->stats.num_locks++;
+	mutex->locked_at = k_cycle_get_32();
+}
 
-	new_prio = _get_new_prio_with_ceiling(new_prio);
+static inline void stats_unlocked(struct k_mutex *mutex)
+{
+	u32_t hold_time = k_cycle_get_32() - mutex->locked_at;
 
-	return new_prio;
+	if (hold_time > mutex->stats.max_hold_time) {
+		mutex->stats.max_hold_time = hold_time;
+	}
 }
 
+static inline void stats_waited(struct k_mutex *mutex, u32_t start)
+{
+	u32_t wait_time = k_cycle_get_32() - start;
+
+	if (wait_time > mutex->stats.max_wait_time) {
+		mutex->stats.max_wait_time = wait_time;
+	}
+}
+
+void k_mutex_stats_get(struct k_mutex *mutex, struct k_mutex_stats *stats)
+{
+	int key = irq_lock();
+
+	*stats = mutex->stats;
+	irq_unlock(key);
+}
+
+void k_mutex_stats_reset(struct k_mutex *mutex)
+{
+	int key = irq_lock();
+
+	memset(&mutex->stats, 0, sizeof(mutex->stats));
+	irq_unlock(key);
+}
+
+#define RECORD_LOCK(mutex) stats_locked(mutex)
+#define RECORD_UNLOCK(mutex) stats_unlocked(mutex)
+#define RECORD_CONTENTION(mutex) (mutex)->stats.num_contended++
+#define RECORD_WAIT(mutex, start) stats_waited(mutex, start)
+#define WAIT_START() k_cycle_get_32()
+#else
+#define RECORD_LOCK(mutex) do { } while ((0))
+#define RECORD_UNLOCK(mutex) do { } while ((0))
+#define RECORD_CONTENTION(mutex) do { } while ((0))
+#define RECORD_WAIT(mutex, start) ((void)(start))
+#define WAIT_START() 0
+#endif /* CONFIG_MUTEX_STATS */
+
 static void adjust_owner_prio(struct k_mutex *mutex, int new_prio)
 {
 	if (mutex->owner->base.prio != new_prio) {
@@ -101,9 +178,67 @@ static void adjust_owner_prio(struct k_mutex *mutex, int new_prio)
 	}
 }
 
+/*
+ * Priority the owner of a mutex must run at: its priority when it locked the
+ * mutex, raised to the ceiling of the mutex and to the priority of the first
+ * thread waiting on the mutex, within the inheritance ceiling.
+ */
+static int owner_prio(struct k_mutex *mutex)
+{
+	struct k_thread *waiter = _peek_first_pending_thread(&mutex->wait_q);
+	int prio = ceiling_prio(mutex, mutex->owner_orig_prio);
+
+	if (waiter) {
+		int inherited = _get_new_prio_with_ceiling(waiter->base.prio);
+
+		if (_is_prio_higher(inherited, prio)) {
+			prio = inherited;
+		}
+	}
+
+	return prio;
+}
+
+/*
+ * Follow the chain of owners, starting from the owner of 'mutex', as long as
+ * they are pending on a mutex themselves, and set their priority to what
+ * their mutex requires. Raising priorities stops at the first owner already
+ * running at a higher priority; lowering them stops at the first owner which
+ * priority does not change.
+ */
+/* must be called with interrupts locked */
+static void propagate_prio(struct k_mutex *mutex, int raise)
+{
+	struct k_thread *owner;
+	int depth, prio;
+
+	for (depth = 0; depth < CONFIG_MUTEX_INHERITANCE_DEPTH; depth++) {
+		owner = mutex->owner;
+		if (!owner) {
+			return;
+		}
+
+		prio = owner_prio(mutex);
+		if (raise ? !_is_prio_higher(prio, owner->base.prio) :
+			    prio == owner->base.prio) {
+			return;
+		}
+
+		adjust_owner_prio(mutex, prio);
+
+		mutex = owner->base.pended_on_mutex;
+		if (!mutex || !_is_thread_pending(owner)) {
+			return;
+		}
+
+		_reorder_pending_thread(owner, &mutex->wait_q);
+	}
+}
+
 int k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 {
-	int new_prio, key;
+	int key;
+	u32_t wait_start;
 
 	_sched_lock();
 
@@ -111,13 +246,22 @@ int k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 
 		RECORD_STATE_CHANGE();
 
-		mutex->owner_orig_prio = mutex->lock_count == 0 ?
-					_current->base.prio :
-					mutex->owner_orig_prio;
+		if (mutex->lock_count == 0) {
+			mutex->owner_orig_prio = _current->base.prio;
+			RECORD_LOCK(mutex);
+		}
 
 		mutex->lock_count++;
 		mutex->owner = _current;
 
+#ifdef CONFIG_MUTEX_PRIORITY_CEILING
+		if (_is_prio_higher(mutex->ceiling, _current->base.prio)) {
+			key = irq_lock();
+			adjust_owner_prio(mutex, mutex->ceiling);
+			irq_unlock(key);
+		}
+#endif
+
 		K_DEBUG("%p took mutex %p, count: %d, orig prio: %d\n",
 			_current, mutex, mutex->lock_count,
 			mutex->owner_orig_prio);
@@ -128,33 +272,30 @@ int k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 	}
 
 	RECORD_CONFLICT();
+	RECORD_CONTENTION(mutex);
 
 	if (unlikely(timeout == K_NO_WAIT)) {
 		k_sched_unlock();
 		return -EBUSY;
 	}
 
-#if 0
-	if (_is_prio_higher(_current->prio, mutex->owner->prio)) {
-		new_prio = _current->prio;
-	}
-	new_prio = _get_new_prio_with_ceiling(new_prio);
-#endif
-	new_prio = new_prio_for_inheritance(_current->base.prio,
-					    mutex->owner->base.prio);
+	wait_start = WAIT_START();
 
 	key = irq_lock();
 
 	K_DEBUG("adjusting prio up on mutex %p\n", mutex);
 
-	if (_is_prio_higher(new_prio, mutex->owner->base.prio)) {
-		adjust_owner_prio(mutex, new_prio);
-	}
-
 	_pend_current_thread(&mutex->wait_q, timeout);
+	_current->base.pended_on_mutex = mutex;
+
+	propagate_prio(mutex, 1);
 
 	int got_mutex = _Swap(key);
 
+	_current->base.pended_on_mutex = NULL;
+
+	RECORD_WAIT(mutex, wait_start);
+
 	K_DEBUG("on mutex %p got_mutex value: %d\n", mutex, got_mutex);
 
 	K_DEBUG("%p got mutex %p (y/n): %c\n", _current, mutex,
@@ -169,17 +310,10 @@ int k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 
 	K_DEBUG("%p timeout on mutex %p\n", _current, mutex);
 
-	struct k_thread *waiter =
-		(struct k_thread *)sys_dlist_peek_head(&mutex->wait_q);
-
-	new_prio = mutex->owner_orig_prio;
-	new_prio = waiter ? new_prio_for_inheritance(waiter->base.prio,
-						     new_prio) : new_prio;
-
 	K_DEBUG("adjusting prio down on mutex %p\n", mutex);
 
 	key = irq_lock();
-	adjust_owner_prio(mutex, new_prio);
+	propagate_prio(mutex, 0);
 	irq_unlock(key);
 
 	k_sched_unlock();
@@ -207,6 +341,8 @@ void k_mutex_unlock(struct k_mutex *mutex)
 		return;
 	}
 
+	RECORD_UNLOCK(mutex);
+
 	key = irq_lock();
 
 	adjust_owner_prio(mutex, mutex->owner_orig_prio);
@@ -220,21 +356,24 @@ void k_mutex_unlock(struct k_mutex *mutex)
 		_abort_thread_timeout(new_owner);
 		_ready_thread(new_owner);
 
-		irq_unlock(key);
-
 		_set_thread_return_value(new_owner, 0);
 
 		/*
 		 * new owner is already of higher or equal prio than first
-		 * waiter since the wait queue is priority-based: no need to
-		 * ajust its priority
+		 * waiter since the wait queue is priority-based: it only has
+		 * to be raised to the ceiling of the mutex, if any
 		 */
 		mutex->owner = new_owner;
 		mutex->lock_count++;
 		mutex->owner_orig_prio = new_owner->base.prio;
-	} else {
+		adjust_owner_prio(mutex, ceiling_prio(mutex,
+						      new_owner->base.prio));
+		RECORD_LOCK(mutex);
+
 		irq_unlock(key);
+	} else {
 		mutex->owner = NULL;
+		irq_unlock(key);
 	}
 
 	k_sched_unlock();
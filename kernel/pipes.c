@@ -18,6 +18,7 @@
 #include <wait_q.h>
 #include <misc/dlist.h>
 #include <init.h>
+#include <string.h>
 
 struct k_pipe_desc {
 	unsigned char *buffer;           /* Position in src/dest buffer */
@@ -26,14 +27,40 @@ struct k_pipe_desc {
 	struct k_mem_block *block;       /* Pointer to memory block */
 	struct k_mem_block  copy_block;  /* For backwards compatibility */
 	struct k_sem *sem;               /* Semaphore to give if async */
+	size_t block_max;                /* Block reader: max block size */
+	struct k_mem_pool *pool;         /* Block reader: pool of the block */
 #endif
 };
 
+/*
+ * A block reader, waiting in k_pipe_block_get(), pends with a descriptor
+ * asking for zero bytes, and is readied by the first writer: it can take up
+ * to block_max bytes, in a single block. A writer handing it a memory block,
+ * either its own or one allocated from the reader's pool, sets the
+ * descriptor's buffer to the block's data and bytes_to_xfer to the number of
+ * bytes in it. Otherwise, if no block could be allocated, the reader gets the
+ * data from the pipe itself.
+ *
+ * The block is allocated while the transfer is prepared, before any data is
+ * copied, so that the reader only counts for the bytes it can actually take.
+ * If the transfer does not take place after all, the reader keeps the block
+ * while pending, with bytes_to_xfer holding its size.
+ */
+#if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
+#define _PIPE_DESC_INIT(desc) ((desc)->block_max = 0)
+#define _PIPE_DESC_IS_BLOCK_READER(desc) ((desc)->block_max != 0)
+#else
+#define _PIPE_DESC_INIT(desc) do { } while ((0))
+#define _PIPE_DESC_IS_BLOCK_READER(desc) (false)
+#endif
+
 struct k_pipe_async {
 	struct _thread_base thread;   /* Dummy thread object */
 	struct k_pipe_desc  desc;     /* Pipe message descriptor */
 };
 
+s64_t _tick_get(void);
+
 extern struct k_pipe _k_pipe_list_start[];
 extern struct k_pipe _k_pipe_list_end[];
 
@@ -46,12 +73,36 @@ struct k_pipe *_trace_list_k_pipe;
 /* Array of asynchronous message descriptors */
 static struct k_pipe_async __noinit async_msg[CONFIG_NUM_PIPE_ASYNC_MSGS];
 
-/* stack of unused asynchronous message descriptors */
+/* stack of freed asynchronous message descriptors */
 K_STACK_DEFINE(pipe_async_msgs, CONFIG_NUM_PIPE_ASYNC_MSGS);
 
-/* Allocate an asynchronous message descriptor */
+/* number of descriptors ever allocated, the others are not on the stack */
+static int async_msg_carved;
+
+/*
+ * Allocate an asynchronous message descriptor. The descriptors never used so
+ * far are taken first, and set up then rather than at boot.
+ *
+ * A dummy thread requires minimal initialization, since it never gets to
+ * execute. The _THREAD_DUMMY flag is sufficient to distinguish a dummy
+ * thread from a real one. The threads are *not* added to the kernel's list
+ * of known threads.
+ */
 static void _pipe_async_alloc(struct k_pipe_async **async)
 {
+	unsigned int key = irq_lock();
+
+	if (async_msg_carved < CONFIG_NUM_PIPE_ASYNC_MSGS) {
+		*async = &async_msg[async_msg_carved++];
+		irq_unlock(key);
+
+		(*async)->thread.thread_state = _THREAD_DUMMY;
+		(*async)->thread.swap_data = &(*async)->desc;
+		return;
+	}
+
+	irq_unlock(key);
+
 	k_stack_pop(&pipe_async_msgs, (u32_t *)async, K_FOREVER);
 }
 
@@ -69,7 +120,10 @@ static void _pipe_async_finish(struct k_pipe_async *async_desc)
 	 * to prevent the called routines from scheduling a new thread.
 	 */
 
-	k_mem_pool_free(async_desc->desc.block);
+	/* the block is NULL if it was handed to a reader */
+	if (async_desc->desc.block != NULL) {
+		k_mem_pool_free(async_desc->desc.block);
+	}
 
 	if (async_desc->desc.sem != NULL) {
 		k_sem_give(async_desc->desc.sem);
@@ -79,52 +133,27 @@ static void _pipe_async_finish(struct k_pipe_async *async_desc)
 }
 #endif /* CONFIG_NUM_PIPE_ASYNC_MSGS > 0 */
 
-#if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0) || \
-	defined(CONFIG_OBJECT_TRACING)
+#ifdef CONFIG_OBJECT_TRACING
 
 /*
- * Do run-time initialization of pipe object subsystem.
+ * Complete initialization of statically defined pipes.
  */
 static int init_pipes_module(struct device *dev)
 {
 	ARG_UNUSED(dev);
 
-#if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
-	/*
-	 * Create pool of asynchronous pipe message descriptors.
-	 *
-	 * A dummy thread requires minimal initialization, since it never gets
-	 * to execute. The _THREAD_DUMMY flag is sufficient to distinguish a
-	 * dummy thread from a real one. The threads are *not* added to the
-	 * kernel's list of known threads.
-	 *
-	 * Once initialized, the address of each descriptor is added to a stack
-	 * that governs access to them.
-	 */
-
-	for (int i = 0; i < CONFIG_NUM_PIPE_ASYNC_MSGS; i++) {
-		async_msg[i].thread.thread_state = _THREAD_DUMMY;
-		async_msg[i].thread.swap_data = &async_msg[i].desc;
-		k_stack_push(&pipe_async_msgs, (u32_t)&async_msg[i]);
-	}
-#endif /* CONFIG_NUM_PIPE_ASYNC_MSGS > 0 */
-
-	/* Complete initialization of statically defined mailboxes. */
-
-#ifdef CONFIG_OBJECT_TRACING
 	struct k_pipe *pipe;
 
 	for (pipe = _k_pipe_list_start; pipe < _k_pipe_list_end; pipe++) {
 		SYS_TRACING_OBJ_INIT(k_pipe, pipe);
 	}
-#endif /* CONFIG_OBJECT_TRACING */
 
 	return 0;
 }
 
 SYS_INIT(init_pipes_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 
-#endif /* CONFIG_NUM_PIPE_ASYNC_MSGS or CONFIG_OBJECT_TRACING */
+#endif /* CONFIG_OBJECT_TRACING */
 
 void k_pipe_init(struct k_pipe *pipe, unsigned char *buffer, size_t size)
 {
@@ -147,17 +176,57 @@ static size_t _pipe_xfer(unsigned char *dest, size_t dest_size,
 			 const unsigned char *src, size_t src_size)
 {
 	size_t num_bytes = min(dest_size, src_size);
-	const unsigned char *end = src + num_bytes;
 
-	while (src != end) {
-		*dest = *src;
-		dest++;
-		src++;
-	}
+	memcpy(dest, src, num_bytes);
 
 	return num_bytes;
 }
 
+#if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
+/**
+ * @brief Allocate the memory block of a block reader, if not done yet
+ *
+ * Called with interrupts locked, the block is sized for at most @a num_bytes.
+ *
+ * @return Size of the reader's block, 0 if no block could be allocated
+ */
+static size_t _pipe_block_alloc(struct k_pipe_desc *desc, size_t num_bytes)
+{
+	if (desc->buffer == NULL) {
+		num_bytes = min(desc->block_max, num_bytes);
+
+		if (num_bytes == 0 ||
+		    k_mem_pool_alloc(desc->pool, desc->block, num_bytes,
+				     K_NO_WAIT) != 0) {
+			return 0;
+		}
+
+		desc->buffer = desc->block->data;
+		desc->bytes_to_xfer = num_bytes;
+	}
+
+	return desc->bytes_to_xfer;
+}
+#else
+#define _pipe_block_alloc(desc, num_bytes) (0)
+#endif
+
+/**
+ * @brief Number of bytes a waiting thread can transfer out of @a num_bytes
+ *
+ * A block reader takes up to the size of its block, in one go: the block is
+ * allocated here, so that the reader is not counted for more than it can take.
+ */
+static inline size_t _pipe_desc_bytes(struct k_pipe_desc *desc,
+				      size_t num_bytes)
+{
+	if (_PIPE_DESC_IS_BLOCK_READER(desc)) {
+		return min(_pipe_block_alloc(desc, num_bytes), num_bytes);
+	}
+
+	return desc->bytes_to_xfer;
+}
+
 /**
  * @brief Put data from @a src into the pipe's circular buffer
  *
@@ -280,7 +349,8 @@ static bool _pipe_xfer_prepare(sys_dlist_t      *xfer_list,
 			thread = (struct k_thread *)node;
 			desc = (struct k_pipe_desc *)thread->base.swap_data;
 
-			num_bytes += desc->bytes_to_xfer;
+			num_bytes += _pipe_desc_bytes(desc,
+						      bytes_to_xfer - num_bytes);
 
 			if (num_bytes >= bytes_to_xfer) {
 				break;
@@ -302,7 +372,22 @@ static bool _pipe_xfer_prepare(sys_dlist_t      *xfer_list,
 
 	while ((thread = (struct k_thread *) sys_dlist_peek_head(wait_q))) {
 		desc = (struct k_pipe_desc *)thread->base.swap_data;
-		num_bytes += desc->bytes_to_xfer;
+
+		if (_PIPE_DESC_IS_BLOCK_READER(desc)) {
+			/*
+			 * A block reader takes whatever is left, as long as
+			 * something is. Without a block, it is readied to get
+			 * the data from the pipe.
+			 */
+			if (num_bytes >= bytes_to_xfer) {
+				break;
+			}
+
+			num_bytes += _pipe_desc_bytes(desc,
+						      bytes_to_xfer - num_bytes);
+		} else {
+			num_bytes += desc->bytes_to_xfer;
+		}
 
 		if (num_bytes > bytes_to_xfer) {
 			/*
@@ -433,13 +518,28 @@ int _k_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 				  sys_dlist_get(&xfer_list);
 	while (thread) {
 		desc = (struct k_pipe_desc *)thread->base.swap_data;
-		bytes_copied = _pipe_xfer(desc->buffer, desc->bytes_to_xfer,
-					  data + num_bytes_written,
-					  bytes_to_write - num_bytes_written);
 
-		num_bytes_written   += bytes_copied;
-		desc->buffer        += bytes_copied;
-		desc->bytes_to_xfer -= bytes_copied;
+		if (_PIPE_DESC_IS_BLOCK_READER(desc)) {
+			/* the block was allocated by _pipe_xfer_prepare() */
+			bytes_copied = 0;
+			if (desc->buffer != NULL) {
+				bytes_copied = _pipe_xfer(desc->buffer,
+					desc->bytes_to_xfer,
+					data + num_bytes_written,
+					bytes_to_write - num_bytes_written);
+				desc->bytes_to_xfer = bytes_copied;
+			}
+		} else {
+			bytes_copied = _pipe_xfer(desc->buffer,
+					desc->bytes_to_xfer,
+					data + num_bytes_written,
+					bytes_to_write - num_bytes_written);
+
+			desc->buffer        += bytes_copied;
+			desc->bytes_to_xfer -= bytes_copied;
+		}
+
+		num_bytes_written += bytes_copied;
 
 		/* The thread's read request has been satisfied. Ready it. */
 		key = irq_lock();
@@ -488,6 +588,10 @@ int _k_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 	if (async_desc != NULL) {
+		async_desc->desc.buffer = data + num_bytes_written;
+		async_desc->desc.bytes_to_xfer =
+			bytes_to_write - num_bytes_written;
+
 		/*
 		 * Lock interrupts and unlock the scheduler before
 		 * manipulating the writers wait_q.
@@ -505,6 +609,7 @@ int _k_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 
 	pipe_desc.buffer         = data + num_bytes_written;
 	pipe_desc.bytes_to_xfer  = bytes_to_write - num_bytes_written;
+	_PIPE_DESC_INIT(&pipe_desc);
 
 	if (timeout != K_NO_WAIT) {
 		_current->base.swap_data = &pipe_desc;
@@ -652,6 +757,7 @@ int k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	pipe_desc.buffer        = data + num_bytes_read;
 	pipe_desc.bytes_to_xfer = bytes_to_read - num_bytes_read;
+	_PIPE_DESC_INIT(&pipe_desc);
 
 	if (timeout != K_NO_WAIT) {
 		_current->base.swap_data = &pipe_desc;
@@ -681,12 +787,66 @@ int k_pipe_put(struct k_pipe *pipe, void *data, size_t bytes_to_write,
 }
 
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
+/**
+ * @brief Hand a memory block to a block reader waiting on the pipe
+ *
+ * @return true if the block was handed over, otherwise false
+ */
+static bool _pipe_block_handoff(struct k_pipe *pipe, struct k_mem_block *block,
+				size_t bytes_to_write, struct k_sem *sem)
+{
+	struct k_thread    *reader;
+	struct k_pipe_desc *desc;
+	unsigned int        key;
+
+	key = irq_lock();
+
+	/* a waiting reader means the pipe's buffer is empty */
+	reader = _peek_first_pending_thread(&pipe->wait_q.readers);
+	if (reader == NULL) {
+		irq_unlock(key);
+		return false;
+	}
+
+	/* the reader may already have a block of its own, see above */
+	desc = (struct k_pipe_desc *)reader->base.swap_data;
+	if (!_PIPE_DESC_IS_BLOCK_READER(desc) || desc->buffer != NULL ||
+	    desc->block_max < bytes_to_write) {
+		irq_unlock(key);
+		return false;
+	}
+
+	_unpend_thread(reader);
+	_abort_thread_timeout(reader);
+
+	*desc->block = *block;
+	desc->buffer = block->data;
+	desc->bytes_to_xfer = bytes_to_write;
+
+	_ready_thread(reader);
+
+	_sched_lock();
+	irq_unlock(key);
+
+	if (sem != NULL) {
+		k_sem_give(sem);
+	}
+
+	k_sched_unlock();
+
+	return true;
+}
+
 void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 		      size_t bytes_to_write, struct k_sem *sem)
 {
 	struct k_pipe_async  *async_desc;
 	size_t                dummy_bytes_written;
 
+	if (_pipe_block_handoff(pipe, block, bytes_to_write, sem)) {
+		return;
+	}
+
 	/* For simplicity, always allocate an asynchronous descriptor */
 	_pipe_async_alloc(&async_desc);
 
@@ -699,4 +859,138 @@ void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 				    bytes_to_write, &dummy_bytes_written,
 				    bytes_to_write, K_FOREVER);
 }
-#endif
+
+/**
+ * @brief Take the memory block of the first writer waiting on the pipe
+ *
+ * The block can only be taken if it is the next data to read, untouched, and
+ * fits in @a max_bytes. Called with interrupts locked, which are unlocked if
+ * the block is taken.
+ *
+ * @return true if the block was taken, otherwise false
+ */
+static bool _pipe_block_take(struct k_pipe *pipe, struct k_mem_block *block,
+			     size_t max_bytes, size_t *bytes_read,
+			     unsigned int key)
+{
+	struct k_thread    *writer;
+	struct k_pipe_desc *desc;
+
+	writer = _peek_first_pending_thread(&pipe->wait_q.writers);
+	if (writer == NULL || pipe->bytes_used != 0 ||
+	    !(writer->base.thread_state & _THREAD_DUMMY)) {
+		return false;
+	}
+
+	desc = (struct k_pipe_desc *)writer->base.swap_data;
+	if (desc->buffer != desc->copy_block.data ||
+	    desc->bytes_to_xfer > max_bytes) {
+		return false;
+	}
+
+	_unpend_thread(writer);
+
+	/* the block now belongs to the reader */
+	*block = desc->copy_block;
+	*bytes_read = desc->bytes_to_xfer;
+	desc->block = NULL;
+
+	_sched_lock();
+	irq_unlock(key);
+
+	_pipe_async_finish((struct k_pipe_async *)writer);
+
+	k_sched_unlock();
+
+	return true;
+}
+
+int k_pipe_block_get(struct k_pipe *pipe, struct k_mem_pool *pool,
+		     struct k_mem_block *block, size_t max_bytes,
+		     size_t *bytes_read, s32_t timeout)
+{
+	struct k_pipe_desc pipe_desc;
+	unsigned int       key;
+	s64_t              end = 0;
+	int                ret;
+	int                ret_empty = -EIO;
+
+	__ASSERT(max_bytes > 0, "");
+	__ASSERT(bytes_read != NULL, "");
+
+	if (timeout > 0) {
+		end = _tick_get() + _ms_to_ticks(timeout);
+	}
+
+	while (1) {
+		key = irq_lock();
+
+		if (_pipe_block_take(pipe, block, max_bytes, bytes_read, key)) {
+			return 0;
+		}
+
+		if (pipe->bytes_used != 0 ||
+		    !sys_dlist_is_empty(&pipe->wait_q.writers)) {
+			irq_unlock(key);
+
+			/* no block to take over: copy the data to a new one */
+			if (k_mem_pool_alloc(pool, block, max_bytes,
+					     K_NO_WAIT) != 0) {
+				*bytes_read = 0;
+				return -ENOMEM;
+			}
+
+			ret = k_pipe_get(pipe, block->data, max_bytes,
+					 bytes_read, 1, K_NO_WAIT);
+			if (ret == 0) {
+				return 0;
+			}
+
+			/* another reader got the data first: try again */
+			k_mem_pool_free(block);
+			continue;
+		}
+
+		if (timeout == K_NO_WAIT) {
+			irq_unlock(key);
+			*bytes_read = 0;
+			return ret_empty;
+		}
+
+		pipe_desc.buffer = NULL;
+		pipe_desc.bytes_to_xfer = 0;
+		pipe_desc.block = block;
+		pipe_desc.block_max = max_bytes;
+		pipe_desc.pool = pool;
+
+		_current->base.swap_data = &pipe_desc;
+		_pend_current_thread(&pipe->wait_q.readers, timeout);
+
+		if (_Swap(key) != 0) {
+			/* drop the block of a transfer that did not happen */
+			if (pipe_desc.buffer != NULL) {
+				k_mem_pool_free(block);
+			}
+
+			*bytes_read = 0;
+			return -EAGAIN;
+		}
+
+		if (pipe_desc.buffer != NULL) {
+			/* a writer handed its block over */
+			*bytes_read = pipe_desc.bytes_to_xfer;
+			return 0;
+		}
+
+		/* readied by a writer: the data is in the pipe, if still */
+		ret_empty = -EAGAIN;
+		if (timeout != K_FOREVER) {
+			timeout = __ticks_to_ms(end - _tick_get());
+
+			if (timeout <= 0) {
+				timeout = K_NO_WAIT;
+			}
+		}
+	}
+}
+#endif /* CONFIG_NUM_PIPE_ASYNC_MSGS > 0 */
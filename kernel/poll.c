@@ -12,6 +12,11 @@
  * This polling mechanism allows waiting on multiple events concurrently,
  * either events triggered directly, or from kernel objects or other kernel
  * constructs.
+ *
+ * Events can also be gathered in a poll set, where they stay registered on
+ * their objects across waits: signaling such an event queues it in the ready
+ * list of its set instead of clearing the registration, so that waiting on a
+ * set only costs in proportion to the events that are ready.
  */
 
 #include <kernel.h>
@@ -35,6 +40,7 @@ void k_poll_event_init(struct k_poll_event *event, u32_t type,
 	event->type = type;
 	event->state = K_POLL_STATE_NOT_READY;
 	event->mode = mode;
+	event->queued = 0;
 	event->unused = 0;
 	event->obj = obj;
 }
@@ -305,6 +311,45 @@ ready_event:
 	return 0;
 }
 
+/* must be called with interrupts locked */
+static inline int is_in_set(struct k_poll_event *event)
+{
+	return event->poller && event->poller->set;
+}
+
+/*
+ * Queue an event of a poll set in the ready list, unless it is already
+ * there, and wake up a thread waiting on the set. The event stays registered.
+ *
+ * Must be called with interrupts locked. Returns 1 if a reschedule must take
+ * place, 0 otherwise.
+ */
+static int signal_set_event(struct k_poll_event *event, u32_t state)
+{
+	struct k_poll_set *set = event->poller->set;
+	struct k_thread *thread;
+
+	if (event->queued) {
+		event->state |= state;
+		return 0;
+	}
+
+	event->state = state;
+	event->queued = 1;
+	sys_slist_append(&set->ready, &event->ready_node);
+
+	thread = _unpend_first_thread(&set->wait_q);
+	if (!thread) {
+		return 0;
+	}
+
+	_abort_thread_timeout(thread);
+	_set_thread_return_value(thread, 0);
+	_ready_thread(thread);
+
+	return !_is_in_isr() && _must_switch_threads();
+}
+
 /* returns 1 if a reschedule must take place, 0 otherwise */
 /* *obj_poll_event is guaranteed to not be NULL */
 int _handle_obj_poll_event(struct k_poll_event **obj_poll_event, u32_t state)
@@ -312,6 +357,10 @@ int _handle_obj_poll_event(struct k_poll_event **obj_poll_event, u32_t state)
 	struct k_poll_event *poll_event = *obj_poll_event;
 	int must_reschedule;
 
+	if (is_in_set(poll_event)) {
+		return signal_set_event(poll_event, state);
+	}
+
 	*obj_poll_event = NULL;
 	(void)_signal_poll_event(poll_event, state, &must_reschedule);
 	return must_reschedule;
@@ -337,8 +386,16 @@ int k_poll_signal(struct k_poll_signal *signal, int result)
 		return 0;
 	}
 
-	int rc = _signal_poll_event(signal->poll_event, K_POLL_STATE_SIGNALED,
-				    &must_reschedule);
+	int rc = 0;
+
+	if (is_in_set(signal->poll_event)) {
+		must_reschedule = signal_set_event(signal->poll_event,
+						   K_POLL_STATE_SIGNALED);
+	} else {
+		rc = _signal_poll_event(signal->poll_event,
+					K_POLL_STATE_SIGNALED,
+					&must_reschedule);
+	}
 
 	if (must_reschedule) {
 		(void)_Swap(key);
@@ -348,3 +405,94 @@ int k_poll_signal(struct k_poll_signal *signal, int result)
 
 	return rc;
 }
+
+void k_poll_set_init(struct k_poll_set *set)
+{
+	set->poller.thread = NULL;
+	set->poller.set = set;
+	sys_slist_init(&set->ready);
+	sys_dlist_init(&set->wait_q);
+}
+
+int k_poll_set_add(struct k_poll_set *set, struct k_poll_event *event)
+{
+	unsigned int key = irq_lock();
+	u32_t state;
+	int rc;
+
+	rc = register_event(event);
+	if (rc == 0) {
+		event->poller = &set->poller;
+		event->queued = 0;
+		event->state = K_POLL_STATE_NOT_READY;
+
+		/* report a condition already fulfilled like a new signal */
+		if (is_condition_met(event, &state)) {
+			(void)signal_set_event(event, state);
+		}
+	}
+
+	irq_unlock(key);
+
+	return rc;
+}
+
+void k_poll_set_remove(struct k_poll_set *set, struct k_poll_event *event)
+{
+	unsigned int key = irq_lock();
+
+	__ASSERT(event->poller == &set->poller, "event not in set\n");
+
+	clear_event_registration(event);
+
+	if (event->queued) {
+		sys_slist_find_and_remove(&set->ready, &event->ready_node);
+		event->queued = 0;
+	}
+
+	irq_unlock(key);
+}
+
+int k_poll_set_wait(struct k_poll_set *set, struct k_poll_event **events,
+		    int max_events, s32_t timeout)
+{
+	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
+	__ASSERT(events, "NULL events\n");
+	__ASSERT(max_events > 0, "zero events\n");
+
+	unsigned int key = irq_lock();
+	struct k_poll_event *event;
+	sys_snode_t *node;
+	int count = 0;
+	int rc;
+
+	/* another thread waiting on the set may have emptied it again */
+	while (sys_slist_is_empty(&set->ready)) {
+		if (timeout == K_NO_WAIT) {
+			irq_unlock(key);
+			return -EAGAIN;
+		}
+
+		_pend_current_thread(&set->wait_q, timeout);
+		rc = _Swap(key);
+		if (rc != 0) {
+			return rc;
+		}
+		key = irq_lock();
+	}
+
+	while (count < max_events) {
+		node = sys_slist_get(&set->ready);
+		if (!node) {
+			break;
+		}
+
+		event = CONTAINER_OF(node, struct k_poll_event, ready_node);
+		event->queued = 0;
+		events[count++] = event;
+	}
+
+	irq_unlock(key);
+
+	return count;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * Priority workqueue support functions
+ *
+ * Pending work items are kept in a list sorted by priority, and a pool of
+ * worker threads takes them from its head. Idle workers pend on the
+ * workqueue's wait queue, and each submission wakes up at most one of them.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <wait_q.h>
+#include <ksched.h>
+#include <misc/slist.h>
+
+void _prio_work_submit(struct k_prio_work_q *work_q, struct k_prio_work *work)
+{
+	unsigned int key = irq_lock();
+	sys_snode_t *node = (sys_snode_t *)&work->work;
+	sys_snode_t *tail = sys_slist_peek_tail(&work_q->pending);
+	sys_snode_t *prev = NULL;
+	sys_snode_t *cur;
+	struct k_thread *thread;
+
+	work->submit_time = k_cycle_get_32();
+
+	/* most items are submitted at the lowest pending priority */
+	if (tail && ((struct k_prio_work *)tail)->prio <= work->prio) {
+		prev = tail;
+	} else {
+		SYS_SLIST_FOR_EACH_NODE(&work_q->pending, cur) {
+			if (((struct k_prio_work *)cur)->prio > work->prio) {
+				break;
+			}
+			prev = cur;
+		}
+	}
+
+	sys_slist_insert(&work_q->pending, prev, node);
+
+	work_q->depth++;
+	if (work_q->depth > work_q->max_depth) {
+		work_q->max_depth = work_q->depth;
+	}
+
+	thread = _unpend_first_thread(&work_q->wait_q);
+	if (thread) {
+		_ready_thread(thread);
+		if (!_is_in_isr() && _must_switch_threads()) {
+			_Swap(key);
+			return;
+		}
+	}
+
+	irq_unlock(key);
+}
+
+static void prio_work_q_main(void *work_q_ptr, void *p2, void *p3)
+{
+	struct k_prio_work_q *work_q = work_q_ptr;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		struct k_prio_work *work;
+		k_work_handler_t handler;
+		unsigned int key;
+
+		key = irq_lock();
+
+		/* another worker may have taken the item we were woken for */
+		while (sys_slist_is_empty(&work_q->pending)) {
+			_pend_current_thread(&work_q->wait_q, K_FOREVER);
+			_Swap(key);
+			key = irq_lock();
+		}
+
+		work = (struct k_prio_work *)
+			sys_slist_get_not_empty(&work_q->pending);
+		work_q->depth--;
+
+		work->wait = k_cycle_get_32() - work->submit_time;
+		if (work->wait > work_q->max_wait) {
+			work_q->max_wait = work->wait;
+		}
+		work_q->num_processed++;
+
+		irq_unlock(key);
+
+		handler = work->work.handler;
+
+		/* Reset pending state so it can be resubmitted by handler */
+		if (atomic_test_and_clear_bit(work->work.flags,
+					       K_WORK_STATE_PENDING)) {
+			handler(&work->work);
+		}
+
+		/* Let the other workers of the same priority run */
+		k_yield();
+	}
+}
+
+void k_prio_work_q_start(struct k_prio_work_q *work_q,
+			 struct k_thread *threads, char *stacks,
+			 size_t stack_size, int num_workers, int prio)
+{
+	int i;
+
+	sys_slist_init(&work_q->pending);
+	sys_dlist_init(&work_q->wait_q);
+	work_q->depth = 0;
+	work_q->max_depth = 0;
+	work_q->num_processed = 0;
+	work_q->max_wait = 0;
+
+	for (i = 0; i < num_workers; i++) {
+		k_thread_create(&threads[i], stacks + i * stack_size,
+				stack_size, prio_work_q_main,
+				work_q, 0, 0, prio, 0, 0);
+	}
+}
+
+u32_t k_prio_work_q_max_wait_get(struct k_prio_work_q *work_q,
+				 u32_t *max_depth)
+{
+	if (max_depth) {
+		*max_depth = work_q->max_depth;
+	}
+
+	return work_q->max_wait;
+}
+
+u32_t k_prio_work_wait_get(struct k_prio_work *work)
+{
+	unsigned int key = irq_lock();
+	u32_t wait;
+
+	/* a pending item is still in the list, with its submit time */
+	if (k_work_pending(&work->work)) {
+		wait = k_cycle_get_32() - work->submit_time;
+	} else {
+		wait = work->wait;
+	}
+
+	irq_unlock(key);
+
+	return wait;
+}
@@ -51,6 +51,9 @@ void k_queue_init(struct k_queue *queue)
 {
 	sys_slist_init(&queue->data_q);
 	sys_dlist_init(&queue->wait_q);
+#ifdef CONFIG_QUEUE_LOCKFREE_APPEND
+	atomic_clear(&queue->lockfree_q);
+#endif
 
 	_INIT_OBJ_POLL_EVENT(queue);
 
@@ -77,6 +80,50 @@ static inline int handle_poll_event(struct k_queue *queue)
 #endif
 }
 
+#ifdef CONFIG_QUEUE_LOCKFREE_APPEND
+/*
+ * Move the items appended without locking to the end of data_q. Called with
+ * interrupts locked, the whole list of such items is detached at once, so
+ * that producers can keep on pushing to an empty list meanwhile.
+ */
+static void lockfree_flush(struct k_queue *queue)
+{
+	sys_snode_t *node = (sys_snode_t *)atomic_clear(&queue->lockfree_q);
+	sys_snode_t *tail = node;
+	sys_snode_t *head = NULL;
+	sys_snode_t *next;
+
+	if (!node) {
+		return;
+	}
+
+	/* the list is most recent first: reverse it */
+	while (node) {
+		next = node->next;
+		node->next = head;
+		head = node;
+		node = next;
+	}
+
+	sys_slist_append_list(&queue->data_q, head, tail);
+}
+
+void _k_queue_lockfree_flush(struct k_queue *queue)
+{
+	unsigned int key;
+
+	if (!atomic_get(&queue->lockfree_q)) {
+		return;
+	}
+
+	key = irq_lock();
+	lockfree_flush(queue);
+	irq_unlock(key);
+}
+#else
+#define lockfree_flush(queue) do { } while ((0))
+#endif /* CONFIG_QUEUE_LOCKFREE_APPEND */
+
 void k_queue_cancel_wait(struct k_queue *queue)
 {
 	struct k_thread *first_pending_thread;
@@ -102,13 +149,21 @@ void k_queue_cancel_wait(struct k_queue *queue)
 	irq_unlock(key);
 }
 
-void k_queue_insert(struct k_queue *queue, void *prev, void *data)
+static void queue_insert(struct k_queue *queue, void *prev, void *data,
+			 bool append)
 {
 	struct k_thread *first_pending_thread;
 	unsigned int key;
 
 	key = irq_lock();
 
+	lockfree_flush(queue);
+
+	/* the tail is only known once the lock-free appends are in */
+	if (append) {
+		prev = sys_slist_peek_tail(&queue->data_q);
+	}
+
 	first_pending_thread = _unpend_first_thread(&queue->wait_q);
 
 	if (first_pending_thread) {
@@ -128,15 +183,83 @@ void k_queue_insert(struct k_queue *queue, void *prev, void *data)
 	irq_unlock(key);
 }
 
+void k_queue_insert(struct k_queue *queue, void *prev, void *data)
+{
+	queue_insert(queue, prev, data, false);
+}
+
 void k_queue_append(struct k_queue *queue, void *data)
 {
-	return k_queue_insert(queue, queue->data_q.tail, data);
+	queue_insert(queue, NULL, data, true);
 }
 
 void k_queue_prepend(struct k_queue *queue, void *data)
 {
-	return k_queue_insert(queue, NULL, data);
+	queue_insert(queue, NULL, data, false);
+}
+
+#ifdef CONFIG_QUEUE_LOCKFREE_APPEND
+/* hand the items appended without locking to a thread pending on the queue */
+static void lockfree_wake(struct k_queue *queue)
+{
+	struct k_thread *first_pending_thread;
+	unsigned int key;
+
+	key = irq_lock();
+
+	lockfree_flush(queue);
+
+	/* a consumer may have gathered the item in the meantime */
+	if (sys_slist_is_empty(&queue->data_q)) {
+		irq_unlock(key);
+		return;
+	}
+
+	first_pending_thread = _unpend_first_thread(&queue->wait_q);
+
+	if (first_pending_thread) {
+		prepare_thread_to_run(first_pending_thread,
+				      sys_slist_get_not_empty(&queue->data_q));
+		if (!_is_in_isr() && _must_switch_threads()) {
+			(void)_Swap(key);
+			return;
+		}
+	} else {
+		if (handle_poll_event(queue)) {
+			(void)_Swap(key);
+			return;
+		}
+	}
+
+	irq_unlock(key);
+}
+
+void k_queue_append_lockfree(struct k_queue *queue, void *data)
+{
+	atomic_val_t head;
+
+	do {
+		head = atomic_get(&queue->lockfree_q);
+		((sys_snode_t *)data)->next = (sys_snode_t *)head;
+	} while (!atomic_cas(&queue->lockfree_q, head, (atomic_val_t)data));
+
+	/*
+	 * Consumers check for lock-free appends before pending and both are
+	 * done with interrupts locked: if nobody waits on the queue now, the
+	 * next consumer will find the item.
+	 */
+	if (!sys_dlist_is_empty(&queue->wait_q)) {
+		lockfree_wake(queue);
+		return;
+	}
+
+#ifdef CONFIG_POLL
+	if (queue->poll_event) {
+		lockfree_wake(queue);
+	}
+#endif
 }
+#endif /* CONFIG_QUEUE_LOCKFREE_APPEND */
 
 void k_queue_append_list(struct k_queue *queue, void *head, void *tail)
 {
@@ -147,6 +270,8 @@ void k_queue_append_list(struct k_queue *queue, void *head, void *tail)
 
 	key = irq_lock();
 
+	lockfree_flush(queue);
+
 	first_thread = _peek_first_pending_thread(&queue->wait_q);
 	while (head && ((thread = _unpend_first_thread(&queue->wait_q)))) {
 		prepare_thread_to_run(thread, head);
@@ -193,6 +318,8 @@ void *k_queue_get(struct k_queue *queue, s32_t timeout)
 
 	key = irq_lock();
 
+	lockfree_flush(queue);
+
 	if (likely(!sys_slist_is_empty(&queue->data_q))) {
 		data = sys_slist_get_not_empty(&queue->data_q);
 		irq_unlock(key);
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file @brief reader-writer lock kernel services
+ *
+ * A reader-writer lock is held either by any number of readers, which are
+ * only counted, or by a single writer. Readers and writers wait on separate,
+ * priority-ordered wait queues.
+ *
+ * Writers are preferred: a reader does not get the lock while a writer of
+ * equal or higher priority waits for it, so that a steady flow of readers
+ * cannot starve writers. When the lock becomes free, it is handed over either
+ * to the first waiting writer, or to all the waiting readers at once if the
+ * first of them has a higher priority than any waiting writer.
+ *
+ * The writer inherits the priority of the highest priority thread waiting on
+ * the lock, following the same rules as mutex owners. Readers do not, since
+ * they are not recorded.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <toolchain.h>
+#include <linker/sections.h>
+#include <wait_q.h>
+#include <misc/dlist.h>
+#include <ksched.h>
+#include <debug/object_tracing_common.h>
+#include <errno.h>
+#include <init.h>
+
+extern struct k_rwlock _k_rwlock_list_start[];
+extern struct k_rwlock _k_rwlock_list_end[];
+
+#ifdef CONFIG_OBJECT_TRACING
+
+struct k_rwlock *_trace_list_k_rwlock;
+
+/*
+ * Complete initialization of statically defined reader-writer locks.
+ */
+static int init_rwlock_module(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	struct k_rwlock *rwlock;
+
+	for (rwlock = _k_rwlock_list_start; rwlock < _k_rwlock_list_end;
+	     rwlock++) {
+		SYS_TRACING_OBJ_INIT(k_rwlock, rwlock);
+	}
+	return 0;
+}
+
+SYS_INIT(init_rwlock_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+#endif /* CONFIG_OBJECT_TRACING */
+
+void k_rwlock_init(struct k_rwlock *rwlock)
+{
+	rwlock->writer = NULL;
+	rwlock->readers = 0;
+
+	/* initialized upon first use */
+	/* rwlock->writer_orig_prio = 0; */
+
+	sys_dlist_init(&rwlock->readers_q);
+	sys_dlist_init(&rwlock->writers_q);
+
+	SYS_TRACING_OBJ_INIT(k_rwlock, rwlock);
+}
+
+/* can 'thread' get the lock for reading ahead of the waiting writers ? */
+static inline int reader_goes_first(struct k_rwlock *rwlock,
+				    struct k_thread *thread)
+{
+	struct k_thread *writer = _peek_first_pending_thread(&rwlock->writers_q);
+
+	return !writer || _is_t1_higher_prio_than_t2(thread, writer);
+}
+
+/*
+ * Set the priority of the writer to the priority it locked the lock at,
+ * raised to the priority of the first thread waiting on the lock, within the
+ * inheritance ceiling. With 'raise', only ever raise it.
+ */
+/* must be called with interrupts locked */
+static void adjust_writer_prio(struct k_rwlock *rwlock, int raise)
+{
+	struct k_thread *waiters[2] = {
+		_peek_first_pending_thread(&rwlock->readers_q),
+		_peek_first_pending_thread(&rwlock->writers_q),
+	};
+	struct k_thread *writer = rwlock->writer;
+	int prio = rwlock->writer_orig_prio;
+	int i;
+
+	if (!writer) {
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(waiters); i++) {
+		if (waiters[i]) {
+			int inherited =
+				_get_new_prio_with_ceiling(waiters[i]->base.prio);
+
+			if (_is_prio_higher(inherited, prio)) {
+				prio = inherited;
+			}
+		}
+	}
+
+	if (raise ? _is_prio_higher(prio, writer->base.prio) :
+		    prio != writer->base.prio) {
+		_thread_priority_set(writer, prio);
+	}
+}
+
+static void wake_waiter(struct k_thread *thread)
+{
+	_abort_thread_timeout(thread);
+	_ready_thread(thread);
+	_set_thread_return_value(thread, 0);
+}
+
+/*
+ * Hand the lock over to the waiting readers while no writer goes first, or to
+ * the first waiting writer if the lock is free.
+ */
+/* returns 1 if a thread was readied, 0 otherwise */
+/* must be called with interrupts locked, while no writer holds the lock */
+static int wake_waiters(struct k_rwlock *rwlock)
+{
+	struct k_thread *thread;
+	int woken = 0;
+
+	for (;;) {
+		thread = _peek_first_pending_thread(&rwlock->readers_q);
+		if (!thread || !reader_goes_first(rwlock, thread)) {
+			break;
+		}
+
+		_unpend_thread(thread);
+		wake_waiter(thread);
+		rwlock->readers++;
+		woken = 1;
+	}
+
+	if (rwlock->readers == 0) {
+		thread = _unpend_first_thread(&rwlock->writers_q);
+		if (thread) {
+			wake_waiter(thread);
+			rwlock->writer = thread;
+			rwlock->writer_orig_prio = thread->base.prio;
+			woken = 1;
+		}
+	}
+
+	return woken;
+}
+
+/*
+ * Pend the current thread on 'wait_q' of 'rwlock', and clean up if it times
+ * out: the writer may have to give back the priority it inherited from the
+ * current thread, and readers may have been held back only by the current
+ * thread.
+ */
+static int wait_for_lock(struct k_rwlock *rwlock, _wait_q_t *wait_q,
+			 s32_t timeout, unsigned int key)
+{
+	int ret;
+
+	_pend_current_thread(wait_q, timeout);
+	adjust_writer_prio(rwlock, 1);
+
+	ret = _Swap(key);
+	if (ret == 0) {
+		return 0;
+	}
+
+	key = irq_lock();
+
+	if (rwlock->writer) {
+		adjust_writer_prio(rwlock, 0);
+		irq_unlock(key);
+	} else if (wake_waiters(rwlock)) {
+		_reschedule_threads(key);
+	} else {
+		irq_unlock(key);
+	}
+
+	return ret;
+}
+
+int k_rwlock_read_lock(struct k_rwlock *rwlock, s32_t timeout)
+{
+	__ASSERT(!_is_in_isr(), "");
+
+	unsigned int key = irq_lock();
+
+	if (likely(!rwlock->writer && reader_goes_first(rwlock, _current))) {
+		rwlock->readers++;
+		irq_unlock(key);
+		return 0;
+	}
+
+	if (unlikely(timeout == K_NO_WAIT)) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	return wait_for_lock(rwlock, &rwlock->readers_q, timeout, key);
+}
+
+void k_rwlock_read_unlock(struct k_rwlock *rwlock)
+{
+	unsigned int key = irq_lock();
+
+	__ASSERT(rwlock->readers > 0, "");
+
+	rwlock->readers--;
+
+	if (rwlock->readers == 0 && wake_waiters(rwlock)) {
+		_reschedule_threads(key);
+	} else {
+		irq_unlock(key);
+	}
+}
+
+int k_rwlock_write_lock(struct k_rwlock *rwlock, s32_t timeout)
+{
+	__ASSERT(!_is_in_isr(), "");
+	__ASSERT(rwlock->writer != _current, "");
+
+	unsigned int key = irq_lock();
+
+	if (likely(!rwlock->writer && rwlock->readers == 0)) {
+		rwlock->writer = _current;
+		rwlock->writer_orig_prio = _current->base.prio;
+		irq_unlock(key);
+		return 0;
+	}
+
+	if (unlikely(timeout == K_NO_WAIT)) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	return wait_for_lock(rwlock, &rwlock->writers_q, timeout, key);
+}
+
+void k_rwlock_write_unlock(struct k_rwlock *rwlock)
+{
+	unsigned int key = irq_lock();
+
+	__ASSERT(rwlock->writer == _current, "");
+
+	if (_current->base.prio != rwlock->writer_orig_prio) {
+		_thread_priority_set(_current, rwlock->writer_orig_prio);
+	}
+
+	rwlock->writer = NULL;
+
+	if (wake_waiters(rwlock)) {
+		_reschedule_threads(key);
+	} else {
+		irq_unlock(key);
+	}
+}
@@ -14,6 +14,84 @@
 /* the only struct _kernel instance */
 struct _kernel _kernel = {0};
 
+#ifdef CONFIG_TIMESLICING
+static void _time_slice_thread_added(struct k_thread *thread);
+#else
+#define _time_slice_thread_added(thread) do { } while (0)
+#endif
+
+#ifdef CONFIG_SCHED_SCALABLE
+
+/*
+ * Scalable ready queue: all ready threads are kept in a single red-black tree
+ * sorted by priority, then by deadline, then in the order they were made
+ * ready. The next thread to run is still found in O(1) via the cache; adding
+ * or removing a thread is O(log n) in the number of ready threads.
+ */
+
+static inline struct k_thread *_rb_node_to_thread(sys_rbnode_t *node)
+{
+	return CONTAINER_OF(node, struct k_thread, base.k_q_rb_node);
+}
+
+int _ready_q_lessthan(sys_rbnode_t *a, sys_rbnode_t *b)
+{
+	return _is_t1_higher_prio_than_t2(_rb_node_to_thread(a),
+					  _rb_node_to_thread(b));
+}
+
+/*
+ * Find the next thread to run when there is no thread in the cache and update
+ * the cache.
+ */
+static struct k_thread *_get_ready_q_head(void)
+{
+	sys_rbnode_t *node = sys_rb_get_min(&_ready_q.tree);
+
+	__ASSERT(node, "no thread to run!\n");
+
+	return _rb_node_to_thread(node);
+}
+
+/*
+ * Add thread to the ready queue, in the slot for its priority and deadline;
+ * the thread must not be on a wait queue.
+ *
+ * This function, along with _move_thread_to_end_of_prio_q(), are the _only_
+ * places where a thread is put on the ready queue.
+ *
+ * Interrupts must be locked when calling this function.
+ */
+
+void _add_thread_to_ready_q(struct k_thread *thread)
+{
+	sys_rb_insert(&_ready_q.tree, &thread->base.k_q_rb_node);
+
+	struct k_thread **cache = &_ready_q.cache;
+
+	*cache = _is_t1_higher_prio_than_t2(thread, *cache) ? thread : *cache;
+
+	_time_slice_thread_added(thread);
+}
+
+/*
+ * This function, along with _move_thread_to_end_of_prio_q(), are the _only_
+ * places where a thread is taken off the ready queue.
+ *
+ * Interrupts must be locked when calling this function.
+ */
+
+void _remove_thread_from_ready_q(struct k_thread *thread)
+{
+	sys_rb_remove(&_ready_q.tree, &thread->base.k_q_rb_node);
+
+	struct k_thread **cache = &_ready_q.cache;
+
+	*cache = *cache == thread ? _get_ready_q_head() : *cache;
+}
+
+#else /* CONFIG_SCHED_SCALABLE */
+
 /* set the bit corresponding to prio in ready q bitmap */
 #ifdef CONFIG_MULTITHREADING
 static void _set_ready_q_prio_bit(int prio)
@@ -80,6 +158,8 @@ void _add_thread_to_ready_q(struct k_thread *thread)
 	struct k_thread **cache = &_ready_q.cache;
 
 	*cache = _is_t1_higher_prio_than_t2(thread, *cache) ? thread : *cache;
+
+	_time_slice_thread_added(thread);
 #else
 	sys_dlist_append(&_ready_q.q[0], &thread->base.k_q_node);
 	_ready_q.prio_bmap[0] = 1;
@@ -115,6 +195,8 @@ void _remove_thread_from_ready_q(struct k_thread *thread)
 #endif
 }
 
+#endif /* CONFIG_SCHED_SCALABLE */
+
 /* reschedule threads if the scheduler is not locked */
 /* not callable from ISR */
 /* must be called with interrupts locked */
@@ -182,11 +264,10 @@ s32_t _ms_to_ticks(s32_t ms)
 }
 #endif
 
-/* pend the specified thread: it must *not* be in the ready queue */
-/* must be called with interrupts locked */
-void _pend_thread(struct k_thread *thread, _wait_q_t *wait_q, s32_t timeout)
-{
 #ifdef CONFIG_MULTITHREADING
+/* insert a thread in a wait queue, after the threads of the same priority */
+static void insert_pending_thread(struct k_thread *thread, _wait_q_t *wait_q)
+{
 	sys_dlist_t *wait_q_list = (sys_dlist_t *)wait_q;
 	sys_dnode_t *node;
 
@@ -196,14 +277,25 @@ void _pend_thread(struct k_thread *thread, _wait_q_t *wait_q, s32_t timeout)
 		if (_is_t1_higher_prio_than_t2(thread, pending)) {
 			sys_dlist_insert_before(wait_q_list, node,
 						&thread->base.k_q_node);
-			goto inserted;
+			return;
 		}
 	}
 
 	sys_dlist_append(wait_q_list, &thread->base.k_q_node);
+}
+#endif
+
+/* pend the specified thread: it must *not* be in the ready queue */
+/* must be called with interrupts locked */
+void _pend_thread(struct k_thread *thread, _wait_q_t *wait_q, s32_t timeout)
+{
+#ifdef CONFIG_MULTITHREADING
+	insert_pending_thread(thread, wait_q);
 
-inserted:
 	_mark_thread_as_pending(thread);
+#ifdef CONFIG_SCHED_DEADLINE
+	thread->base.pended_on = wait_q;
+#endif
 
 	if (timeout != K_FOREVER) {
 		s32_t ticks = _TICK_ALIGN + _ms_to_ticks(timeout);
@@ -221,8 +313,33 @@ void _pend_current_thread(_wait_q_t *wait_q, s32_t timeout)
 	_pend_thread(_current, wait_q, timeout);
 }
 
+/*
+ * Move a pending thread to its place in its wait queue after its priority
+ * changed. The thread keeps its timeout, if any.
+ */
+/* must be called with interrupts locked */
+void _reorder_pending_thread(struct k_thread *thread, _wait_q_t *wait_q)
+{
+#ifdef CONFIG_MULTITHREADING
+	sys_dlist_remove(&thread->base.k_q_node);
+	insert_pending_thread(thread, wait_q);
+#endif
+}
+
 #if defined(CONFIG_PREEMPT_ENABLED) && defined(CONFIG_KERNEL_DEBUG)
 /* debug aid */
+#ifdef CONFIG_SCHED_SCALABLE
+static void _dump_ready_q(void)
+{
+	sys_rbnode_t *node;
+
+	SYS_RB_FOR_EACH_NODE(&_ready_q.tree, node) {
+		K_DEBUG("prio: %d, thread: %p\n",
+			_rb_node_to_thread(node)->base.prio,
+			_rb_node_to_thread(node));
+	}
+}
+#else
 static void _dump_ready_q(void)
 {
 	K_DEBUG("bitmaps: ");
@@ -236,6 +353,7 @@ static void _dump_ready_q(void)
 			sys_dlist_peek_head(&_ready_q.q[prio]));
 	}
 }
+#endif
 #endif  /* CONFIG_PREEMPT_ENABLED && CONFIG_KERNEL_DEBUG */
 
 /*
@@ -252,7 +370,12 @@ int __must_switch_threads(void)
 	_dump_ready_q();
 #endif  /* CONFIG_KERNEL_DEBUG */
 
+#ifdef CONFIG_SCHED_DEADLINE
+	/* also switch to a thread of same prio but earlier deadline */
+	return _is_t1_higher_prio_than_t2(_get_next_ready_thread(), _current);
+#else
 	return _is_prio_higher(_get_highest_ready_prio(), _current->base.prio);
+#endif
 #else
 	return 0;
 #endif
@@ -279,6 +402,31 @@ void k_thread_priority_set(k_tid_t tid, int prio)
 	_reschedule_threads(key);
 }
 
+#ifdef CONFIG_SCHED_DEADLINE
+void k_thread_deadline_set(k_tid_t tid, int deadline)
+{
+	__ASSERT(!_is_in_isr(), "");
+
+	struct k_thread *thread = (struct k_thread *)tid;
+	int key = irq_lock();
+
+	/* ready and wait queues are sorted on the deadline: requeue the thread */
+	if (_is_thread_ready(thread)) {
+		_remove_thread_from_ready_q(thread);
+		thread->base.prio_deadline = k_cycle_get_32() + deadline;
+		_add_thread_to_ready_q(thread);
+	} else {
+		thread->base.prio_deadline = k_cycle_get_32() + deadline;
+		if (_is_thread_pending(thread) && thread->base.pended_on) {
+			_reorder_pending_thread(thread,
+						thread->base.pended_on);
+		}
+	}
+
+	_reschedule_threads(key);
+}
+#endif
+
 /*
  * Interrupts must be locked when calling this function.
  *
@@ -288,7 +436,22 @@ void k_thread_priority_set(k_tid_t tid, int prio)
  */
 void _move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
-#ifdef CONFIG_MULTITHREADING
+#if defined(CONFIG_SCHED_SCALABLE)
+	sys_rbnode_t *node = &thread->base.k_q_rb_node;
+	sys_rbnode_t *next = sys_rb_next(node);
+
+	/* already behind all the threads that compare equal to it */
+	if (!next || _ready_q_lessthan(node, next)) {
+		return;
+	}
+
+	sys_rb_remove(&_ready_q.tree, node);
+	sys_rb_insert(&_ready_q.tree, node);
+
+	struct k_thread **cache = &_ready_q.cache;
+
+	*cache = *cache == thread ? _get_ready_q_head() : *cache;
+#elif defined(CONFIG_MULTITHREADING)
 	int q_index = _get_ready_q_q_index(thread->base.prio);
 	sys_dlist_t *q = &_ready_q.q[q_index];
 
@@ -383,18 +546,102 @@ k_tid_t k_current_get(void)
 }
 
 #ifdef CONFIG_TIMESLICING
-extern s32_t _time_slice_duration;    /* Measured in ms */
-extern s32_t _time_slice_elapsed;     /* Measured in ms */
-extern int _time_slice_prio_ceiling;
+/*
+ * Time slicing is handled as yet another timeout, which is only queued while
+ * the running thread shares its priority with other ready threads: there is
+ * nothing to account for on each tick, thus a tickless kernel does not need
+ * the periodic tick to round-robin between threads.
+ */
+static s32_t _time_slice_duration = CONFIG_TIMESLICE_SIZE; /* in ms */
+static int _time_slice_prio_ceiling = CONFIG_TIMESLICE_PRIORITY;
+
+static void _time_slice_expired(struct _timeout *timeout);
+
+static struct _timeout _time_slice_timeout = {
+	.delta_ticks_from_prev = _INACTIVE,
+	.wait_q = NULL,
+	.thread = NULL,
+	.func = _time_slice_expired,
+};
+
+/* thread the time slice was last started for */
+static struct k_thread *_time_slice_thread;
+
+/*
+ * Start a new time slice for a thread about to run, or stop time slicing if
+ * it does not share its priority with other ready threads.
+ *
+ * Must be called with interrupts locked.
+ */
+static void _start_time_slice(struct k_thread *thread)
+{
+	_abort_timeout(&_time_slice_timeout);
+	_time_slice_thread = thread;
+
+	if (_is_thread_time_slicing(thread)) {
+		_add_timeout(NULL, &_time_slice_timeout, NULL,
+			     _ms_to_ticks(_time_slice_duration));
+	}
+}
+
+/*
+ * Always called from the system clock interrupt: the thread moved to the end
+ * of its priority queue is switched out when the interrupt exits, without
+ * going through _Swap(), hence the next slice is started here.
+ */
+static void _time_slice_expired(struct _timeout *timeout)
+{
+	unsigned int key = irq_lock();
+
+	ARG_UNUSED(timeout);
+
+	if (_is_thread_time_slicing(_current)) {
+		_move_thread_to_end_of_prio_q(_current);
+		_start_time_slice(_get_next_ready_thread());
+	}
+
+	irq_unlock(key);
+}
+
+/*
+ * A thread made ready at the priority of the current thread makes the latter
+ * start time slicing, without any thread switch: start its slice now.
+ *
+ * Must be called with interrupts locked.
+ */
+static void _time_slice_thread_added(struct k_thread *thread)
+{
+	/*
+	 * There is no current thread, or only the dummy one, while the
+	 * kernel is initialized: the timeout queue may not even be ready.
+	 */
+	if (!_current || _is_thread_dummy(_current)) {
+		return;
+	}
+
+	if (_time_slice_duration > 0 && thread != _current &&
+	    thread->base.prio == _current->base.prio &&
+	    _time_slice_timeout.delta_ticks_from_prev == _INACTIVE) {
+		_start_time_slice(_current);
+	}
+}
 
 void k_sched_time_slice_set(s32_t duration_in_ms, int prio)
 {
+	unsigned int key;
+
 	__ASSERT(duration_in_ms >= 0, "");
 	__ASSERT((prio >= 0) && (prio < CONFIG_NUM_PREEMPT_PRIORITIES), "");
 
+	key = irq_lock();
+
 	_time_slice_duration = duration_in_ms;
-	_time_slice_elapsed = 0;
 	_time_slice_prio_ceiling = prio;
+
+	/* restart the slice of the current thread with the new settings */
+	_start_time_slice(_current);
+
+	irq_unlock(key);
 }
 
 int _is_thread_time_slicing(struct k_thread *thread)
@@ -413,29 +660,50 @@ int _is_thread_time_slicing(struct k_thread *thread)
 		return 0;
 	}
 
+#ifdef CONFIG_SCHED_SCALABLE
+	/* threads of equal priority are next to each other in the tree */
+	if (!_is_thread_ready(thread)) {
+		return 0;
+	}
+
+	sys_rbnode_t *prev = sys_rb_prev(&thread->base.k_q_rb_node);
+	sys_rbnode_t *next = sys_rb_next(&thread->base.k_q_rb_node);
+	int prio = thread->base.prio;
+
+	return (prev && _rb_node_to_thread(prev)->base.prio == prio) ||
+	       (next && _rb_node_to_thread(next)->base.prio == prio);
+#else
 	int q_index = _get_ready_q_q_index(thread->base.prio);
 	sys_dlist_t *q = &_ready_q.q[q_index];
 
 	return sys_dlist_has_multiple_nodes(q);
+#endif
 }
 
-/* Must be called with interrupts locked */
-/* Should be called only immediately before a thread switch */
+/*
+ * Should be called only immediately before a thread switch. Some
+ * architectures also call it on every interrupt exit, whether the thread
+ * changes or not: the slice of a thread which keeps running goes on.
+ */
 void _update_time_slice_before_swap(void)
 {
-#ifdef CONFIG_TICKLESS_KERNEL
-	if (!_is_thread_time_slicing(_get_next_ready_thread())) {
-		return;
-	}
+	struct k_thread *next;
+	unsigned int key;
 
-	u32_t remaining = _get_remaining_program_time();
+	key = irq_lock();
 
-	if (!remaining || (_time_slice_duration < remaining)) {
-		_set_time(_time_slice_duration);
+	/*
+	 * Restart time slice at new thread switch, or if the thread started
+	 * sharing its priority since its slice was last started.
+	 */
+	next = _get_next_ready_thread();
+	if (next != _time_slice_thread ||
+	    (_time_slice_timeout.delta_ticks_from_prev == _INACTIVE &&
+	     _is_thread_time_slicing(next))) {
+		_start_time_slice(next);
 	}
-#endif
-	/* Restart time slice count at new thread switch */
-	_time_slice_elapsed = 0;
+
+	irq_unlock(key);
 }
 #endif /* CONFIG_TIMESLICING */
 
@@ -48,8 +48,6 @@ volatile u64_t _sys_clock_tick_count;
  * To save power, this should be turned on only when required.
  */
 int _sys_clock_always_on;
-
-static u32_t next_ts;
 #endif
 /**
  *
@@ -229,53 +227,36 @@ static inline void handle_timeouts(s32_t ticks)
 
 	key = irq_lock();
 
-	struct _timeout *head =
-		(struct _timeout *)sys_dlist_peek_head(&_timeout_q);
+	struct _timeout *timeout = _timeout_q_first();
 
-	K_DEBUG("head: %p, delta: %d\n",
-		head, head ? head->delta_ticks_from_prev : -2112);
+	K_DEBUG("head: %p, ticks left: %d\n",
+		timeout, timeout ? _timeout_ticks_left(timeout) : -2112);
 
-	if (!head) {
+	if (!timeout) {
 		irq_unlock(key);
 		return;
 	}
 
-	head->delta_ticks_from_prev -= ticks;
+	_timeout_q_elapse(ticks);
 
 	/*
 	 * Dequeue all expired timeouts from _timeout_q, relieving irq lock
 	 * pressure between each of them, allowing handling of higher priority
-	 * interrupts. We know that no new timeout will be prepended in front
-	 * of a timeout which delta is 0, since timeouts of 0 ticks are
-	 * prohibited.
+	 * interrupts.
 	 */
-	sys_dnode_t *next = &head->node;
-	struct _timeout *timeout = (struct _timeout *)next;
-
 	_handling_timeouts = 1;
 
-	while (timeout && timeout->delta_ticks_from_prev == 0) {
+	while (timeout && _timeout_has_expired(timeout)) {
 
-		sys_dlist_remove(next);
-
-		/*
-		 * Reverse the order that that were queued in the timeout_q:
-		 * timeouts expiring on the same ticks are queued in the
-		 * reverse order, time-wise, that they are added to shorten the
-		 * amount of time with interrupts locked while walking the
-		 * timeout_q. By reversing the order _again_ when building the
-		 * expired queue, they end up being processed in the same order
-		 * they were added, time-wise.
-		 */
-		sys_dlist_prepend(&expired, next);
+		_timeout_q_remove(timeout);
+		_timeout_q_add_expired(&expired, timeout);
 
 		timeout->delta_ticks_from_prev = _EXPIRED;
 
 		irq_unlock(key);
 		key = irq_lock();
 
-		next = sys_dlist_peek_head(&_timeout_q);
-		timeout = (struct _timeout *)next;
+		timeout = _timeout_q_first();
 	}
 
 	irq_unlock(key);
@@ -288,50 +269,6 @@ static inline void handle_timeouts(s32_t ticks)
 	#define handle_timeouts(ticks) do { } while ((0))
 #endif
 
-#ifdef CONFIG_TIMESLICING
-s32_t _time_slice_elapsed;
-s32_t _time_slice_duration = CONFIG_TIMESLICE_SIZE;
-int  _time_slice_prio_ceiling = CONFIG_TIMESLICE_PRIORITY;
-
-/*
- * Always called from interrupt level, and always only from the system clock
- * interrupt, thus:
- * - _current does not have to be protected, since it only changes at thread
- *   level or when exiting a non-nested interrupt
- * - _time_slice_elapsed does not have to be protected, since it can only change
- *   in this function and at thread level
- * - _time_slice_duration does not have to be protected, since it can only
- *   change at thread level
- */
-static void handle_time_slicing(s32_t ticks)
-{
-#ifdef CONFIG_TICKLESS_KERNEL
-	next_ts = 0;
-#endif
-	if (!_is_thread_time_slicing(_current)) {
-		return;
-	}
-
-	_time_slice_elapsed += __ticks_to_ms(ticks);
-	if (_time_slice_elapsed >= _time_slice_duration) {
-
-		unsigned int key;
-
-		_time_slice_elapsed = 0;
-
-		key = irq_lock();
-		_move_thread_to_end_of_prio_q(_current);
-		irq_unlock(key);
-	}
-#ifdef CONFIG_TICKLESS_KERNEL
-	next_ts =
-	    _ms_to_ticks(_time_slice_duration - _time_slice_elapsed);
-#endif
-}
-#else
-#define handle_time_slicing(ticks) do { } while (0)
-#endif
-
 /**
  *
  * @brief Announce a tick to the kernel
@@ -354,17 +291,17 @@ void _nano_sys_clock_tick_announce(s32_t ticks)
 	_sys_clock_tick_count += ticks;
 	irq_unlock(key);
 #endif
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	/* do not let the cycle count of a long running thread wrap */
+	_thread_runtime_stats_tick();
+#endif
+	/* time slicing is handled as just yet another timeout */
 	handle_timeouts(ticks);
 
-	/* time slicing is basically handled like just yet another timeout */
-	handle_time_slicing(ticks);
-
 #ifdef CONFIG_TICKLESS_KERNEL
 	u32_t next_to = _get_next_timeout_expiry();
 
 	next_to = next_to == K_FOREVER ? 0 : next_to;
-	next_to = !next_to || (next_ts
-			       && next_to) > next_ts ? next_ts : next_to;
 
 	u32_t remaining = _get_remaining_program_time();
 
@@ -458,8 +458,15 @@ void _init_thread_base(struct _thread_base *thread_base, int priority,
 
 	thread_base->sched_locked = 0;
 
+#ifdef CONFIG_SCHED_DEADLINE
+	thread_base->prio_deadline = 0;
+	thread_base->pended_on = NULL;
+#endif
+
 	/* swap_data does not need to be initialized */
 
+	thread_base->pended_on_mutex = NULL;
+
 	_init_thread_timeout(thread_base);
 }
 
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Thread runtime statistics
+ *
+ * The architecture context switch code calls _thread_runtime_stats_switch()
+ * with interrupts locked, while _current is still the thread being switched
+ * out and _kernel.ready_q.cache is the thread being switched in.
+ *
+ * The cycles are counted with the 32-bit k_cycle_get_32(), which wraps: the
+ * system clock tick handler calls _thread_runtime_stats_tick() to account
+ * for the cycles the current thread ran so far, so that no more than a tick
+ * elapses between two readings for a thread that runs for a long time.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <ksched.h>
+#include <misc/stack.h>
+
+void _thread_runtime_stats_switch(void)
+{
+	struct k_thread *from = _current;
+	struct k_thread *to = _kernel.ready_q.cache;
+	u32_t now;
+
+	/* some architectures go through here even if no switch happens */
+	if (from == to) {
+		return;
+	}
+
+	now = k_cycle_get_32();
+
+	from->rt_stats.cycles += now - from->rt_stats.switched_in;
+	if (_is_thread_ready(from)) {
+		from->rt_stats.num_preemptions++;
+	}
+
+	to->rt_stats.switched_in = now;
+	to->rt_stats.num_switches++;
+}
+
+void _thread_runtime_stats_tick(void)
+{
+	unsigned int key = irq_lock();
+	u32_t now = k_cycle_get_32();
+
+	_current->rt_stats.cycles += now - _current->rt_stats.switched_in;
+	_current->rt_stats.switched_in = now;
+
+	irq_unlock(key);
+}
+
+void k_thread_runtime_stats_get(k_tid_t thread,
+				struct k_thread_runtime_stats *stats)
+{
+	unsigned int key = irq_lock();
+
+	stats->cycles = thread->rt_stats.cycles;
+	if (thread == _current) {
+		stats->cycles += k_cycle_get_32() -
+				 thread->rt_stats.switched_in;
+	}
+	stats->num_switches = thread->rt_stats.num_switches;
+	stats->num_preemptions = thread->rt_stats.num_preemptions;
+
+	irq_unlock(key);
+
+#if defined(CONFIG_THREAD_STACK_INFO)
+	stats->stack_size = thread->stack_info.size;
+#else
+	stats->stack_size = 0;
+#endif
+
+#if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_STACK_INFO)
+	stats->stack_max_used = stats->stack_size -
+		stack_unused_space_get((const char *)thread->stack_info.start,
+				       thread->stack_info.size);
+#else
+	stats->stack_max_used = 0;
+#endif
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief pairing heap backend of the timeout queue
+ *
+ * The timeout expiring the soonest is kept at the root of the heap. Each node
+ * links to its first child (heap_child) and to its next sibling (heap_next);
+ * heap_prev points to the previous sibling, or to the parent for a first
+ * child, so that any timeout can be unlinked in constant time when aborted.
+ *
+ * Inserting a timeout is O(1), removing one, be it the root when expiring or
+ * any other when aborted, is O(log n) amortized. All operations are done with
+ * interrupts locked and without recursion.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <wait_q.h>
+
+static inline int expires_before(struct _timeout *a, struct _timeout *b)
+{
+	/* tick count wraps around: compare the distance, not the values */
+	return (s32_t)(a->expiry - b->expiry) < 0;
+}
+
+/*
+ * Meld two heaps which roots have no sibling, and return the new root. On
+ * equal expiries, the first root stays on top, so that timeouts already
+ * queued are handled before the ones queued after them.
+ */
+static struct _timeout *meld(struct _timeout *a, struct _timeout *b)
+{
+	struct _timeout *tmp;
+
+	if (!a) {
+		return b;
+	}
+
+	if (!b) {
+		return a;
+	}
+
+	if (expires_before(b, a)) {
+		tmp = a;
+		a = b;
+		b = tmp;
+	}
+
+	b->heap_prev = a;
+	b->heap_next = a->heap_child;
+	if (a->heap_child) {
+		a->heap_child->heap_prev = b;
+	}
+	a->heap_child = b;
+
+	return a;
+}
+
+/*
+ * Standard two-pass pairing of a list of siblings: meld them by pairs from
+ * left to right, then meld the resulting heaps from right to left. The heaps
+ * from the first pass are stacked on their heap_next link, which reverses
+ * them, so that the second pass can walk them from the first one.
+ */
+static struct _timeout *merge_pairs(struct _timeout *first)
+{
+	struct _timeout *pairs = NULL;
+	struct _timeout *root = NULL;
+	struct _timeout *a, *b, *next;
+
+	while (first) {
+		a = first;
+		b = a->heap_next;
+		next = b ? b->heap_next : NULL;
+
+		a->heap_next = NULL;
+		a->heap_prev = NULL;
+		if (b) {
+			b->heap_next = NULL;
+			b->heap_prev = NULL;
+		}
+
+		a = meld(a, b);
+		a->heap_next = pairs;
+		pairs = a;
+
+		first = next;
+	}
+
+	while (pairs) {
+		next = pairs->heap_next;
+		pairs->heap_next = NULL;
+		root = meld(root, pairs);
+		pairs = next;
+	}
+
+	return root;
+}
+
+void _timeout_heap_insert(struct _timeout *timeout)
+{
+	timeout->heap_child = NULL;
+	timeout->heap_next = NULL;
+	timeout->heap_prev = NULL;
+
+	_timeout_q.root = meld(_timeout_q.root, timeout);
+}
+
+void _timeout_heap_remove(struct _timeout *timeout)
+{
+	struct _timeout *children = timeout->heap_child;
+
+	if (timeout == _timeout_q.root) {
+		_timeout_q.root = merge_pairs(children);
+	} else {
+		struct _timeout *prev = timeout->heap_prev;
+
+		/* unlink from the parent's list of children */
+		if (prev->heap_child == timeout) {
+			prev->heap_child = timeout->heap_next;
+		} else {
+			prev->heap_next = timeout->heap_next;
+		}
+
+		if (timeout->heap_next) {
+			timeout->heap_next->heap_prev = prev;
+		}
+
+		_timeout_q.root = meld(_timeout_q.root, merge_pairs(children));
+	}
+
+	timeout->heap_child = NULL;
+	timeout->heap_next = NULL;
+	timeout->heap_prev = NULL;
+}
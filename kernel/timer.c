@@ -208,19 +208,7 @@ s32_t _timeout_remaining_get(struct _timeout *timeout)
 	if (timeout->delta_ticks_from_prev == _INACTIVE) {
 		remaining_ticks = 0;
 	} else {
-		/*
-		 * compute remaining ticks by walking the timeout list
-		 * and summing up the various tick deltas involved
-		 */
-		struct _timeout *t =
-			(struct _timeout *)sys_dlist_peek_head(&_timeout_q);
-
-		remaining_ticks = t->delta_ticks_from_prev;
-		while (t != timeout) {
-			t = (struct _timeout *)sys_dlist_peek_next(&_timeout_q,
-								   &t->node);
-			remaining_ticks += t->delta_ticks_from_prev;
-		}
+		remaining_ticks = _timeout_ticks_left(timeout);
 	}
 
 	irq_unlock(key);
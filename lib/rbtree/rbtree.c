@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief red-black tree
+ *
+ * Classic red-black tree with parent links, where empty leaves are
+ * represented by NULL pointers and are black.
+ */
+
+#include <misc/rbtree.h>
+
+static inline int is_red(sys_rbnode_t *node)
+{
+	return node && node->red;
+}
+
+static sys_rbnode_t *subtree_min(sys_rbnode_t *node)
+{
+	while (node->left) {
+		node = node->left;
+	}
+
+	return node;
+}
+
+static sys_rbnode_t *subtree_max(sys_rbnode_t *node)
+{
+	while (node->right) {
+		node = node->right;
+	}
+
+	return node;
+}
+
+/* make 'new' take the place of 'old' in the link from old's parent */
+static void replace_child(sys_rbtree_t *tree, sys_rbnode_t *old,
+			  sys_rbnode_t *new)
+{
+	sys_rbnode_t *parent = old->parent;
+
+	if (!parent) {
+		tree->root = new;
+	} else if (parent->left == old) {
+		parent->left = new;
+	} else {
+		parent->right = new;
+	}
+
+	if (new) {
+		new->parent = parent;
+	}
+}
+
+static void rotate_left(sys_rbtree_t *tree, sys_rbnode_t *node)
+{
+	sys_rbnode_t *right = node->right;
+
+	node->right = right->left;
+	if (right->left) {
+		right->left->parent = node;
+	}
+
+	replace_child(tree, node, right);
+
+	right->left = node;
+	node->parent = right;
+}
+
+static void rotate_right(sys_rbtree_t *tree, sys_rbnode_t *node)
+{
+	sys_rbnode_t *left = node->left;
+
+	node->left = left->right;
+	if (left->right) {
+		left->right->parent = node;
+	}
+
+	replace_child(tree, node, left);
+
+	left->right = node;
+	node->parent = left;
+}
+
+static void insert_fixup(sys_rbtree_t *tree, sys_rbnode_t *node)
+{
+	sys_rbnode_t *parent, *grandparent, *uncle;
+
+	while (is_red(node->parent)) {
+		parent = node->parent;
+
+		/* the parent is red, thus not the root */
+		grandparent = parent->parent;
+
+		if (parent == grandparent->left) {
+			uncle = grandparent->right;
+
+			if (is_red(uncle)) {
+				parent->red = 0;
+				uncle->red = 0;
+				grandparent->red = 1;
+				node = grandparent;
+				continue;
+			}
+
+			if (node == parent->right) {
+				node = parent;
+				rotate_left(tree, node);
+				parent = node->parent;
+			}
+
+			parent->red = 0;
+			grandparent->red = 1;
+			rotate_right(tree, grandparent);
+		} else {
+			uncle = grandparent->left;
+
+			if (is_red(uncle)) {
+				parent->red = 0;
+				uncle->red = 0;
+				grandparent->red = 1;
+				node = grandparent;
+				continue;
+			}
+
+			if (node == parent->left) {
+				node = parent;
+				rotate_right(tree, node);
+				parent = node->parent;
+			}
+
+			parent->red = 0;
+			grandparent->red = 1;
+			rotate_left(tree, grandparent);
+		}
+	}
+
+	tree->root->red = 0;
+}
+
+void sys_rb_insert(sys_rbtree_t *tree, sys_rbnode_t *node)
+{
+	sys_rbnode_t *parent = NULL;
+	sys_rbnode_t *cur = tree->root;
+	int left = 0;
+
+	while (cur) {
+		parent = cur;
+		left = tree->lessthan(node, cur);
+		cur = left ? cur->left : cur->right;
+	}
+
+	node->parent = parent;
+	node->left = NULL;
+	node->right = NULL;
+	node->red = 1;
+
+	if (!parent) {
+		tree->root = node;
+	} else if (left) {
+		parent->left = node;
+	} else {
+		parent->right = node;
+	}
+
+	insert_fixup(tree, node);
+}
+
+/*
+ * Restore the tree properties after a black node was removed from under
+ * 'parent', 'node' (possibly NULL) being the child that took its place.
+ */
+static void remove_fixup(sys_rbtree_t *tree, sys_rbnode_t *node,
+			 sys_rbnode_t *parent)
+{
+	sys_rbnode_t *sibling;
+
+	while (node != tree->root && !is_red(node)) {
+
+		/*
+		 * the removed node was black: its sibling subtree had at least
+		 * one black node, thus the sibling exists
+		 */
+		if (node == parent->left) {
+			sibling = parent->right;
+
+			if (sibling->red) {
+				sibling->red = 0;
+				parent->red = 1;
+				rotate_left(tree, parent);
+				sibling = parent->right;
+			}
+
+			if (!is_red(sibling->left) && !is_red(sibling->right)) {
+				sibling->red = 1;
+				node = parent;
+				parent = node->parent;
+				continue;
+			}
+
+			if (!is_red(sibling->right)) {
+				sibling->left->red = 0;
+				sibling->red = 1;
+				rotate_right(tree, sibling);
+				sibling = parent->right;
+			}
+
+			sibling->red = parent->red;
+			parent->red = 0;
+			sibling->right->red = 0;
+			rotate_left(tree, parent);
+		} else {
+			sibling = parent->left;
+
+			if (sibling->red) {
+				sibling->red = 0;
+				parent->red = 1;
+				rotate_right(tree, parent);
+				sibling = parent->left;
+			}
+
+			if (!is_red(sibling->left) && !is_red(sibling->right)) {
+				sibling->red = 1;
+				node = parent;
+				parent = node->parent;
+				continue;
+			}
+
+			if (!is_red(sibling->left)) {
+				sibling->right->red = 0;
+				sibling->red = 1;
+				rotate_left(tree, sibling);
+				sibling = parent->left;
+			}
+
+			sibling->red = parent->red;
+			parent->red = 0;
+			sibling->left->red = 0;
+			rotate_right(tree, parent);
+		}
+
+		node = tree->root;
+	}
+
+	if (node) {
+		node->red = 0;
+	}
+}
+
+void sys_rb_remove(sys_rbtree_t *tree, sys_rbnode_t *node)
+{
+	sys_rbnode_t *child, *parent;
+	int removed_red;
+
+	if (!node->left || !node->right) {
+		child = node->left ? node->left : node->right;
+		parent = node->parent;
+		removed_red = node->red;
+
+		replace_child(tree, node, child);
+	} else {
+		/* swap in the successor, which has no left child */
+		sys_rbnode_t *next = subtree_min(node->right);
+
+		child = next->right;
+		removed_red = next->red;
+
+		if (next->parent == node) {
+			parent = next;
+		} else {
+			parent = next->parent;
+			replace_child(tree, next, child);
+			next->right = node->right;
+			next->right->parent = next;
+		}
+
+		replace_child(tree, node, next);
+		next->left = node->left;
+		next->left->parent = next;
+		next->red = node->red;
+	}
+
+	if (!removed_red) {
+		remove_fixup(tree, child, parent);
+	}
+
+	node->parent = NULL;
+	node->left = NULL;
+	node->right = NULL;
+}
+
+sys_rbnode_t *sys_rb_get_min(sys_rbtree_t *tree)
+{
+	return tree->root ? subtree_min(tree->root) : NULL;
+}
+
+sys_rbnode_t *sys_rb_get_max(sys_rbtree_t *tree)
+{
+	return tree->root ? subtree_max(tree->root) : NULL;
+}
+
+sys_rbnode_t *sys_rb_next(sys_rbnode_t *node)
+{
+	if (node->right) {
+		return subtree_min(node->right);
+	}
+
+	while (node->parent && node == node->parent->right) {
+		node = node->parent;
+	}
+
+	return node->parent;
+}
+
+sys_rbnode_t *sys_rb_prev(sys_rbnode_t *node)
+{
+	if (node->left) {
+		return subtree_max(node->left);
+	}
+
+	while (node->parent && node == node->parent->left) {
+		node = node->parent;
+	}
+
+	return node->parent;
+}
@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2017 Wind River Systems, Inc.
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Decode the records of the kernel event logger binary trace backend.
+
+The input is either the byte stream captured from the trace UART
+(CONFIG_KERNEL_EVENT_LOGGER_TRACE_UART), which may start in the middle of a
+record, or a dump of the sys_k_trace_dump[] RAM buffer
+(CONFIG_KERNEL_EVENT_LOGGER_TRACE_RAM), for instance obtained with:
+
+    (gdb) dump binary value trace.bin sys_k_trace_dump
+
+The records are converted to the Chrome trace event format, which can be
+loaded in chrome://tracing or other trace viewers, or printed as text. Each
+thread gets its own timeline, showing when it runs, and interrupts and other
+events are shown as instant events.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+RECORD_SIZE = 20
+
+CONTEXT_SWITCH_EVENT_ID = 1
+INTERRUPT_EVENT_ID = 2
+SLEEP_EVENT_ID = 3
+THREAD_EVENT_ID = 4
+
+THREAD_EVENTS = {0: "ready", 1: "pend", 2: "exit"}
+
+# pseudo thread IDs of the timelines not bound to a thread
+ISR_TID = 0
+KERNEL_TID = 1
+
+
+class Record:
+    def __init__(self, seq, timestamp, event_id, dropped, data):
+        self.seq = seq
+        self.timestamp = timestamp
+        self.event_id = event_id
+        self.dropped = dropped
+        self.data = data
+
+
+def unpack_records(data, offset, endian):
+    fmt = endian + "IIHHII"
+    records = []
+
+    for pos in range(offset, len(data) - RECORD_SIZE + 1, RECORD_SIZE):
+        seq, ts, event_id, dropped, d0, d1 = struct.unpack_from(fmt, data, pos)
+        records.append(Record(seq, ts, event_id, dropped, (d0, d1)))
+
+    return records
+
+
+def sync_stream(data, endian):
+    """Find where the first whole record starts in a UART capture: the
+    sequence numbers of consecutive records follow each other."""
+    for offset in range(RECORD_SIZE):
+        records = unpack_records(data[offset:offset + 3 * RECORD_SIZE], 0,
+                                 endian)
+        if len(records) < 2:
+            break
+        if all(b.seq == a.seq + 1 for a, b in zip(records, records[1:])):
+            return offset
+
+    sys.exit("cannot find the start of a record in the stream")
+
+
+def read_records(path, ram, endian):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if ram:
+        # circular buffer: unused records have a null sequence number
+        records = [r for r in unpack_records(data, 0, endian) if r.seq]
+        records.sort(key=lambda r: r.seq)
+    else:
+        records = unpack_records(data, sync_stream(data, endian), endian)
+
+    return records
+
+
+def unwrap_timestamps(records):
+    """Extend the 32-bit timestamps, assuming that consecutive events are
+    less than half a counter period apart. A timestamp slightly older than
+    the previous one, as with a custom timestamp source that is not
+    monotonic, is taken as such rather than as a counter wrap."""
+    prev = None
+    ext = 0
+
+    for r in records:
+        if prev is not None:
+            delta = (r.timestamp - prev) & 0xffffffff
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            ext += delta
+        prev = r.timestamp
+        r.time = ext
+
+
+def read_symbols(path):
+    """Read the output of nm, to name the threads after their k_thread."""
+    symbols = {}
+
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) == 3:
+                try:
+                    symbols[int(fields[0], 16)] = fields[2]
+                except ValueError:
+                    pass
+
+    return symbols
+
+
+def thread_name(symbols, thread):
+    return symbols.get(thread, "thread 0x%08x" % thread)
+
+
+def to_chrome(records, symbols, us_per_cycle):
+    events = []
+    threads = {}
+    running = None
+
+    def ts(r):
+        return r.time * us_per_cycle
+
+    def add_thread(thread):
+        if thread not in threads:
+            threads[thread] = thread_name(symbols, thread)
+
+    def instant(r, name, tid, args=None):
+        event = {"name": name, "ph": "i", "s": "t", "pid": 0, "tid": tid,
+                 "ts": ts(r)}
+        if args:
+            event["args"] = args
+        events.append(event)
+
+    for r in records:
+        if r.dropped:
+            instant(r, "dropped", KERNEL_TID, {"events": r.dropped})
+
+        if r.event_id == CONTEXT_SWITCH_EVENT_ID:
+            thread = r.data[0]
+            add_thread(thread)
+            if running is not None:
+                events.append({"name": "running", "ph": "E", "pid": 0,
+                               "tid": running, "ts": ts(r)})
+            events.append({"name": "running", "ph": "B", "pid": 0,
+                           "tid": thread, "ts": ts(r)})
+            running = thread
+        elif r.event_id == INTERRUPT_EVENT_ID:
+            instant(r, "irq %d" % r.data[0], ISR_TID)
+        elif r.event_id == SLEEP_EVENT_ID:
+            instant(r, "wake up", KERNEL_TID,
+                    {"ticks slept": r.data[0], "irq": r.data[1]})
+        elif r.event_id == THREAD_EVENT_ID:
+            add_thread(r.data[0])
+            instant(r, THREAD_EVENTS.get(r.data[1], str(r.data[1])),
+                    r.data[0])
+        else:
+            instant(r, "event %d" % r.event_id, KERNEL_TID,
+                    {"data": ["0x%08x" % d for d in r.data]})
+
+    if running is not None and records:
+        events.append({"name": "running", "ph": "E", "pid": 0,
+                       "tid": running, "ts": ts(records[-1])})
+
+    names = dict(threads)
+    names[ISR_TID] = "interrupts"
+    names[KERNEL_TID] = "kernel"
+    for tid, name in names.items():
+        events.append({"name": "thread_name", "ph": "M", "pid": 0,
+                       "tid": tid, "args": {"name": name}})
+
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def to_text(records, symbols, us_per_cycle, out):
+    for r in records:
+        if r.dropped:
+            out.write("%12.3f  dropped %d events\n" %
+                      (r.time * us_per_cycle, r.dropped))
+
+        if r.event_id == CONTEXT_SWITCH_EVENT_ID:
+            what = "switch to %s" % thread_name(symbols, r.data[0])
+        elif r.event_id == INTERRUPT_EVENT_ID:
+            what = "irq %d" % r.data[0]
+        elif r.event_id == SLEEP_EVENT_ID:
+            what = "wake up after %d ticks, irq %d" % r.data
+        elif r.event_id == THREAD_EVENT_ID:
+            what = "%s %s" % (thread_name(symbols, r.data[0]),
+                              THREAD_EVENTS.get(r.data[1], str(r.data[1])))
+        else:
+            what = "event %d: 0x%08x 0x%08x" % ((r.event_id,) + r.data)
+
+        out.write("%12.3f  %s\n" % (r.time * us_per_cycle, what))
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+
+    parser.add_argument("input", help="UART capture or RAM dump")
+    parser.add_argument("-o", "--output", help="output file (stdout)")
+    parser.add_argument("--ram", action="store_true",
+                        help="the input is a dump of sys_k_trace_dump[]")
+    parser.add_argument("--format", choices=["chrome", "text"],
+                        default="chrome", help="output format (chrome)")
+    parser.add_argument("--big-endian", action="store_true",
+                        help="the target is big-endian")
+    parser.add_argument("--clock-hz", type=int,
+                        help="timestamp frequency, to convert them to "
+                             "microseconds; they are shown as is otherwise")
+    parser.add_argument("--symbols",
+                        help="nm output of the ELF file, to name threads")
+
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+
+    records = read_records(args.input, args.ram,
+                           ">" if args.big_endian else "<")
+    unwrap_timestamps(records)
+
+    us_per_cycle = 1e6 / args.clock_hz if args.clock_hz else 1
+    symbols = read_symbols(args.symbols) if args.symbols else {}
+
+    out = open(args.output, "w") if args.output else sys.stdout
+
+    if args.format == "chrome":
+        json.dump(to_chrome(records, symbols, us_per_cycle), out, indent=1)
+        out.write("\n")
+    else:
+        to_text(records, symbols, us_per_cycle, out)
+
+
+if __name__ == "__main__":
+    main()
@@ -64,6 +64,44 @@ SYS_INIT(_sys_k_event_logger_init,
 sys_k_timer_func_t _sys_k_get_time = k_cycle_get_32;
 #endif /* CONFIG_KERNEL_EVENT_LOGGER_CUSTOM_TIMESTAMP */
 
+/*
+ * Timestamp of a predefined event. The trace ring takes its own, once the
+ * record is reserved, so that it is not read twice.
+ */
+static inline u32_t event_time(void)
+{
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_TRACE
+	return 0;
+#else
+	return _sys_k_get_time();
+#endif
+}
+
+/*
+ * Record a predefined event, which data starts with its timestamp, either in
+ * the event logger ring buffer or in the trace ring.
+ */
+static inline void put_event(u16_t event_id, u32_t *data, u8_t data_size)
+{
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_TRACE
+	_sys_k_trace_put(event_id, data_size > 1 ? data[1] : 0,
+			 data_size > 2 ? data[2] : 0);
+#else
+	sys_k_event_logger_put(event_id, data, data_size);
+#endif
+}
+
+/* events are dropped until the event logger ring buffer is initialized */
+static inline int logger_ready(void)
+{
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_TRACE
+	/* the trace ring is statically initialized */
+	return 1;
+#else
+	return sys_k_event_logger.ring_buf.buf != NULL;
+#endif
+}
+
 void sys_k_event_logger_put_timed(u16_t event_id)
 {
 	u32_t data[1];
@@ -93,7 +131,7 @@ void _sys_k_event_logger_context_switch(void)
 	}
 
 	/* if the kernel event logger has not been initialized, do nothing */
-	if (sys_k_event_logger.ring_buf.buf == NULL) {
+	if (!logger_ready()) {
 		return;
 	}
 
@@ -101,9 +139,14 @@ void _sys_k_event_logger_context_switch(void)
 		return;
 	}
 
-	data[0] = _sys_k_get_time();
+	data[0] = event_time();
 	data[1] = (u32_t)_kernel.current;
 
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_TRACE
+	/* writing to the trace ring never causes a context switch */
+	put_event(event_id, data, ARRAY_SIZE(data));
+#else
+
 	/*
 	 * The mechanism we use to log the kernel events uses a sync semaphore
 	 * to inform that there are available events to be collected. The
@@ -124,6 +167,7 @@ void _sys_k_event_logger_context_switch(void)
 	_sys_event_logger_put_non_preemptible(&sys_k_event_logger,
 		KERNEL_EVENT_LOGGER_CONTEXT_SWITCH_EVENT_ID, data,
 		ARRAY_SIZE(data));
+#endif
 }
 
 #define ASSERT_CURRENT_IS_COOP_THREAD() \
@@ -148,15 +192,15 @@ void _sys_k_event_logger_interrupt(void)
 	}
 
 	/* if the kernel event logger has not been initialized, we do nothing */
-	if (sys_k_event_logger.ring_buf.buf == NULL) {
+	if (!logger_ready()) {
 		return;
 	}
 
-	data[0] = _sys_k_get_time();
+	data[0] = event_time();
 	data[1] = _sys_current_irq_key_get();
 
-	sys_k_event_logger_put(KERNEL_EVENT_LOGGER_INTERRUPT_EVENT_ID, data,
-		ARRAY_SIZE(data));
+	put_event(KERNEL_EVENT_LOGGER_INTERRUPT_EVENT_ID, data,
+		  ARRAY_SIZE(data));
 }
 #endif /* CONFIG_KERNEL_EVENT_LOGGER_INTERRUPT */
 
@@ -180,7 +224,7 @@ void _sys_k_event_logger_exit_sleep(void)
 	}
 
 	if (_sys_k_event_logger_sleep_start_time != 0) {
-		data[0] = _sys_k_get_time();
+		data[0] = event_time();
 		data[1] = (k_cycle_get_32() - _sys_k_event_logger_sleep_start_time)
 			/ sys_clock_hw_cycles_per_tick;
 		/* register the cause of exiting sleep mode */
@@ -193,8 +237,8 @@ void _sys_k_event_logger_exit_sleep(void)
 		 */
 		_sys_k_event_logger_sleep_start_time = 0;
 
-		sys_k_event_logger_put(KERNEL_EVENT_LOGGER_SLEEP_EVENT_ID, data,
-			ARRAY_SIZE(data));
+		put_event(KERNEL_EVENT_LOGGER_SLEEP_EVENT_ID, data,
+			  ARRAY_SIZE(data));
 	}
 }
 #endif /* CONFIG_KERNEL_EVENT_LOGGER_SLEEP */
@@ -209,12 +253,11 @@ static void log_thread_event(enum sys_k_event_logger_thread_event event,
 		return;
 	}
 
-	data[0] = _sys_k_get_time();
+	data[0] = event_time();
 	data[1] = (u32_t)(thread ? thread : _kernel.current);
 	data[2] = (u32_t)event;
 
-	sys_k_event_logger_put(KERNEL_EVENT_LOGGER_THREAD_EVENT_ID, data,
-			       ARRAY_SIZE(data));
+	put_event(KERNEL_EVENT_LOGGER_THREAD_EVENT_ID, data, ARRAY_SIZE(data));
 }
 
 void _sys_k_event_logger_thread_ready(struct k_thread *thread)
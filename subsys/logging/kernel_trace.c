@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Binary trace backend of the kernel event logger.
+ *
+ * Events are written as fixed-size records in a ring indexed by two free
+ * running counters: head counts the records reserved, tail the records
+ * drained. A writer reserves a record by moving head forward with a
+ * compare-and-set, fills it, and sets its sequence number last: since writers
+ * can interrupt each other, a reserved record may not be complete yet, which
+ * the thread draining the ring tells by its sequence number. No interrupt
+ * locking is needed, hence the ring can be written from the context switch
+ * and interrupt entry hooks at little cost.
+ *
+ * There is a single ring, as the kernel runs on a single CPU.
+ */
+
+#include <kernel.h>
+#include <logging/kernel_event_logger.h>
+#include <atomic.h>
+#include <string.h>
+#include <device.h>
+#include <uart.h>
+
+#define NUM_RECORDS CONFIG_KERNEL_EVENT_LOGGER_TRACE_RECORDS
+
+#if (NUM_RECORDS & (NUM_RECORDS - 1)) != 0
+#error "CONFIG_KERNEL_EVENT_LOGGER_TRACE_RECORDS must be a power of two"
+#endif
+
+#define TRACE_THREAD_STACK_SIZE 512
+
+static struct sys_k_trace_record trace_ring[NUM_RECORDS];
+
+/* records reserved and records drained, never wrapped around the ring */
+static atomic_t trace_head;
+static volatile u32_t trace_tail;
+
+/* events dropped since the last record written */
+static atomic_t trace_dropped;
+
+void _sys_k_trace_put(u16_t event_id, u32_t data0, u32_t data1)
+{
+	struct sys_k_trace_record *rec;
+	atomic_val_t head, dropped;
+	u32_t timestamp;
+
+	/*
+	 * The timestamp is taken right before reserving the record: a writer
+	 * interrupting this one in between moves the head, so that the
+	 * reservation is retried with a new timestamp. The records are hence
+	 * timestamped in sequence order.
+	 */
+	do {
+		head = atomic_get(&trace_head);
+		if ((u32_t)head - trace_tail >= NUM_RECORDS) {
+			atomic_inc(&trace_dropped);
+			return;
+		}
+		timestamp = _sys_k_get_time();
+	} while (!atomic_cas(&trace_head, head, head + 1));
+
+	rec = &trace_ring[head & (NUM_RECORDS - 1)];
+
+	dropped = atomic_set(&trace_dropped, 0);
+
+	rec->timestamp = timestamp;
+	rec->event_id = event_id;
+	rec->dropped = dropped > 0xffff ? 0xffff : dropped;
+	rec->data[0] = data0;
+	rec->data[1] = data1;
+
+	/* the record must be complete before it can be seen as such */
+	compiler_barrier();
+	*(volatile u32_t *)&rec->seq = head + 1;
+}
+
+#ifdef CONFIG_KERNEL_EVENT_LOGGER_TRACE_UART
+static struct device *trace_uart;
+
+static void trace_output_init(void)
+{
+	trace_uart =
+		device_get_binding(CONFIG_KERNEL_EVENT_LOGGER_TRACE_UART_NAME);
+	__ASSERT(trace_uart, "no trace UART");
+}
+
+static void trace_output(struct sys_k_trace_record *rec)
+{
+	u8_t *byte = (u8_t *)rec;
+	int i;
+
+	for (i = 0; i < sizeof(*rec); i++) {
+		uart_poll_out(trace_uart, byte[i]);
+	}
+}
+#else
+struct sys_k_trace_record
+	sys_k_trace_dump[CONFIG_KERNEL_EVENT_LOGGER_TRACE_RAM_RECORDS];
+
+static u32_t trace_dump_index;
+
+static void trace_output_init(void)
+{
+}
+
+/* the records are sorted by their sequence number when decoded */
+static void trace_output(struct sys_k_trace_record *rec)
+{
+	memcpy(&sys_k_trace_dump[trace_dump_index], rec, sizeof(*rec));
+
+	if (++trace_dump_index == ARRAY_SIZE(sys_k_trace_dump)) {
+		trace_dump_index = 0;
+	}
+}
+#endif
+
+/* output the complete records, up to the first one being written */
+static void trace_drain(void)
+{
+	struct sys_k_trace_record rec;
+	u32_t tail = trace_tail;
+
+	while (tail != (u32_t)atomic_get(&trace_head)) {
+		memcpy(&rec, &trace_ring[tail & (NUM_RECORDS - 1)],
+		       sizeof(rec));
+		if (rec.seq != tail + 1) {
+			break;
+		}
+
+		/* the record must be copied before it can be reused */
+		compiler_barrier();
+		trace_tail = ++tail;
+
+		trace_output(&rec);
+	}
+}
+
+static void trace_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	trace_output_init();
+
+	for (;;) {
+		trace_drain();
+		k_sleep(CONFIG_KERNEL_EVENT_LOGGER_TRACE_PERIOD);
+	}
+}
+
+K_THREAD_DEFINE(_sys_k_trace_thread, TRACE_THREAD_STACK_SIZE, trace_thread,
+		NULL, NULL, NULL, CONFIG_KERNEL_EVENT_LOGGER_TRACE_THREAD_PRIORITY,
+		0, K_NO_WAIT);
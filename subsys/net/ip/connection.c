@@ -50,290 +50,106 @@ static struct net_conn conns[CONFIG_NET_MAX_CONN];
  */
 #define NET_CONN_HDR(pkt) ((struct net_udp_hdr *)(net_pkt_udp_data(pkt)))
 
-#if defined(CONFIG_NET_CONN_CACHE)
+#define NET_CONN_BUCKETS CONFIG_NET_CONN_HASH_BUCKETS
 
-/* Cache the connection so that we do not have to go
- * through the full list of connections when receiving
- * a network packet. The cache contains an index to
- * corresponding entry in conns array.
+#if (NET_CONN_BUCKETS & (NET_CONN_BUCKETS - 1)) != 0
+#error "CONFIG_NET_CONN_HASH_BUCKETS must be a power of two"
+#endif
+
+/* Connection handlers are hashed in one of two tables so that a received
+ * packet only needs to be compared against a few of them.
  *
- * Hash value is constructed like this:
+ * Handlers bound to a specific remote address, remote port and local port
+ * go to the connected table, hashed on these three and the protocol. Any
+ * of them outranks a handler with a wildcard remote address, so when the
+ * bucket of the packet holds a match, the lookup is done.
  *
- *   bit      description
- *   0  - 3   bits from remote port
- *   4  - 7   bits from local port
- *   8  - 18  bits from remote address
- *   19 - 29  bits from local address
- *   30       family
- *   31       protocol
- */
-struct conn_hash {
-	u32_t value;
-	s32_t idx;
-};
-
-struct conn_hash_neg {
-	u32_t value;
-};
-
-/** Connection cache */
-static struct conn_hash conn_cache[CONFIG_NET_MAX_CONN];
-
-/** Negative cache, we definitely do not have a connection
- * to these hosts.
+ * All the other handlers, the listeners, go to the listening table, hashed
+ * on the protocol and the local port only, which is zero when any local port
+ * matches. A packet is then compared against the two buckets of its
+ * destination port and of port zero.
  */
-static struct conn_hash_neg conn_cache_neg[CONFIG_NET_MAX_CONN];
+static sys_slist_t conn_connected[NET_CONN_BUCKETS];
+static sys_slist_t conn_listening[NET_CONN_BUCKETS];
 
-#define TAKE_BIT(val, bit, max, used)				\
-	(((val & BIT(bit)) >> bit) << (max - used))
+#define NET_RANK_CONNECTED (NET_RANK_REMOTE_SPEC_ADDR |		\
+			    NET_RANK_REMOTE_PORT |		\
+			    NET_RANK_LOCAL_PORT)
 
-static inline u8_t ports_to_hash(u16_t remote_port,
-				    u16_t local_port)
+static inline u32_t hash_mix(u32_t value)
 {
-	/* Note that we do not convert port value to network byte order */
-	return (remote_port & BIT(0)) |
-		((remote_port & BIT(4)) >> 3) |
-		((remote_port & BIT(8)) >> 6) |
-		((remote_port & BIT(15)) >> 12) |
-		(((local_port & BIT(0)) |
-		  ((local_port & BIT(4)) >> 3) |
-		  ((local_port & BIT(8)) >> 6) |
-		  ((local_port & BIT(15)) >> 12)) << 4);
-}
+	value ^= value >> 16;
+	value *= 0x45d9f3b;
+	value ^= value >> 16;
 
-static inline u16_t ipv6_to_hash(struct in6_addr *addr)
-{
-	/* There is 11 bits available for IPv6 address */
-	/* Use more bits from the lower part of address space */
-	return
-		/* Take 3 bits from higher values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[0]), 31, 11, 1) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[0]), 15, 11, 2) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[0]), 7, 11, 3) |
-
-		/* Take 2 bits from higher middle values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[1]), 31, 11, 4) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[1]), 15, 11, 5) |
-
-		/* Take 2 bits from lower middle values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[2]), 31, 11, 6) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[2]), 15, 11, 7) |
-
-		/* Take 4 bits from lower values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 31, 11, 8) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 15, 11, 9) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 7, 11, 10) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 0, 11, 11);
+	return value & (NET_CONN_BUCKETS - 1);
 }
 
-static inline u16_t ipv4_to_hash(struct in_addr *addr)
+/* Ports are hashed in network byte order, as found in the packet */
+static inline u32_t hash_ports(u8_t proto, u16_t remote_port,
+			       u16_t local_port)
 {
-	/* There is 11 bits available for IPv4 address */
-	/* Use more bits from the lower part of address space */
-	return
-		TAKE_BIT(addr->s_addr, 31, 11, 1) |
-		TAKE_BIT(addr->s_addr, 27, 11, 2) |
-		TAKE_BIT(addr->s_addr, 21, 11, 3) |
-		TAKE_BIT(addr->s_addr, 17, 11, 4) |
-		TAKE_BIT(addr->s_addr, 14, 11, 5) |
-		TAKE_BIT(addr->s_addr, 11, 11, 6) |
-		TAKE_BIT(addr->s_addr, 8, 11, 7) |
-		TAKE_BIT(addr->s_addr, 5, 11, 8) |
-		TAKE_BIT(addr->s_addr, 3, 11, 9) |
-		TAKE_BIT(addr->s_addr, 2, 11, 10) |
-		TAKE_BIT(addr->s_addr, 0, 11, 11);
+	return ((u32_t)remote_port << 16 | local_port) ^ proto;
 }
 
-/* Return either the first free position in the cache (idx < 0) or
- * the existing cached position (idx >= 0)
- */
-static s32_t check_hash(enum net_ip_protocol proto,
-			  sa_family_t family,
-			  void *remote_addr,
-			  void *local_addr,
-			  u16_t remote_port,
-			  u16_t local_port,
-			  u32_t *cache_value)
+static inline u32_t hash_addr(sa_family_t family, const void *addr)
 {
-	int i, free_pos = -1;
-	u32_t value = 0;
-
-	value = ports_to_hash(remote_port, local_port);
-
-#if defined(CONFIG_NET_UDP)
-	if (proto == IPPROTO_UDP) {
-		value |= BIT(31);
-	}
-#endif
-
-#if defined(CONFIG_NET_TCP)
-	if (proto == IPPROTO_TCP) {
-		value &= ~BIT(31);
-	}
-#endif
-
 #if defined(CONFIG_NET_IPV6)
 	if (family == AF_INET6) {
-		value |= BIT(30);
-		value |= ipv6_to_hash((struct in6_addr *)remote_addr) << 8;
-		value |= ipv6_to_hash((struct in6_addr *)local_addr) << 19;
-	}
-#endif
+		const struct in6_addr *addr6 = addr;
 
-#if defined(CONFIG_NET_IPV4)
-	if (family == AF_INET) {
-		value &= ~BIT(30);
-		value |= ipv4_to_hash((struct in_addr *)remote_addr) << 8;
-		value |= ipv4_to_hash((struct in_addr *)local_addr) << 19;
+		return UNALIGNED_GET(&addr6->s6_addr32[0]) ^
+			UNALIGNED_GET(&addr6->s6_addr32[1]) ^
+			UNALIGNED_GET(&addr6->s6_addr32[2]) ^
+			UNALIGNED_GET(&addr6->s6_addr32[3]);
 	}
 #endif
 
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		if (conn_cache[i].value == value) {
-			return i;
-		}
-
-		if (conn_cache[i].idx < 0 && free_pos < 0) {
-			free_pos = i;
-		}
-	}
-
-	if (free_pos >= 0) {
-		conn_cache[free_pos].value = value;
-		return free_pos;
-	}
-
-	*cache_value = value;
-
-	return -ENOENT;
-}
-
-static inline s32_t get_conn(enum net_ip_protocol proto,
-			       sa_family_t family,
-			       struct net_pkt *pkt,
-			       u32_t *cache_value)
-{
 #if defined(CONFIG_NET_IPV4)
 	if (family == AF_INET) {
-		return check_hash(proto, family,
-				  &NET_IPV4_HDR(pkt)->src,
-				  &NET_IPV4_HDR(pkt)->dst,
-				  NET_UDP_HDR(pkt)->src_port,
-				  NET_UDP_HDR(pkt)->dst_port,
-				  cache_value);
-	}
-#endif
-
-#if defined(CONFIG_NET_IPV6)
-	if (family == AF_INET6) {
-		return check_hash(proto, family,
-				  &NET_IPV6_HDR(pkt)->src,
-				  &NET_IPV6_HDR(pkt)->dst,
-				  NET_UDP_HDR(pkt)->src_port,
-				  NET_UDP_HDR(pkt)->dst_port,
-				  cache_value);
+		return UNALIGNED_GET(&((const struct in_addr *)addr)->s_addr);
 	}
 #endif
 
-	return -1;
-}
-
-static inline void cache_add_neg(u32_t cache_value)
-{
-	int i;
-
-	for (i = 0; i < CONFIG_NET_MAX_CONN && cache_value > 0; i++) {
-		if (conn_cache_neg[i].value) {
-			continue;
-		}
-
-		NET_DBG("Add to neg cache value 0x%x", cache_value);
-
-		conn_cache_neg[i].value = cache_value;
-		break;
-	}
+	return 0;
 }
 
-static inline bool cache_check_neg(u32_t cache_value)
+static inline sys_slist_t *connected_bucket(u8_t proto, sa_family_t family,
+					    const void *remote_addr,
+					    u16_t remote_port,
+					    u16_t local_port)
 {
-	int i;
-
-	for (i = 0; i < CONFIG_NET_MAX_CONN && cache_value > 0; i++) {
-		if (conn_cache_neg[i].value == cache_value) {
-			NET_DBG("Cache neg [%d] value 0x%x found",
-				i, cache_value);
-			return true;
-		}
-	}
-
-	return false;
+	return &conn_connected[hash_mix(hash_addr(family, remote_addr) ^
+					hash_ports(proto, remote_port,
+						   local_port))];
 }
 
-static void cache_clear(void)
+static inline sys_slist_t *listening_bucket(u8_t proto, u16_t local_port)
 {
-	int i;
-
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		conn_cache[i].idx = -1;
-		conn_cache_neg[i].value = 0;
-	}
+	return &conn_listening[hash_mix(hash_ports(proto, 0, local_port))];
 }
 
-static inline enum net_verdict cache_check(enum net_ip_protocol proto,
-					   struct net_pkt *pkt,
-					   u32_t *cache_value,
-					   s32_t *pos)
+static sys_slist_t *conn_bucket(struct net_conn *conn)
 {
-	*pos = get_conn(proto, net_pkt_family(pkt), pkt, cache_value);
-	if (*pos >= 0) {
-		if (conn_cache[*pos].idx >= 0) {
-			/* Connection is in the cache */
-			struct net_conn *conn;
-
-			conn = &conns[conn_cache[*pos].idx];
-
-			NET_DBG("Cache %s listener for pkt %p src port %u "
-				"dst port %u family %d cache[%d] 0x%x",
-				net_proto2str(proto), pkt,
-				ntohs(NET_CONN_HDR(pkt)->src_port),
-				ntohs(NET_CONN_HDR(pkt)->dst_port),
-				net_pkt_family(pkt), *pos,
-				conn_cache[*pos].value);
-
-			return conn->cb(conn, pkt, conn->user_data);
-		}
-	} else if (*cache_value > 0) {
-		if (cache_check_neg(*cache_value)) {
-			NET_DBG("Drop by cache");
-			return NET_DROP;
-		}
-	}
-
-	return NET_CONTINUE;
-}
+	u16_t local_port = net_sin(&conn->local_addr)->sin_port;
 
-static inline void cache_remove(struct net_conn *conn)
-{
-	int i;
+	if ((conn->rank & NET_RANK_CONNECTED) == NET_RANK_CONNECTED) {
+		const void *remote_addr;
 
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		if (conn_cache[i].idx < 0 ||
-		    conn_cache[i].idx >= CONFIG_NET_MAX_CONN) {
-			continue;
+		if (conn->remote_addr.family == AF_INET6) {
+			remote_addr = &net_sin6(&conn->remote_addr)->sin6_addr;
+		} else {
+			remote_addr = &net_sin(&conn->remote_addr)->sin_addr;
 		}
 
-		if (&conns[conn_cache[i].idx] == conn) {
-			conn_cache[i].idx = -1;
-			break;
-		}
+		return connected_bucket(conn->proto, conn->remote_addr.family,
+					remote_addr,
+					net_sin(&conn->remote_addr)->sin_port,
+					local_port);
 	}
+
+	return listening_bucket(conn->proto, local_port);
 }
-#else
-#define cache_clear(...)
-#define cache_add_neg(...)
-#define cache_check(...) NET_CONTINUE
-#define cache_remove(...)
-#endif /* CONFIG_NET_CONN_CACHE */
 
 int net_conn_unregister(struct net_conn_handle *handle)
 {
@@ -347,7 +163,7 @@ int net_conn_unregister(struct net_conn_handle *handle)
 		return -ENOENT;
 	}
 
-	cache_remove(conn);
+	sys_slist_find_and_remove(conn_bucket(conn), &conn->node);
 
 	NET_DBG("[%zu] connection handler %p removed",
 		(conn - conns) / sizeof(*conn), conn);
@@ -663,8 +479,7 @@ int net_conn_register(enum net_ip_protocol proto,
 		conns[i].rank = rank;
 		conns[i].proto = proto;
 
-		/* Cache needs to be cleared if new entries are added. */
-		cache_clear();
+		sys_slist_append(conn_bucket(&conns[i]), &conns[i].node);
 
 #if defined(CONFIG_NET_DEBUG_CONN)
 		do {
@@ -764,88 +579,145 @@ static inline void send_icmp_error(struct net_pkt *pkt)
 	}
 }
 
-enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
+static bool conn_match(struct net_conn *conn, enum net_ip_protocol proto,
+		       struct net_pkt *pkt)
 {
-	int i, best_match = -1;
-	s16_t best_rank = -1;
-	u16_t chksum;
-
-#if defined(CONFIG_NET_CONN_CACHE)
-	enum net_verdict verdict;
-	u32_t cache_value = 0;
-	s32_t pos;
+	if (conn->proto != proto) {
+		return false;
+	}
 
-	verdict = cache_check(proto, pkt, &cache_value, &pos);
-	if (verdict != NET_CONTINUE) {
-		return verdict;
+	if (net_sin(&conn->remote_addr)->sin_port) {
+		if (net_sin(&conn->remote_addr)->sin_port !=
+		    NET_CONN_HDR(pkt)->src_port) {
+			return false;
+		}
 	}
-#endif
 
-	if (proto == IPPROTO_TCP) {
-		chksum = NET_TCP_HDR(pkt)->chksum;
-	} else {
-		chksum = NET_UDP_HDR(pkt)->chksum;
+	if (net_sin(&conn->local_addr)->sin_port) {
+		if (net_sin(&conn->local_addr)->sin_port !=
+		    NET_CONN_HDR(pkt)->dst_port) {
+			return false;
+		}
 	}
 
-	if (IS_ENABLED(CONFIG_NET_DEBUG_CONN)) {
-		NET_DBG("Check %s listener for pkt %p src port %u dst port %u "
-			"family %d chksum 0x%04x", net_proto2str(proto), pkt,
-			ntohs(NET_CONN_HDR(pkt)->src_port),
-			ntohs(NET_CONN_HDR(pkt)->dst_port),
-			net_pkt_family(pkt), ntohs(chksum));
+	if (conn->flags & NET_CONN_REMOTE_ADDR_SET) {
+		if (!check_addr(pkt, &conn->remote_addr, true)) {
+			return false;
+		}
 	}
 
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		if (!(conns[i].flags & NET_CONN_IN_USE)) {
-			continue;
+	if (conn->flags & NET_CONN_LOCAL_ADDR_SET) {
+		if (!check_addr(pkt, &conn->local_addr, false)) {
+			return false;
 		}
+	}
 
-		if (conns[i].proto != proto) {
+	return true;
+}
+
+/* Return the matching handler of the bucket that is preferred to 'best'.
+ * A handler bound to a remote port, i.e. a connection accepted by a
+ * listener, is preferred to one that is not, and then the more specific
+ * handler is. Among equals, the one registered first is kept.
+ */
+static struct net_conn *bucket_match(sys_slist_t *bucket,
+				     enum net_ip_protocol proto,
+				     struct net_pkt *pkt,
+				     struct net_conn *best)
+{
+	struct net_conn *conn;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(bucket, conn, node) {
+		if (!conn_match(conn, proto, pkt)) {
 			continue;
 		}
 
-		if (net_sin(&conns[i].remote_addr)->sin_port) {
-			if (net_sin(&conns[i].remote_addr)->sin_port !=
-			    NET_CONN_HDR(pkt)->src_port) {
-				continue;
-			}
-		}
+		if (best) {
+			bool has_port = net_sin(&conn->remote_addr)->sin_port;
+			bool best_has_port =
+				net_sin(&best->remote_addr)->sin_port;
 
-		if (net_sin(&conns[i].local_addr)->sin_port) {
-			if (net_sin(&conns[i].local_addr)->sin_port !=
-			    NET_CONN_HDR(pkt)->dst_port) {
+			if (has_port != best_has_port) {
+				if (best_has_port) {
+					continue;
+				}
+			} else if (conn->rank <= best->rank) {
 				continue;
 			}
 		}
 
-		if (conns[i].flags & NET_CONN_REMOTE_ADDR_SET) {
-			if (!check_addr(pkt, &conns[i].remote_addr, true)) {
-				continue;
-			}
-		}
+		best = conn;
+	}
 
-		if (conns[i].flags & NET_CONN_LOCAL_ADDR_SET) {
-			if (!check_addr(pkt, &conns[i].local_addr, false)) {
-				continue;
-			}
-		}
+	return best;
+}
 
-		/* If we have an existing best_match, and that one
-		 * specifies a remote port, then we've matched to a
-		 * LISTENING connection that should not override.
-		 */
-		if (best_match >= 0 &&
-		    net_sin(&conns[best_match].remote_addr)->sin_port) {
-			continue;
-		}
+static struct net_conn *conn_lookup(enum net_ip_protocol proto,
+				    struct net_pkt *pkt)
+{
+	u16_t remote_port = NET_CONN_HDR(pkt)->src_port;
+	u16_t local_port = NET_CONN_HDR(pkt)->dst_port;
+	sa_family_t family = net_pkt_family(pkt);
+	struct net_conn *best = NULL;
+	sys_slist_t *bucket;
+	void *remote_addr = NULL;
 
-		if (best_rank < conns[i].rank) {
-			best_rank = conns[i].rank;
-			best_match = i;
+#if defined(CONFIG_NET_IPV6)
+	if (family == AF_INET6) {
+		remote_addr = &NET_IPV6_HDR(pkt)->src;
+	}
+#endif
+
+#if defined(CONFIG_NET_IPV4)
+	if (family == AF_INET) {
+		remote_addr = &NET_IPV4_HDR(pkt)->src;
+	}
+#endif
+
+	if (remote_addr) {
+		best = bucket_match(connected_bucket(proto, family,
+						     remote_addr,
+						     remote_port,
+						     local_port),
+				    proto, pkt, NULL);
+		if (best) {
+			return best;
 		}
 	}
 
-	if (best_match >= 0) {
+	bucket = listening_bucket(proto, local_port);
+	best = bucket_match(bucket, proto, pkt, NULL);
+
+	if (listening_bucket(proto, 0) != bucket) {
+		best = bucket_match(listening_bucket(proto, 0), proto, pkt,
+				    best);
+	}
+
+	return best;
+}
+
+enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
+{
+	struct net_conn *best_match;
+	u16_t chksum;
+
+	if (proto == IPPROTO_TCP) {
+		chksum = NET_TCP_HDR(pkt)->chksum;
+	} else {
+		chksum = NET_UDP_HDR(pkt)->chksum;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_DEBUG_CONN)) {
+		NET_DBG("Check %s listener for pkt %p src port %u dst port %u "
+			"family %d chksum 0x%04x", net_proto2str(proto), pkt,
+			ntohs(NET_CONN_HDR(pkt)->src_port),
+			ntohs(NET_CONN_HDR(pkt)->dst_port),
+			net_pkt_family(pkt), ntohs(chksum));
+	}
+
+	best_match = conn_lookup(proto, pkt);
+
+	if (best_match) {
 
 		/* If packet has a listener configured, then check also the
 		 * protocol checksum if that checking is enabled.
@@ -880,27 +752,14 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 			NET_TCP_HDR(pkt)->chksum = chksum;
 		}
 
-#if defined(CONFIG_NET_CONN_CACHE)
-		NET_DBG("[%d] match found cb %p ud %p rank 0x%02x cache 0x%x",
-			best_match,
-			conns[best_match].cb,
-			conns[best_match].user_data,
-			conns[best_match].rank,
-			pos < 0 ? 0 : conn_cache[pos].value);
-
-		if (pos >= 0) {
-			conn_cache[pos].idx = best_match;
-		}
-#else
 		NET_DBG("[%d] match found cb %p ud %p rank 0x%02x",
-			best_match,
-			conns[best_match].cb,
-			conns[best_match].user_data,
-			conns[best_match].rank);
-#endif /* CONFIG_NET_CONN_CACHE */
-
-		if (conns[best_match].cb(&conns[best_match], pkt,
-			     conns[best_match].user_data) == NET_DROP) {
+			(int)(best_match - conns),
+			best_match->cb,
+			best_match->user_data,
+			best_match->rank);
+
+		if (best_match->cb(best_match, pkt,
+				   best_match->user_data) == NET_DROP) {
 			goto drop;
 		}
 
@@ -911,8 +770,6 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 
 	NET_DBG("No match found.");
 
-	cache_add_neg(cache_value);
-
 #if defined(CONFIG_NET_IPV6)
 	/* If the destination address is multicast address,
 	 * we do not send ICMP error as that makes no sense.
@@ -957,13 +814,10 @@ void net_conn_foreach(net_conn_foreach_cb_t cb, void *user_data)
 
 void net_conn_init(void)
 {
-#if defined(CONFIG_NET_CONN_CACHE)
-	do {
-		int i;
+	int i;
 
-		for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-			conn_cache[i].idx = -1;
-		}
-	} while (0);
-#endif /* CONFIG_NET_CONN_CACHE */
+	for (i = 0; i < NET_CONN_BUCKETS; i++) {
+		sys_slist_init(&conn_connected[i]);
+		sys_slist_init(&conn_listening[i]);
+	}
 }
@@ -59,6 +59,27 @@ NET_NBR_TABLE_INIT(NET_NBR_GLOBAL,
 		   net_neighbor_pool,
 		   net_neighbor_table_clear);
 
+/* The neighbors are looked up by IPv6 address for every packet sent, so
+ * they are hashed on it. The neighbor found last is also remembered, as
+ * consecutive packets often go to the same neighbor.
+ */
+static sys_slist_t nbr_buckets[CONFIG_NET_IPV6_NBR_HASH_BUCKETS];
+static struct net_nbr *nbr_last_hit;
+
+static sys_slist_t *nbr_bucket(const struct in6_addr *addr)
+{
+	u32_t hash = UNALIGNED_GET(&addr->s6_addr32[0]) ^
+		UNALIGNED_GET(&addr->s6_addr32[1]) ^
+		UNALIGNED_GET(&addr->s6_addr32[2]) ^
+		UNALIGNED_GET(&addr->s6_addr32[3]);
+
+	hash ^= hash >> 16;
+	hash *= 0x45d9f3b;
+	hash ^= hash >> 16;
+
+	return &nbr_buckets[hash & (CONFIG_NET_IPV6_NBR_HASH_BUCKETS - 1)];
+}
+
 const char *net_ipv6_nbr_state2str(enum net_ipv6_nbr_state state)
 {
 	switch (state) {
@@ -113,17 +134,8 @@ static inline struct net_nbr *get_nbr(int idx)
 
 static inline struct net_nbr *get_nbr_from_data(struct net_ipv6_nbr_data *data)
 {
-	int i;
-
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-		struct net_nbr *nbr = get_nbr(i);
-
-		if (nbr->data == (u8_t *)data) {
-			return nbr;
-		}
-	}
-
-	return NULL;
+	/* The data is stored right after the neighbor */
+	return CONTAINER_OF((u8_t *)data, struct net_nbr, __nbr);
 }
 
 void net_ipv6_nbr_foreach(net_nbr_cb_t cb, void *user_data)
@@ -172,21 +184,23 @@ void nbr_print(void)
 #define nbr_print(...)
 #endif
 
-static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
-				  struct net_if *iface,
+static struct net_nbr *nbr_lookup(struct net_if *iface,
 				  struct in6_addr *addr)
 {
-	int i;
+	struct net_ipv6_nbr_data *data;
+	struct net_nbr *nbr = nbr_last_hit;
 
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-		struct net_nbr *nbr = get_nbr(i);
+	if (nbr && nbr->ref && nbr->iface == iface &&
+	    net_ipv6_addr_cmp(&net_ipv6_nbr_data(nbr)->addr, addr)) {
+		return nbr;
+	}
 
-		if (!nbr->ref) {
-			continue;
-		}
+	SYS_SLIST_FOR_EACH_CONTAINER(nbr_bucket(addr), data, node) {
+		nbr = get_nbr_from_data(data);
 
 		if (nbr->iface == iface &&
-		    net_ipv6_addr_cmp(&net_ipv6_nbr_data(nbr)->addr, addr)) {
+		    net_ipv6_addr_cmp(&data->addr, addr)) {
+			nbr_last_hit = nbr;
 			return nbr;
 		}
 	}
@@ -233,7 +247,7 @@ bool net_ipv6_nbr_rm(struct net_if *iface, struct in6_addr *addr)
 {
 	struct net_nbr *nbr;
 
-	nbr = nbr_lookup(&net_neighbor.table, iface, addr);
+	nbr = nbr_lookup(iface, addr);
 	if (!nbr) {
 		return false;
 	}
@@ -288,6 +302,7 @@ static void nbr_init(struct net_nbr *nbr, struct net_if *iface,
 	nbr->iface = iface;
 
 	net_ipaddr_copy(&net_ipv6_nbr_data(nbr)->addr, addr);
+	sys_slist_append(nbr_bucket(addr), &net_ipv6_nbr_data(nbr)->node);
 	ipv6_nbr_set_state(nbr, state);
 	net_ipv6_nbr_data(nbr)->is_router = is_router;
 	net_ipv6_nbr_data(nbr)->pending = NULL;
@@ -404,7 +419,7 @@ struct net_nbr *net_ipv6_nbr_add(struct net_if *iface,
 {
 	struct net_nbr *nbr;
 
-	nbr = nbr_lookup(&net_neighbor.table, iface, addr);
+	nbr = nbr_lookup(iface, addr);
 	if (!nbr) {
 		nbr = nbr_new(iface, addr, is_router, state);
 		if (!nbr) {
@@ -424,8 +439,8 @@ struct net_nbr *net_ipv6_nbr_add(struct net_if *iface,
 		if (memcmp(cached_lladdr->addr, lladdr->addr, lladdr->len)) {
 			dbg_update_neighbor_lladdr(lladdr, cached_lladdr, addr);
 
-			net_linkaddr_set(cached_lladdr, lladdr->addr,
-					 lladdr->len);
+			net_nbr_set_lladdr(nbr->idx, lladdr->addr,
+					   lladdr->len);
 
 			ipv6_nbr_set_state(nbr, NET_IPV6_NBR_STATE_STALE);
 		} else if (net_ipv6_nbr_data(nbr)->state ==
@@ -462,7 +477,15 @@ void net_neighbor_data_remove(struct net_nbr *nbr)
 {
 	NET_DBG("Neighbor %p removed", nbr);
 
-	return;
+	sys_slist_find_and_remove(nbr_bucket(&net_ipv6_nbr_data(nbr)->addr),
+				  &net_ipv6_nbr_data(nbr)->node);
+
+	/* Release the link layer address too, so that it can be reused */
+	net_nbr_unlink(nbr, NULL);
+
+	if (nbr_last_hit == nbr) {
+		nbr_last_hit = NULL;
+	}
 }
 
 void net_neighbor_table_clear(struct net_nbr_table *table)
@@ -940,7 +963,7 @@ struct net_pkt *net_ipv6_prepare_for_send(struct net_pkt *pkt)
 	}
 
 try_send:
-	nbr = nbr_lookup(&net_neighbor.table, net_pkt_iface(pkt), nexthop);
+	nbr = nbr_lookup(net_pkt_iface(pkt), nexthop);
 
 	NET_DBG("Neighbor lookup %p (%d) iface %p addr %s state %s", nbr,
 		nbr ? nbr->idx : NET_NBR_LLADDR_UNKNOWN,
@@ -1004,7 +1027,7 @@ try_send:
 struct net_nbr *net_ipv6_nbr_lookup(struct net_if *iface,
 				    struct in6_addr *addr)
 {
-	return nbr_lookup(&net_neighbor.table, iface, addr);
+	return nbr_lookup(iface, addr);
 }
 
 struct net_nbr *net_ipv6_get_nbr(struct net_if *iface, u8_t idx)
@@ -1451,7 +1474,7 @@ static inline bool handle_na_neighbor(struct net_pkt *pkt,
 
 	ARG_UNUSED(hdr);
 
-	nbr = nbr_lookup(&net_neighbor.table, net_pkt_iface(pkt),
+	nbr = nbr_lookup(net_pkt_iface(pkt),
 			 &NET_ICMPV6_NS_HDR(pkt)->tgt);
 
 	NET_DBG("Neighbor lookup %p iface %p addr %s", nbr,
@@ -1511,9 +1534,9 @@ static inline bool handle_na_neighbor(struct net_pkt *pkt,
 				cached_lladdr,
 				&NET_ICMPV6_NS_HDR(pkt)->tgt);
 
-			net_linkaddr_set(cached_lladdr,
-					 &tllao[NET_ICMPV6_OPT_DATA_OFFSET],
-					 cached_lladdr->len);
+			net_nbr_set_lladdr(nbr->idx,
+					   &tllao[NET_ICMPV6_OPT_DATA_OFFSET],
+					   cached_lladdr->len);
 		}
 
 		if (net_is_solicited(pkt)) {
@@ -1556,9 +1579,9 @@ static inline bool handle_na_neighbor(struct net_pkt *pkt,
 				cached_lladdr,
 				&NET_ICMPV6_NS_HDR(pkt)->tgt);
 
-			net_linkaddr_set(cached_lladdr,
-					 &tllao[NET_ICMPV6_OPT_DATA_OFFSET],
-					 cached_lladdr->len);
+			net_nbr_set_lladdr(nbr->idx,
+					   &tllao[NET_ICMPV6_OPT_DATA_OFFSET],
+					   cached_lladdr->len);
 		}
 
 		if (net_is_solicited(pkt)) {
@@ -1801,7 +1824,7 @@ int net_ipv6_send_ns(struct net_if *iface,
 	NET_ICMP_HDR(pkt)->chksum = 0;
 	NET_ICMP_HDR(pkt)->chksum = ~net_calc_chksum_icmpv6(pkt);
 
-	nbr = nbr_lookup(&net_neighbor.table, net_pkt_iface(pkt),
+	nbr = nbr_lookup(net_pkt_iface(pkt),
 			 &NET_ICMPV6_NS_HDR(pkt)->tgt);
 	if (!nbr) {
 		nbr_print();
@@ -79,6 +79,9 @@ const char *net_ipv6_nbr_state2str(enum net_ipv6_nbr_state state);
  * @brief IPv6 neighbor information.
  */
 struct net_ipv6_nbr_data {
+	/** Node in the hash bucket of the IPv6 address. */
+	sys_snode_t node;
+
 	/** Any pending packet waiting ND to finish. */
 	struct net_pkt *pending;
 
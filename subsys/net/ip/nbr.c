@@ -21,6 +21,45 @@
 
 NET_NBR_LLADDR_INIT(net_neighbor_lladdr, CONFIG_NET_IPV6_MAX_NEIGHBORS);
 
+#define NET_NBR_BUCKETS CONFIG_NET_IPV6_NBR_HASH_BUCKETS
+
+#if (NET_NBR_BUCKETS & (NET_NBR_BUCKETS - 1)) != 0
+#error "CONFIG_NET_IPV6_NBR_HASH_BUCKETS must be a power of two"
+#endif
+
+/* The link layer addresses in use are hashed, so that neither linking a
+ * neighbor nor looking one up by link layer address needs to compare the
+ * address with all the others.
+ */
+static sys_slist_t lladdr_buckets[NET_NBR_BUCKETS];
+
+static sys_slist_t *lladdr_bucket(const u8_t *addr, u8_t len)
+{
+	u32_t hash = 0x811c9dc5;
+	int i;
+
+	for (i = 0; i < len; i++) {
+		hash = (hash ^ addr[i]) * 0x01000193;
+	}
+
+	return &lladdr_buckets[hash & (NET_NBR_BUCKETS - 1)];
+}
+
+/* Return the index of the link layer address, or -ENOENT if unknown */
+static int lladdr_find(const u8_t *addr, u8_t len)
+{
+	struct net_nbr_lladdr *entry;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(lladdr_bucket(addr, len), entry, node) {
+		if (entry->lladdr.len == len &&
+		    !memcmp(entry->lladdr.addr, addr, len)) {
+			return entry - net_neighbor_lladdr;
+		}
+	}
+
+	return -ENOENT;
+}
+
 #if defined(CONFIG_NET_DEBUG_IPV6_NBR_CACHE)
 void net_nbr_unref_debug(struct net_nbr *nbr, const char *caller, int line)
 #define net_nbr_unref(nbr) net_nbr_unref_debug(nbr, __func__, __LINE__)
@@ -94,24 +133,24 @@ int net_nbr_link(struct net_nbr *nbr, struct net_if *iface,
 		return -EALREADY;
 	}
 
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-		if (avail < 0 && !net_neighbor_lladdr[i].ref) {
-			avail = i;
-		}
+	i = lladdr_find(lladdr->addr, lladdr->len);
+	if (i >= 0) {
+		/* We found same lladdr in nbr cache so just
+		 * increase the ref count.
+		 */
+		net_neighbor_lladdr[i].ref++;
+		net_neighbor_lladdr[i].nbr = nbr;
 
-		if (net_neighbor_lladdr[i].ref &&
-		    !memcmp(lladdr->addr,
-			    net_neighbor_lladdr[i].lladdr.addr,
-			    lladdr->len)) {
-			/* We found same lladdr in nbr cache so just
-			 * increase the ref count.
-			 */
-			net_neighbor_lladdr[i].ref++;
+		nbr->idx = i;
+		nbr->iface = iface;
 
-			nbr->idx = i;
-			nbr->iface = iface;
+		return 0;
+	}
 
-			return 0;
+	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
+		if (!net_neighbor_lladdr[i].ref) {
+			avail = i;
+			break;
 		}
 	}
 
@@ -123,12 +162,16 @@ int net_nbr_link(struct net_nbr *nbr, struct net_if *iface,
 	 * so allocate one for this lladdr.
 	 */
 	net_neighbor_lladdr[avail].ref++;
+	net_neighbor_lladdr[avail].nbr = nbr;
 	nbr->idx = avail;
 
 	net_linkaddr_set(&net_neighbor_lladdr[avail].lladdr, lladdr->addr,
 			 lladdr->len);
 	net_neighbor_lladdr[avail].lladdr.len = lladdr->len;
 
+	sys_slist_append(lladdr_bucket(lladdr->addr, lladdr->len),
+			 &net_neighbor_lladdr[avail].node);
+
 	nbr->iface = iface;
 
 	return 0;
@@ -147,7 +190,18 @@ int net_nbr_unlink(struct net_nbr *nbr, struct net_linkaddr *lladdr)
 
 	net_neighbor_lladdr[nbr->idx].ref--;
 
+	if (net_neighbor_lladdr[nbr->idx].nbr == nbr) {
+		net_neighbor_lladdr[nbr->idx].nbr = NULL;
+	}
+
 	if (!net_neighbor_lladdr[nbr->idx].ref) {
+		struct net_linkaddr_storage *storage =
+			&net_neighbor_lladdr[nbr->idx].lladdr;
+
+		sys_slist_find_and_remove(lladdr_bucket(storage->addr,
+							storage->len),
+					  &net_neighbor_lladdr[nbr->idx].node);
+
 		memset(net_neighbor_lladdr[nbr->idx].lladdr.addr, 0,
 		       sizeof(net_neighbor_lladdr[nbr->idx].lladdr.addr));
 	}
@@ -158,19 +212,48 @@ int net_nbr_unlink(struct net_nbr *nbr, struct net_linkaddr *lladdr)
 	return 0;
 }
 
+static bool nbr_in_table(struct net_nbr_table *table, struct net_nbr *nbr)
+{
+	struct net_nbr *start = table->nbr;
+	size_t len = (sizeof(struct net_nbr) + start->size +
+		      start->extra_data_size) * CONFIG_NET_IPV6_MAX_NEIGHBORS;
+
+	return (u8_t *)nbr >= (u8_t *)start &&
+		(u8_t *)nbr < (u8_t *)start + len;
+}
+
+static inline bool nbr_match(struct net_nbr *nbr, struct net_if *iface,
+			     int idx)
+{
+	return nbr->ref && nbr->iface == iface && nbr->idx == idx;
+}
+
 struct net_nbr *net_nbr_lookup(struct net_nbr_table *table,
 			       struct net_if *iface,
 			       struct net_linkaddr *lladdr)
 {
-	int i;
+	struct net_nbr *nbr;
+	int idx, i;
+
+	idx = lladdr_find(lladdr->addr, lladdr->len);
+	if (idx < 0) {
+		return NULL;
+	}
+
+	/* The address is most often linked to a single neighbor, the one
+	 * linked last. The table is only scanned when the address is shared
+	 * with another table or interface.
+	 */
+	nbr = net_neighbor_lladdr[idx].nbr;
+	if (nbr && nbr_in_table(table, nbr) && nbr_match(nbr, iface, idx)) {
+		return nbr;
+	}
 
 	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-		struct net_nbr *nbr = get_nbr(table->nbr, i);
+		nbr = get_nbr(table->nbr, i);
 
-		if (nbr->ref && nbr->iface == iface &&
-		    net_neighbor_lladdr[nbr->idx].ref &&
-		    !memcmp(net_neighbor_lladdr[nbr->idx].lladdr.addr,
-			    lladdr->addr, lladdr->len)) {
+		if (nbr_match(nbr, iface, idx)) {
+			net_neighbor_lladdr[idx].nbr = nbr;
 			return nbr;
 		}
 	}
@@ -178,6 +261,24 @@ struct net_nbr *net_nbr_lookup(struct net_nbr_table *table,
 	return NULL;
 }
 
+void net_nbr_set_lladdr(u8_t idx, u8_t *addr, u8_t len)
+{
+	struct net_nbr_lladdr *entry = &net_neighbor_lladdr[idx];
+
+	NET_ASSERT(idx < CONFIG_NET_IPV6_MAX_NEIGHBORS);
+	NET_ASSERT(entry->ref > 0);
+
+	sys_slist_find_and_remove(lladdr_bucket(entry->lladdr.addr,
+						entry->lladdr.len),
+				  &entry->node);
+
+	net_linkaddr_set(&entry->lladdr, addr, len);
+
+	sys_slist_append(lladdr_bucket(entry->lladdr.addr,
+				       entry->lladdr.len),
+			 &entry->node);
+}
+
 struct net_linkaddr_storage *net_nbr_get_lladdr(u8_t idx)
 {
 	NET_ASSERT_INFO(idx < CONFIG_NET_IPV6_MAX_NEIGHBORS,
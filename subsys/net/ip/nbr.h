@@ -13,6 +13,7 @@
 #include <stddef.h>
 #include <zephyr/types.h>
 #include <stdbool.h>
+#include <misc/slist.h>
 
 #include <net/net_if.h>
 
@@ -27,9 +28,17 @@ extern "C" {
  * neighboring tables.
  */
 struct net_nbr_lladdr {
+	/** Node in the hash bucket of the link layer address */
+	sys_snode_t node;
+
 	/** Link layer address */
 	struct net_linkaddr_storage lladdr;
 
+	/** Neighbor linked last to this address, checked first by
+	 * net_nbr_lookup().
+	 */
+	struct net_nbr *nbr;
+
 	/** Reference count. */
 	u8_t ref;
 };
@@ -184,6 +193,15 @@ int net_nbr_link(struct net_nbr *nbr, struct net_if *iface,
  */
 int net_nbr_unlink(struct net_nbr *nbr, struct net_linkaddr *lladdr);
 
+/**
+ * @brief Change the link layer address of a specific lladdr table index.
+ * All the neighbors linked to this index get the new address.
+ * @param idx Link layer address index in ll table.
+ * @param addr New link layer address
+ * @param len Length of the new link layer address
+ */
+void net_nbr_set_lladdr(u8_t idx, u8_t *addr, u8_t len);
+
 /**
  * @brief Return link address for a specific lladdr table index
  * @param idx Link layer address index in ll table.
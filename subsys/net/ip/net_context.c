@@ -709,10 +709,17 @@ static inline int send_control_segment(struct net_context *context,
 				       const struct sockaddr *remote,
 				       int flags, const char *msg)
 {
+	u8_t options[NET_TCP_SYN_OPT_SIZE];
+	u8_t optionlen = 0;
 	struct net_pkt *pkt = NULL;
 	int ret;
 
-	ret = net_tcp_prepare_segment(context->tcp, flags, NULL, 0,
+	if (flags & NET_TCP_SYN) {
+		net_tcp_set_syn_opt(context->tcp, options, &optionlen);
+	}
+
+	ret = net_tcp_prepare_segment(context->tcp, flags,
+				      optionlen ? options : NULL, optionlen,
 				      local, remote, &pkt);
 	if (ret) {
 		return ret;
@@ -821,10 +828,11 @@ NET_CONN_CB(tcp_established)
 
 	net_tcp_print_recv_info("DATA", pkt, NET_TCP_HDR(pkt)->src_port);
 
+	set_appdata_values(pkt, IPPROTO_TCP);
+
 	tcp_flags = NET_TCP_FLAGS(pkt);
 	if (tcp_flags & NET_TCP_ACK) {
-		net_tcp_ack_received(context,
-				     sys_get_be32(NET_TCP_HDR(pkt)->ack));
+		net_tcp_ack_received(context, pkt);
 	}
 
 	/*
@@ -866,18 +874,38 @@ NET_CONN_CB(tcp_established)
 	}
 
 	if (sys_get_be32(NET_TCP_HDR(pkt)->seq) - context->tcp->send_ack) {
-		/* Don't try to reorder packets.  If it doesn't
-		 * match the next segment exactly, drop and wait for
-		 * retransmit
+		/* A segment after a missing one is held until the missing
+		 * data is retransmitted. The duplicate ACK sent meanwhile
+		 * tells the peer about the loss, and about the segments
+		 * held in its SACK option.
 		 */
-		return NET_DROP;
+		if (!net_tcp_ooo_queue(context->tcp, pkt)) {
+			return NET_DROP;
+		}
+
+		send_ack(context, &conn->remote_addr, true);
+		return NET_OK;
 	}
 
-	set_appdata_values(pkt, IPPROTO_TCP);
 	context->tcp->send_ack += net_pkt_appdatalen(pkt);
 
 	ret = packet_received(conn, pkt, context->tcp->recv_user_data);
 
+	if (!(tcp_flags & NET_TCP_FIN)) {
+		struct net_pkt *ooo_pkt;
+
+		/* The segments held out of order may be in sequence now */
+		while ((ooo_pkt = net_tcp_ooo_next(context->tcp))) {
+			context->tcp->send_ack += net_pkt_appdatalen(ooo_pkt);
+
+			if (packet_received(conn, ooo_pkt,
+					    context->tcp->recv_user_data) ==
+			    NET_DROP) {
+				net_pkt_unref(ooo_pkt);
+			}
+		}
+	}
+
 	if (tcp_flags & NET_TCP_FIN) {
 		/* Sending an ACK in the CLOSE_WAIT state will transition to
 		 * LAST_ACK state
@@ -958,6 +986,8 @@ NET_CONN_CB(tcp_synack_received)
 		context->tcp->send_ack =
 			sys_get_be32(NET_TCP_HDR(pkt)->seq) + 1;
 		context->tcp->recv_max_ack = context->tcp->send_seq + 1;
+		context->tcp->send_wnd = sys_get_be16(NET_TCP_HDR(pkt)->wnd);
+		net_tcp_parse_syn_options(context->tcp, pkt);
 	}
 	/*
 	 * If we receive SYN, we send SYN-ACK and go to SYN_RCVD state.
@@ -1358,6 +1388,8 @@ NET_CONN_CB(tcp_syn_rcvd)
 		context->tcp->send_ack =
 			sys_get_be32(NET_TCP_HDR(pkt)->seq) + 1;
 		context->tcp->recv_max_ack = context->tcp->send_seq + 1;
+		context->tcp->send_wnd = sys_get_be16(NET_TCP_HDR(pkt)->wnd);
+		net_tcp_parse_syn_options(context->tcp, pkt);
 
 		pkt_get_sockaddr(net_context_get_family(context),
 				 pkt, &pkt_src_addr);
@@ -1431,6 +1463,8 @@ NET_CONN_CB(tcp_syn_rcvd)
 
 		net_tcp_print_recv_info("ACK", pkt, NET_TCP_HDR(pkt)->src_port);
 
+		tcp->send_wnd = sys_get_be16(NET_TCP_HDR(pkt)->wnd);
+
 		if (!context->tcp->accept_cb) {
 			NET_DBG("No accept callback, connection reset.");
 			goto reset;
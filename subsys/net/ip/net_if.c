@@ -36,6 +36,12 @@ extern struct net_if __net_if_end[];
 extern struct k_poll_event __net_if_event_start[];
 extern struct k_poll_event __net_if_event_stop[];
 
+/* TX queues of all the interfaces, watched by the TX thread */
+static struct k_poll_set tx_poll_set;
+
+/* ready TX queues handled per wakeup of the TX thread */
+#define TX_EVENTS_PER_WAKEUP 4
+
 static struct net_if_router routers[CONFIG_NET_MAX_ROUTERS];
 
 /* We keep track of the link callbacks in this list.
@@ -156,9 +162,12 @@ static void net_if_flush_tx(struct net_if *iface)
 	}
 }
 
-static void net_if_process_events(struct k_poll_event *event, int ev_count)
+static void net_if_process_events(struct k_poll_event **events, int ev_count)
 {
-	for (; ev_count; event++, ev_count--) {
+	for (; ev_count; events++, ev_count--) {
+		struct k_poll_event *event = *events;
+		int budget;
+
 		switch (event->state) {
 		case K_POLL_STATE_SIGNALED:
 			break;
@@ -168,7 +177,22 @@ static void net_if_process_events(struct k_poll_event *event, int ev_count)
 
 			iface = CONTAINER_OF(event->fifo, struct net_if,
 					     tx_queue);
-			net_if_tx(iface);
+
+			/* Events are edge-triggered: the queue is only
+			 * reported again once more packets are added to it,
+			 * or if it is added to the set again.
+			 */
+			for (budget = CONFIG_NET_TX_BUDGET; budget; budget--) {
+				if (!net_if_tx(iface)) {
+					break;
+				}
+			}
+
+			if (!budget) {
+				/* come back to the queue after the others */
+				k_poll_set_remove(&tx_poll_set, event);
+				k_poll_set_add(&tx_poll_set, event);
+			}
 
 			break;
 		}
@@ -180,20 +204,21 @@ static void net_if_process_events(struct k_poll_event *event, int ev_count)
 	}
 }
 
-static int net_if_prepare_events(void)
+static void net_if_prepare_events(void)
 {
 	struct net_if *iface;
 	int ev_count = 0;
 
+	k_poll_set_init(&tx_poll_set);
+
 	for (iface = __net_if_start; iface != __net_if_end; iface++) {
 		k_poll_event_init(&__net_if_event_start[ev_count],
 				  K_POLL_TYPE_FIFO_DATA_AVAILABLE,
 				  K_POLL_MODE_NOTIFY_ONLY,
 				  &iface->tx_queue);
+		k_poll_set_add(&tx_poll_set, &__net_if_event_start[ev_count]);
 		ev_count++;
 	}
-
-	return ev_count;
 }
 
 static void net_if_tx_thread(struct k_sem *startup_sync)
@@ -201,17 +226,21 @@ static void net_if_tx_thread(struct k_sem *startup_sync)
 	NET_DBG("Starting TX thread (stack %d bytes)",
 		CONFIG_NET_TX_STACK_SIZE);
 
+	/* The TX queues are registered once, and stay so */
+	net_if_prepare_events();
+
 	/* This will allow RX thread to start to receive data. */
 	k_sem_give(startup_sync);
 
 	while (1) {
+		struct k_poll_event *events[TX_EVENTS_PER_WAKEUP];
 		int ev_count;
 
-		ev_count = net_if_prepare_events();
-
-		k_poll(__net_if_event_start, ev_count, K_FOREVER);
-
-		net_if_process_events(__net_if_event_start, ev_count);
+		ev_count = k_poll_set_wait(&tx_poll_set, events,
+					   ARRAY_SIZE(events), K_FOREVER);
+		if (ev_count > 0) {
+			net_if_process_events(events, ev_count);
+		}
 
 		k_yield();
 	}
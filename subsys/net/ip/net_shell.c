@@ -402,6 +402,10 @@ static inline void net_shell_print_statistics(void)
 	printk("TCP conn drop  %d\tconnrst\t%d\n",
 	       GET_STAT(tcp.conndrop),
 	       GET_STAT(tcp.connrst));
+	printk("TCP seg ooo    %d\tmerged\t%d\tdrop\t%d\n",
+	       GET_STAT(tcp.ooo),
+	       GET_STAT(tcp.ooo_merged),
+	       GET_STAT(tcp.ooo_drop));
 #endif
 
 #if defined(CONFIG_NET_STATISTICS_RPL)
@@ -105,6 +105,10 @@ static inline void stats(void)
 		NET_INFO("TCP conn drop  %d\tconnrst\t%d",
 			 GET_STAT(tcp.conndrop),
 			 GET_STAT(tcp.connrst));
+		NET_INFO("TCP seg ooo    %d\tmerged\t%d\tdrop\t%d",
+			 GET_STAT(tcp.ooo),
+			 GET_STAT(tcp.ooo_merged),
+			 GET_STAT(tcp.ooo_drop));
 #endif
 
 #if defined(CONFIG_NET_STATISTICS_RPL)
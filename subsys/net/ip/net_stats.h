@@ -235,6 +235,21 @@ static inline void net_stats_update_tcp_seg_rexmit(void)
 {
 	net_stats.tcp.rexmit++;
 }
+
+static inline void net_stats_update_tcp_seg_ooo(void)
+{
+	net_stats.tcp.ooo++;
+}
+
+static inline void net_stats_update_tcp_seg_ooo_merged(void)
+{
+	net_stats.tcp.ooo_merged++;
+}
+
+static inline void net_stats_update_tcp_seg_ooo_drop(void)
+{
+	net_stats.tcp.ooo_drop++;
+}
 #else
 #define net_stats_update_tcp_sent(...)
 #define net_stats_update_tcp_resent(...)
@@ -249,6 +264,9 @@ static inline void net_stats_update_tcp_seg_rexmit(void)
 #define net_stats_update_tcp_seg_ackerr()
 #define net_stats_update_tcp_seg_rsterr()
 #define net_stats_update_tcp_seg_rexmit()
+#define net_stats_update_tcp_seg_ooo()
+#define net_stats_update_tcp_seg_ooo_merged()
+#define net_stats_update_tcp_seg_ooo_drop()
 #endif /* CONFIG_NET_STATISTICS_TCP */
 
 static inline void net_stats_update_per_proto_recv(enum net_ip_protocol proto)
@@ -18,6 +18,7 @@
 #include <limits.h>
 #include <zephyr/types.h>
 #include <misc/slist.h>
+#include <misc/dlist.h>
 
 #include <net/net_pkt.h>
 #include <net/net_core.h>
@@ -39,7 +40,24 @@
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
+
+#define NET_ROUTE_BUCKETS CONFIG_NET_ROUTE_HASH_BUCKETS
+
+#if (NET_ROUTE_BUCKETS & (NET_ROUTE_BUCKETS - 1)) != 0
+#error "CONFIG_NET_ROUTE_HASH_BUCKETS must be a power of two"
+#endif
+
+/* The routes are also hashed on their prefix, masked to the prefix length.
+ * A lookup masks the destination address to each prefix length in use,
+ * starting from the longest one, and searches the bucket of the masked
+ * address, so that it costs at most one bucket per prefix length instead
+ * of a scan of the whole routing table.
+ */
+static sys_slist_t route_buckets[NET_ROUTE_BUCKETS];
+
+/* Number of routes of each prefix length, from 0 to 128 */
+static u16_t prefix_len_routes[sizeof(struct in6_addr) * 8 + 1];
 
 static void net_route_nexthop_remove(struct net_nbr *nbr)
 {
@@ -256,36 +274,98 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+static sys_slist_t *prefix_bucket(const struct in6_addr *addr,
+				  u8_t prefix_len)
 {
-	struct net_route_entry *route, *found = NULL;
-	u8_t longest_match = 0;
+	u32_t hash = prefix_len;
 	int i;
 
-	for (i = 0; i < CONFIG_NET_MAX_ROUTES && longest_match < 128; i++) {
-		struct net_nbr *nbr = get_nbr(i);
+	for (i = 0; i < 4 && prefix_len; i++) {
+		u32_t word = UNALIGNED_GET(&addr->s6_addr32[i]);
 
-		if (!nbr->ref) {
-			continue;
+		if (prefix_len < 32) {
+			word &= htonl(~0U << (32 - prefix_len));
+			prefix_len = 0;
+		} else {
+			prefix_len -= 32;
 		}
 
-		if (iface && nbr->iface != iface) {
+		hash = (hash ^ word) * 0x01000193;
+	}
+
+	hash ^= hash >> 16;
+
+	return &route_buckets[hash & (NET_ROUTE_BUCKETS - 1)];
+}
+
+static void route_hash_add(struct net_route_entry *route)
+{
+	sys_slist_prepend(prefix_bucket(&route->addr, route->prefix_len),
+			  &route->hash_node);
+
+	prefix_len_routes[route->prefix_len]++;
+}
+
+static void route_hash_del(struct net_route_entry *route)
+{
+	if (sys_slist_find_and_remove(prefix_bucket(&route->addr,
+						    route->prefix_len),
+				      &route->hash_node)) {
+		prefix_len_routes[route->prefix_len]--;
+	}
+}
+
+/* Find the route with exactly this prefix */
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *addr,
+					  u8_t prefix_len)
+{
+	struct net_route_entry *route;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(prefix_bucket(addr, prefix_len), route,
+				     hash_node) {
+		if (route->prefix_len == prefix_len &&
+		    route->iface == iface &&
+		    net_is_ipv6_prefix((u8_t *)addr, (u8_t *)&route->addr,
+				       prefix_len)) {
+			return route;
+		}
+	}
+
+	return NULL;
+}
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *route, *found = NULL;
+	int len;
+
+	for (len = ARRAY_SIZE(prefix_len_routes) - 1; len >= 0 && !found;
+	     len--) {
+		if (!prefix_len_routes[len]) {
 			continue;
 		}
 
-		route = net_route_data(nbr);
+		SYS_SLIST_FOR_EACH_CONTAINER(prefix_bucket(dst, len), route,
+					     hash_node) {
+			if (route->prefix_len != len) {
+				continue;
+			}
 
-		if (route->prefix_len >= longest_match &&
-		    net_is_ipv6_prefix((u8_t *)dst,
-				       (u8_t *)&route->addr,
-				       route->prefix_len)) {
-			found = route;
-			longest_match = route->prefix_len;
+			if (iface && route->iface != iface) {
+				continue;
+			}
+
+			if (net_is_ipv6_prefix((u8_t *)dst,
+					       (u8_t *)&route->addr, len)) {
+				found = route;
+				break;
+			}
 		}
 	}
 
@@ -317,6 +397,11 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 		return NULL;
 	}
 
+	if (prefix_len >= ARRAY_SIZE(prefix_len_routes)) {
+		NET_DBG("Invalid prefix length %d", prefix_len);
+		return NULL;
+	}
+
 	nbr_nexthop = net_ipv6_nbr_lookup(iface, nexthop);
 	if (!nbr_nexthop) {
 		NET_DBG("No such neighbor %s found",
@@ -331,7 +416,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	NET_DBG("Nexthop %s lladdr is %s", net_sprint_ipv6_addr(nexthop),
 		net_sprint_ll_addr(nexthop_lladdr->addr, nexthop_lladdr->len));
 
-	route = net_route_lookup(iface, addr);
+	route = route_find(iface, addr, prefix_len);
 	if (route) {
 		/* Update nexthop if not the same */
 		struct in6_addr *nexthop_addr;
@@ -351,9 +436,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
-
-		sys_slist_find_and_remove(&routes, last);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -390,6 +473,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	tmp = get_nexthop_route();
 	if (!tmp) {
 		NET_ERR("No nexthop route available!");
+		nbr_free(nbr);
 		return NULL;
 	}
 
@@ -398,7 +482,8 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route = net_route_data(nbr);
 	route->iface = iface;
 
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_prepend(&routes, &route->node);
+	route_hash_add(route);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -425,13 +510,14 @@ int net_route_del(struct net_route_entry *route)
 		return -EINVAL;
 	}
 
-	sys_slist_find_and_remove(&routes, &route->node);
-
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
 		return -ENOENT;
 	}
 
+	sys_dlist_remove(&route->node);
+	route_hash_del(route);
+
 	net_route_info("Deleted", route, &route->addr);
 
 	net_mgmt_event_notify(NET_EVENT_IPV6_ROUTE_DEL, nbr->iface);
@@ -45,7 +45,14 @@
 #define NET_MAX_TCP_CONTEXT CONFIG_NET_MAX_CONTEXTS
 static struct net_tcp tcp_context[NET_MAX_TCP_CONTEXT];
 
+/* Retransmission timeout before the round trip time is measured, which is
+ * also the lowest one, and highest one after backing off.
+ */
 #define INIT_RETRY_MS 200
+#define MAX_RETRY_MS K_SECONDS(60)
+
+/* The window is not scaled, the congestion window is not opened further */
+#define MAX_CWND 0xffff
 
 /* 2MSL timeout, where "MSL" is arbitrarily 2 minutes in the RFC */
 #if defined(CONFIG_NET_TCP_2MSL_TIME)
@@ -120,7 +127,29 @@ static inline u32_t init_isn(void)
 
 static inline u32_t retry_timeout(const struct net_tcp *tcp)
 {
-	return ((u32_t)1 << tcp->retry_timeout_shift) * INIT_RETRY_MS;
+	return min((u64_t)tcp->rto << tcp->retry_timeout_shift, MAX_RETRY_MS);
+}
+
+static inline u32_t send_mss(const struct net_tcp *tcp)
+{
+	/* The MSS option of the peer is not parsed: assume it takes segments
+	 * as large as the ones we can receive.
+	 */
+	u16_t mss = net_tcp_get_recv_mss(tcp);
+
+	return mss ? mss : NET_TCP_DEFAULT_MSS;
+}
+
+static inline u32_t seg_seq(struct net_pkt *pkt)
+{
+	return sys_get_be32(NET_TCP_HDR(pkt)->seq);
+}
+
+static inline struct net_pkt *first_unacked(struct net_tcp *tcp)
+{
+	sys_snode_t *head = sys_slist_peek_head(&tcp->sent_list);
+
+	return head ? CONTAINER_OF(head, struct net_pkt, sent_list) : NULL;
 }
 
 #define is_6lo_technology(pkt)						    \
@@ -143,6 +172,18 @@ static inline void do_ref_if_needed(struct net_pkt *pkt)
 	}
 }
 
+static inline void unref_queued_pkt(struct net_pkt *pkt)
+{
+	/* A segment not sent yet also holds the reference to send it,
+	 * see do_ref_if_needed().
+	 */
+	if (!net_pkt_sent(pkt) && !is_6lo_technology(pkt)) {
+		net_pkt_unref(pkt);
+	}
+
+	net_pkt_unref(pkt);
+}
+
 static void abort_connection(struct net_tcp *tcp)
 {
 	struct net_context *ctx = tcp->context;
@@ -157,10 +198,77 @@ static void abort_connection(struct net_tcp *tcp)
 	net_context_unref(ctx);
 }
 
+/* Bytes sent and not acknowledged yet: the sent segments are always the
+ * first ones in sent_list.
+ */
+static u32_t flight_size(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+	u32_t flight = 0;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
+		if (!net_pkt_sent(pkt)) {
+			break;
+		}
+
+		flight += net_pkt_appdatalen(pkt);
+	}
+
+	return flight;
+}
+
+static void resend_first_unacked(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt = first_unacked(tcp);
+
+	if (!pkt) {
+		return;
+	}
+
+	/* Karn's algorithm: the round trip time of a segment sent again
+	 * cannot be told from the ACK, stop timing it.
+	 */
+	tcp->flags &= ~NET_TCP_RTT_TIMING;
+
+	/* A segment not sent yet already holds the reference to send it */
+	if (net_pkt_sent(pkt)) {
+		do_ref_if_needed(pkt);
+	}
+
+	if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
+		net_pkt_unref(pkt);
+	} else {
+		if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
+		    !is_6lo_technology(pkt)) {
+			net_stats_update_tcp_seg_rexmit();
+		}
+	}
+}
+
 static void tcp_retry_expired(struct k_timer *timer)
 {
 	struct net_tcp *tcp = CONTAINER_OF(timer, struct net_tcp, retry_timer);
-	struct net_pkt *pkt;
+	struct net_pkt *pkt, *first;
+	u32_t mss;
+
+	/* The peer closed its window and answers: the segment sent again
+	 * is a window probe (RFC 1122), and the connection must not be
+	 * aborted as long as the probes are acknowledged. Back off without
+	 * counting the probe as a retry.
+	 */
+	if (!tcp->send_wnd && (tcp->flags & NET_TCP_ZERO_WND_ACKED) &&
+	    !sys_slist_is_empty(&tcp->sent_list)) {
+		tcp->flags &= ~NET_TCP_ZERO_WND_ACKED;
+
+		if (tcp->retry_timeout_shift < CONFIG_NET_TCP_RETRY_COUNT &&
+		    retry_timeout(tcp) < MAX_RETRY_MS) {
+			tcp->retry_timeout_shift++;
+		}
+
+		k_timer_start(&tcp->retry_timer, retry_timeout(tcp), 0);
+		resend_first_unacked(tcp);
+		return;
+	}
 
 	/* Double the retry period for exponential backoff and resent
 	 * the first (only the first!) unack'd packet.
@@ -175,16 +283,30 @@ static void tcp_retry_expired(struct k_timer *timer)
 
 		k_timer_start(&tcp->retry_timer, retry_timeout(tcp), 0);
 
-		pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
-				   struct net_pkt, sent_list);
+		/* The loss is taken as a sign of heavy congestion
+		 * (RFC 5681): the window collapses to one segment and
+		 * the segments after the first one are sent again as
+		 * it opens up in slow start.
+		 */
+		mss = send_mss(tcp);
 
-		do_ref_if_needed(pkt);
-		if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
-			net_pkt_unref(pkt);
-		} else {
-			if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
-			    !is_6lo_technology(pkt)) {
-				net_stats_update_tcp_seg_rexmit();
+		if (!(tcp->flags & NET_TCP_RETRYING)) {
+			tcp->ssthresh = max(flight_size(tcp) / 2, 2 * mss);
+		}
+
+		tcp->cwnd = mss;
+		tcp->dup_acks = 0;
+		tcp->flags &= ~NET_TCP_FAST_RECOVERY;
+		tcp->flags |= NET_TCP_RETRYING;
+
+		resend_first_unacked(tcp);
+
+		first = first_unacked(tcp);
+
+		SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
+			if (pkt != first && net_pkt_sent(pkt)) {
+				do_ref_if_needed(pkt);
+				net_pkt_set_sent(pkt, false);
 			}
 		}
 	} else if (IS_ENABLED(CONFIG_NET_TCP_TIME_WAIT)) {
@@ -220,6 +342,9 @@ struct net_tcp *net_tcp_alloc(struct net_context *context)
 	tcp_context[i].send_seq = init_isn();
 	tcp_context[i].recv_max_ack = tcp_context[i].send_seq + 1u;
 
+	tcp_context[i].ssthresh = UINT_MAX;
+	tcp_context[i].rto = INIT_RETRY_MS;
+
 	tcp_context[i].accept_cb = NULL;
 
 	k_timer_init(&tcp_context[i].retry_timer, tcp_retry_expired, NULL);
@@ -241,6 +366,12 @@ int net_tcp_release(struct net_tcp *tcp)
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp->sent_list, pkt, tmp,
 					  sent_list) {
 		sys_slist_remove(&tcp->sent_list, NULL, &pkt->sent_list);
+		unref_queued_pkt(pkt);
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp->ooo_list, pkt, tmp,
+					  sent_list) {
+		sys_slist_remove(&tcp->ooo_list, NULL, &pkt->sent_list);
 		net_pkt_unref(pkt);
 	}
 
@@ -253,7 +384,7 @@ int net_tcp_release(struct net_tcp *tcp)
 	tcp->context = NULL;
 
 	key = irq_lock();
-	tcp->flags &= ~(NET_TCP_IN_USE | NET_TCP_RECV_MSS_SET);
+	tcp->flags &= ~NET_TCP_IN_USE;
 	irq_unlock(key);
 
 	NET_DBG("Disposed of TCP connection state");
@@ -551,24 +682,82 @@ u16_t net_tcp_get_recv_mss(const struct net_tcp *tcp)
 	return 0;
 }
 
-static void net_tcp_set_syn_opt(struct net_tcp *tcp, u8_t *options,
-				u8_t *optionlen)
+/* A SYN tells the MSS, which must be the same when it is sent again, and
+ * that SACK options are accepted (RFC 2018).
+ */
+void net_tcp_set_syn_opt(struct net_tcp *tcp, u8_t *options,
+			 u8_t *optionlen)
 {
-	u16_t recv_mss;
+	u16_t recv_mss = net_tcp_get_recv_mss(tcp);
 
 	*optionlen = 0;
 
-	if (!(tcp->flags & NET_TCP_RECV_MSS_SET)) {
-		recv_mss = net_tcp_get_recv_mss(tcp);
-		tcp->flags |= NET_TCP_RECV_MSS_SET;
-	} else {
-		recv_mss = 0;
+	if (recv_mss) {
+		UNALIGNED_PUT(htonl((u32_t)recv_mss | NET_TCP_MSS_HEADER),
+			      (u32_t *)(options + *optionlen));
+
+		*optionlen += NET_TCP_MSS_SIZE;
 	}
 
-	UNALIGNED_PUT(htonl((u32_t)recv_mss | NET_TCP_MSS_HEADER),
-		      (u32_t *)(options + *optionlen));
+	options[*optionlen] = NET_TCP_NOP_OPT;
+	options[*optionlen + 1] = NET_TCP_NOP_OPT;
+	options[*optionlen + 2] = NET_TCP_SACK_PERM_OPT;
+	options[*optionlen + 3] = 2;
 
-	*optionlen += NET_TCP_MSS_SIZE;
+	*optionlen += NET_TCP_SACK_PERM_SIZE;
+}
+
+/* The SACK option tells the peer about the segments held out of order. The
+ * first block holds the segment received last, as required by RFC 2018.
+ */
+static u8_t net_tcp_set_sack_opt(struct net_tcp *tcp, u8_t *options)
+{
+	u32_t blocks[CONFIG_NET_TCP_OOO_QUEUE_LEN][2];
+	struct net_pkt *pkt;
+	u8_t *opt = options + 4;
+	int count = 0, last = 0;
+	int i;
+
+	if (!tcp->sack_permitted || sys_slist_is_empty(&tcp->ooo_list)) {
+		return 0;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->ooo_list, pkt, sent_list) {
+		u32_t seq = seg_seq(pkt);
+
+		if (count && blocks[count - 1][1] == seq) {
+			blocks[count - 1][1] += net_pkt_appdatalen(pkt);
+		} else {
+			blocks[count][0] = seq;
+			blocks[count][1] = seq + net_pkt_appdatalen(pkt);
+			count++;
+		}
+
+		if (seq == tcp->ooo_last) {
+			last = count - 1;
+		}
+	}
+
+	UNALIGNED_PUT(htonl(blocks[last][0]), (u32_t *)opt);
+	UNALIGNED_PUT(htonl(blocks[last][1]), (u32_t *)(opt + 4));
+	opt += 8;
+
+	for (i = 0; i < count && opt < options + NET_TCP_MAX_OPT_SIZE; i++) {
+		if (i == last) {
+			continue;
+		}
+
+		UNALIGNED_PUT(htonl(blocks[i][0]), (u32_t *)opt);
+		UNALIGNED_PUT(htonl(blocks[i][1]), (u32_t *)(opt + 4));
+		opt += 8;
+	}
+
+	options[0] = NET_TCP_NOP_OPT;
+	options[1] = NET_TCP_NOP_OPT;
+	options[2] = NET_TCP_SACK_OPT;
+	options[3] = opt - options - 2;
+
+	return opt - options;
 }
 
 int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
@@ -599,8 +788,11 @@ int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
 		return net_tcp_prepare_segment(tcp, NET_TCP_FIN | NET_TCP_ACK,
 					       0, 0, NULL, remote, pkt);
 	default:
-		return net_tcp_prepare_segment(tcp, NET_TCP_ACK, 0, 0, NULL,
-					       remote, pkt);
+		optionlen = net_tcp_set_sack_opt(tcp, options);
+
+		return net_tcp_prepare_segment(tcp, NET_TCP_ACK,
+					       optionlen ? options : NULL,
+					       optionlen, NULL, remote, pkt);
 	}
 
 	return -EINVAL;
@@ -671,11 +863,10 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 	size_t data_len = net_pkt_get_len(pkt);
 	int ret;
 
-	/* Set PSH on all packets, our window is so small that there's
-	 * no point in the remote side trying to finesse things and
-	 * coalesce packets.
+	/* PSH is set when the segment is sent, if it is the last one
+	 * sent in a row.
 	 */
-	ret = net_tcp_prepare_segment(context->tcp, NET_TCP_PSH | NET_TCP_ACK,
+	ret = net_tcp_prepare_segment(context->tcp, NET_TCP_ACK,
 				      NULL, 0, NULL, &conn->remote_addr, &pkt);
 	if (ret) {
 		return ret;
@@ -718,6 +909,12 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 		ctx->tcp->fin_sent = 1;
 	}
 
+	/* The ACK number and the flags may have changed since the segment
+	 * was prepared.
+	 */
+	tcphdr->chksum = 0;
+	tcphdr->chksum = ~net_calc_chksum_tcp(pkt);
+
 	ctx->tcp->sent_ack = ctx->tcp->send_ack;
 
 	net_pkt_set_sent(pkt, true);
@@ -787,7 +984,6 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 static void restart_timer(struct net_tcp *tcp)
 {
 	if (!sys_slist_is_empty(&tcp->sent_list)) {
-		tcp->flags |= NET_TCP_RETRYING;
 		tcp->retry_timeout_shift = 0;
 		k_timer_start(&tcp->retry_timer, retry_timeout(tcp), 0);
 	} else if (IS_ENABLED(CONFIG_NET_TCP_TIME_WAIT)) {
@@ -800,44 +996,211 @@ static void restart_timer(struct net_tcp *tcp)
 		}
 	} else {
 		k_timer_stop(&tcp->retry_timer);
-		tcp->flags &= ~NET_TCP_RETRYING;
 	}
 }
 
+/* Can the segment be sent within the window starting at 'una'? A segment
+ * larger than the window is sent alone, not to stall the connection.
+ */
+static inline bool in_window(struct net_pkt *pkt, u32_t una, u32_t wnd)
+{
+	u32_t end = seg_seq(pkt) + net_pkt_appdatalen(pkt);
+
+	return end - una <= wnd || (seg_seq(pkt) == una && wnd);
+}
+
 int net_tcp_send_data(struct net_context *context)
 {
-	struct net_pkt *pkt;
+	struct net_tcp *tcp = context->tcp;
+	struct net_pkt *pkt, *next;
+	u32_t una, wnd;
+
+	pkt = first_unacked(tcp);
+	if (!pkt) {
+		return 0;
+	}
 
-	/* For now, just send all queued data synchronously.  Need to
-	 * add window handling and retry/ACK logic.
+	if (!tcp->cwnd) {
+		u32_t mss = send_mss(tcp);
+
+		/* Initial window, RFC 3390 */
+		tcp->cwnd = min(4 * mss, max(2 * mss, 4380));
+	}
+
+	/* Send the queued segments which fit in the usable window, the
+	 * smallest of the congestion window and of the window advertised
+	 * by the peer, from the first unacknowledged byte.
 	 */
-	SYS_SLIST_FOR_EACH_CONTAINER(&context->tcp->sent_list, pkt, sent_list) {
-		if (!net_pkt_sent(pkt)) {
-			if (net_tcp_send_pkt(pkt) < 0 &&
-			    !is_6lo_technology(pkt)) {
-				net_pkt_unref(pkt);
-			}
+	una = seg_seq(pkt);
+	wnd = min(tcp->cwnd, tcp->send_wnd);
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp->sent_list, pkt, next,
+					  sent_list) {
+		if (net_pkt_sent(pkt)) {
+			continue;
+		}
+
+		if (!in_window(pkt, una, wnd)) {
+			break;
+		}
+
+		if (!next || !in_window(next, una, wnd)) {
+			NET_TCP_HDR(pkt)->flags |= NET_TCP_PSH;
+		}
+
+		if (!(tcp->flags & (NET_TCP_RTT_TIMING | NET_TCP_RETRYING))) {
+			tcp->rtt_seq = seg_seq(pkt) + net_pkt_appdatalen(pkt);
+			tcp->rtt_time = k_uptime_get_32();
+			tcp->flags |= NET_TCP_RTT_TIMING;
+		}
+
+		if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
+			net_pkt_unref(pkt);
 		}
 	}
 
 	return 0;
 }
 
-void net_tcp_ack_received(struct net_context *ctx, u32_t ack)
+/* Update the retransmission timeout from the round trip time of the segment
+ * being timed, once it is acknowledged, as in RFC 6298.
+ */
+static void update_rto(struct net_tcp *tcp, u32_t ack)
+{
+	s32_t rtt, delta;
+
+	if (!(tcp->flags & NET_TCP_RTT_TIMING) ||
+	    net_tcp_seq_greater(tcp->rtt_seq, ack)) {
+		return;
+	}
+
+	tcp->flags &= ~NET_TCP_RTT_TIMING;
+
+	rtt = k_uptime_get_32() - tcp->rtt_time;
+
+	if (!tcp->srtt) {
+		tcp->srtt = rtt << 3;
+		tcp->rttvar = rtt << 1;
+	} else {
+		/* srtt += (rtt - srtt) / 8 and
+		 * rttvar += (|rtt - srtt| - rttvar) / 4, on scaled values
+		 */
+		delta = rtt - (tcp->srtt >> 3);
+		tcp->srtt += delta;
+
+		if (delta < 0) {
+			delta = -delta;
+		}
+
+		tcp->rttvar += delta - (tcp->rttvar >> 2);
+	}
+
+	/* rto = srtt + 4 * rttvar */
+	tcp->rto = (tcp->srtt >> 3) + tcp->rttvar;
+	tcp->rto = max(tcp->rto, INIT_RETRY_MS);
+	tcp->rto = min(tcp->rto, MAX_RETRY_MS);
+}
+
+/* Open the congestion window as new data gets acknowledged (RFC 5681), or
+ * go on with the fast recovery (RFC 6582).
+ */
+static void new_data_acked(struct net_tcp *tcp, u32_t ack, u32_t acked)
+{
+	u32_t mss = send_mss(tcp);
+
+	if (tcp->flags & NET_TCP_FAST_RECOVERY) {
+		if (!net_tcp_seq_greater(tcp->recover, ack)) {
+			/* Everything sent before the loss is acknowledged */
+			tcp->flags &= ~NET_TCP_FAST_RECOVERY;
+			tcp->cwnd = tcp->ssthresh;
+		} else {
+			/* Partial ACK: the next segment was lost too.
+			 * Deflate the window by the data acknowledged.
+			 */
+			resend_first_unacked(tcp);
+			tcp->cwnd -= min(tcp->cwnd, acked);
+			tcp->cwnd += mss;
+		}
+
+		return;
+	}
+
+	if (tcp->cwnd < tcp->ssthresh) {
+		/* Slow start */
+		tcp->cwnd += min(acked, mss);
+	} else {
+		/* Congestion avoidance, about one MSS per round trip */
+		tcp->cwnd += max(mss * mss / tcp->cwnd, 1);
+	}
+
+	tcp->cwnd = min(tcp->cwnd, MAX_CWND);
+}
+
+/* Fast retransmit on the third duplicate ACK and fast recovery (RFC 6582) */
+static void dup_ack_received(struct net_tcp *tcp)
+{
+	u32_t mss = send_mss(tcp);
+	u32_t flight;
+
+	if (tcp->dup_acks < 0xff) {
+		tcp->dup_acks++;
+	}
+
+	if (tcp->flags & NET_TCP_FAST_RECOVERY) {
+		/* Each duplicate ACK tells that a segment left the
+		 * network, inflate the window accordingly.
+		 */
+		tcp->cwnd = min(tcp->cwnd + mss, MAX_CWND + 3 * mss);
+		return;
+	}
+
+	if (tcp->dup_acks != 3) {
+		return;
+	}
+
+	flight = flight_size(tcp);
+
+	tcp->ssthresh = max(flight / 2, 2 * mss);
+	tcp->recover = seg_seq(first_unacked(tcp)) + flight;
+	tcp->cwnd = tcp->ssthresh + 3 * mss;
+	tcp->flags |= NET_TCP_FAST_RECOVERY;
+
+	resend_first_unacked(tcp);
+}
+
+void net_tcp_ack_received(struct net_context *ctx, struct net_pkt *ack_pkt)
 {
 	struct net_tcp *tcp = ctx->tcp;
 	sys_slist_t *list = &ctx->tcp->sent_list;
 	sys_snode_t *head;
 	struct net_pkt *pkt;
 	struct net_tcp_hdr *tcphdr;
-	u32_t seq;
+	u32_t ack = sys_get_be32(NET_TCP_HDR(ack_pkt)->ack);
+	u16_t wnd = sys_get_be16(NET_TCP_HDR(ack_pkt)->wnd);
+	u32_t seq, acked = 0;
 	bool valid_ack = false;
+	bool old_ack = false;
 
 	if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
 	    sys_slist_is_empty(list)) {
 		net_stats_update_tcp_seg_ackerr();
 	}
 
+	pkt = first_unacked(tcp);
+	if (pkt && net_tcp_seq_greater(seg_seq(pkt), ack)) {
+		old_ack = true;
+	}
+
+	/* A duplicate ACK acknowledges nothing new and updates nothing, but
+	 * tells that the peer got a segment after a missing one. An ACK
+	 * closing the window tells nothing about losses.
+	 */
+	if (pkt && net_pkt_sent(pkt) && seg_seq(pkt) == ack &&
+	    wnd && wnd == tcp->send_wnd && !net_pkt_appdatalen(ack_pkt) &&
+	    !(NET_TCP_FLAGS(ack_pkt) & (NET_TCP_SYN | NET_TCP_FIN))) {
+		dup_ack_received(tcp);
+	}
+
 	while (!sys_slist_is_empty(list)) {
 		head = sys_slist_peek_head(list);
 		pkt = CONTAINER_OF(head, struct net_pkt, sent_list);
@@ -860,12 +1223,29 @@ void net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 			}
 		}
 
+		acked += net_pkt_appdatalen(pkt);
+
 		sys_slist_remove(list, NULL, head);
-		net_pkt_unref(pkt);
+		unref_queued_pkt(pkt);
 		valid_ack = true;
 	}
 
+	/* Older ACKs may carry an outdated window */
+	if (!old_ack) {
+		tcp->send_wnd = wnd;
+
+		if (!wnd) {
+			tcp->flags |= NET_TCP_ZERO_WND_ACKED;
+		}
+	}
+
 	if (valid_ack) {
+		update_rto(tcp, ack);
+		new_data_acked(tcp, ack, acked);
+
+		tcp->dup_acks = 0;
+		tcp->flags &= ~NET_TCP_RETRYING;
+
 		/* Restart the timer on a valid inbound ACK.  This
 		 * isn't quite the same behavior as per-packet retry
 		 * timers, but is close in practice (it starts retries
@@ -874,25 +1254,112 @@ void net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 		 * sent times.
 		 */
 		restart_timer(ctx->tcp);
+	}
 
-		/* And, if we had been retrying, mark all packets
-		 * untransmitted and then resend them.  The stalled
-		 * pipe is uncorked again.
-		 */
-		if (ctx->tcp->flags & NET_TCP_RETRYING) {
-			struct net_pkt *pkt;
-
-			SYS_SLIST_FOR_EACH_CONTAINER(&ctx->tcp->sent_list, pkt,
-						     sent_list) {
-				if (net_pkt_sent(pkt)) {
-					do_ref_if_needed(pkt);
-					net_pkt_set_sent(pkt, false);
-				}
-			}
+	/* The window may have opened up */
+	net_tcp_send_data(ctx);
+}
 
-			net_tcp_send_data(ctx);
+void net_tcp_parse_syn_options(struct net_tcp *tcp, struct net_pkt *pkt)
+{
+	struct net_tcp_hdr *tcphdr = NET_TCP_HDR(pkt);
+	u8_t *opt = tcphdr->optdata;
+	u8_t *end = (u8_t *)tcphdr + 4 * (tcphdr->offset >> 4);
+
+	tcp->sack_permitted = 0;
+
+	while (opt < end && *opt != NET_TCP_END_OPT) {
+		if (*opt == NET_TCP_NOP_OPT) {
+			opt++;
+			continue;
 		}
+
+		if (opt + 1 >= end || opt[1] < 2 || opt + opt[1] > end) {
+			NET_DBG("Invalid option length");
+			break;
+		}
+
+		if (*opt == NET_TCP_SACK_PERM_OPT) {
+			tcp->sack_permitted = 1;
+		}
+
+		opt += opt[1];
+	}
+}
+
+bool net_tcp_ooo_queue(struct net_tcp *tcp, struct net_pkt *pkt)
+{
+	sys_snode_t *prev = NULL;
+	struct net_pkt *tmp;
+	u32_t seq = seg_seq(pkt);
+	u32_t end = seq + net_pkt_appdatalen(pkt);
+	int count = 0;
+
+	if (!net_pkt_appdatalen(pkt) ||
+	    (NET_TCP_FLAGS(pkt) & (NET_TCP_SYN | NET_TCP_FIN | NET_TCP_RST)) ||
+	    !net_tcp_seq_greater(seq, tcp->send_ack) ||
+	    end - tcp->send_ack > get_recv_wnd(tcp)) {
+		return false;
 	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->ooo_list, tmp, sent_list) {
+		u32_t tmp_seq = seg_seq(tmp);
+
+		if (net_tcp_seq_greater(end, tmp_seq) &&
+		    net_tcp_seq_greater(tmp_seq + net_pkt_appdatalen(tmp),
+					seq)) {
+			/* Already held, or overlapping a held segment */
+			net_stats_update_tcp_seg_ooo_drop();
+			return false;
+		}
+
+		if (net_tcp_seq_greater(seq, tmp_seq)) {
+			prev = &tmp->sent_list;
+		}
+
+		count++;
+	}
+
+	if (count >= CONFIG_NET_TCP_OOO_QUEUE_LEN) {
+		net_stats_update_tcp_seg_ooo_drop();
+		return false;
+	}
+
+	sys_slist_insert(&tcp->ooo_list, prev, &pkt->sent_list);
+	tcp->ooo_last = seq;
+
+	net_stats_update_tcp_seg_ooo();
+
+	return true;
+}
+
+struct net_pkt *net_tcp_ooo_next(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+	sys_snode_t *head;
+
+	while ((head = sys_slist_peek_head(&tcp->ooo_list))) {
+		pkt = CONTAINER_OF(head, struct net_pkt, sent_list);
+
+		if (net_tcp_seq_greater(seg_seq(pkt), tcp->send_ack)) {
+			return NULL;
+		}
+
+		sys_slist_remove(&tcp->ooo_list, NULL, head);
+
+		if (seg_seq(pkt) == tcp->send_ack) {
+			net_stats_update_tcp_seg_ooo_merged();
+			return pkt;
+		}
+
+		/* Received again in the meantime, maybe as part of a larger
+		 * segment.
+		 */
+		net_stats_update_tcp_seg_ooo_drop();
+		net_pkt_unref(pkt);
+	}
+
+	return NULL;
 }
 
 void net_tcp_init(void)
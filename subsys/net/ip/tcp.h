@@ -41,8 +41,14 @@ extern "C" {
 /** A retransmitted packet has been sent and not yet ack'd */
 #define NET_TCP_RETRYING BIT(4)
 
-/** MSS option has been set already */
-#define NET_TCP_RECV_MSS_SET BIT(5)
+/** The peer answered with a zero window since the last retry */
+#define NET_TCP_ZERO_WND_ACKED BIT(5)
+
+/** The round trip time of a sent segment is being measured */
+#define NET_TCP_RTT_TIMING BIT(6)
+
+/** Fast recovery after a fast retransmit is in progress */
+#define NET_TCP_FAST_RECOVERY BIT(7)
 
 /*
  * TCP connection states
@@ -78,14 +84,30 @@ enum net_tcp_state {
 /* Maximal value of the sequence number */
 #define NET_TCP_MAX_SEQ   0xffffffff
 
-#define NET_TCP_MAX_OPT_SIZE  8
+/* Max SACK blocks sent, the most recent first (RFC 2018) */
+#define NET_TCP_SACK_MAX_BLOCKS 3
+
+/* Fits the SACK option, with two NOPs to align it */
+#define NET_TCP_MAX_OPT_SIZE  (4 + 8 * NET_TCP_SACK_MAX_BLOCKS)
+
+/* Fits the MSS option, and the SACK permitted one with two NOPs to align it */
+#define NET_TCP_SYN_OPT_SIZE  (NET_TCP_MSS_SIZE + NET_TCP_SACK_PERM_SIZE)
 
 #define NET_TCP_MSS_HEADER    0x02040000 /* MSS option */
 #define NET_TCP_WINDOW_HEADER 0x30300    /* Window scale option */
 
 #define NET_TCP_MSS_SIZE      4          /* MSS option size */
+#define NET_TCP_SACK_PERM_SIZE 4         /* SACK permitted option size */
 #define NET_TCP_WINDOW_SIZE   3          /* Window scale option size */
 
+#define NET_TCP_END_OPT       0          /* End of option list */
+#define NET_TCP_NOP_OPT       1          /* No operation option */
+#define NET_TCP_SACK_PERM_OPT 4          /* SACK permitted option */
+#define NET_TCP_SACK_OPT      5          /* SACK option */
+
+/* Default MSS, when it cannot be deduced from the interface MTU */
+#define NET_TCP_DEFAULT_MSS 536
+
 /* Max received bytes to buffer internally */
 #define NET_TCP_BUF_MAX_LEN 1280
 
@@ -110,6 +132,14 @@ struct net_tcp {
 	/** List pointer used for TCP retransmit buffering */
 	sys_slist_t sent_list;
 
+	/** Received segments held until the missing ones before them
+	 * arrive, sorted by sequence number
+	 */
+	sys_slist_t ooo_list;
+
+	/** Sequence number of the last segment held out of order */
+	u32_t ooo_last;
+
 	/** Max acknowledgment. */
 	u32_t recv_max_ack;
 
@@ -122,6 +152,33 @@ struct net_tcp {
 	/** Last ACK value sent */
 	u32_t sent_ack;
 
+	/** Send window advertised by the peer */
+	u32_t send_wnd;
+
+	/** Congestion window, in bytes, 0 until the first segment is sent */
+	u32_t cwnd;
+
+	/** Slow start threshold, in bytes */
+	u32_t ssthresh;
+
+	/** Highest sequence number sent when fast recovery started */
+	u32_t recover;
+
+	/** Smoothed round trip time, in milliseconds, scaled by 8 */
+	u32_t srtt;
+
+	/** Round trip time variation, in milliseconds, scaled by 4 */
+	u32_t rttvar;
+
+	/** Retransmission timeout, in milliseconds */
+	u32_t rto;
+
+	/** Sequence number ending the segment being timed */
+	u32_t rtt_seq;
+
+	/** Uptime when the segment being timed was sent */
+	u32_t rtt_time;
+
 	/** Current retransmit period */
 	u32_t retry_timeout_shift : 5;
 	/** Flags for the TCP */
@@ -137,8 +194,12 @@ struct net_tcp {
 	 * of various timing issues when timer is scheduled to run.
 	 */
 	u32_t ack_timer_cancelled : 1;
+	/** Duplicate ACKs received in a row */
+	u32_t dup_acks : 8;
+	/** The peer accepts SACK options */
+	u32_t sack_permitted : 1;
 	/** Remaining bits in this u32_t */
-	u32_t _padding : 12;
+	u32_t _padding : 3;
 
 	/** Accept callback to be called when the connection has been
 	 * established.
@@ -312,10 +373,59 @@ int net_tcp_send_pkt(struct net_pkt *pkt);
 /**
  * @brief Handle a received TCP ACK
  *
- * @param cts Context
- * @param seq Received ACK sequence number
+ * Releases the acknowledged segments, updates the send and congestion
+ * windows and sends the queued segments that fit in them.
+ *
+ * @param ctx Context
+ * @param pkt Received segment, with its application data set
+ */
+void net_tcp_ack_received(struct net_context *ctx, struct net_pkt *pkt);
+
+/**
+ * @brief Set the options sent with a SYN segment
+ *
+ * @param tcp TCP context
+ * @param options Buffer of NET_TCP_SYN_OPT_SIZE bytes for the options
+ * @param optionlen Set to the length of the options
+ */
+void net_tcp_set_syn_opt(struct net_tcp *tcp, u8_t *options,
+			 u8_t *optionlen);
+
+/**
+ * @brief Parse the options of a received SYN segment
+ *
+ * @param tcp TCP context
+ * @param pkt Received SYN segment
+ */
+void net_tcp_parse_syn_options(struct net_tcp *tcp, struct net_pkt *pkt);
+
+/**
+ * @brief Hold a received segment which is not the next one expected,
+ *        until the missing data arrives.
+ *
+ * The segment is kept as is, without copying its data. Only segments
+ * carrying data within the receive window are held, up to
+ * CONFIG_NET_TCP_OOO_QUEUE_LEN of them.
+ *
+ * @param tcp TCP context
+ * @param pkt Received segment, with its application data set
+ *
+ * @return true if the segment is held, false if it is to be dropped
+ */
+bool net_tcp_ooo_queue(struct net_tcp *tcp, struct net_pkt *pkt);
+
+/**
+ * @brief Get the held segment which is next in sequence, if any
+ *
+ * Held segments whose data has been received again in the meantime are
+ * dropped.
+ *
+ * @param tcp TCP context
+ *
+ * @return Segment starting at the next sequence number expected,
+ *         NULL if the data is still missing.
  */
-void net_tcp_ack_received(struct net_context *ctx, u32_t ack);
+struct net_pkt *net_tcp_ooo_next(struct net_tcp *tcp);
 
 /**
  * @brief Calculates and returns the MSS for a given TCP context
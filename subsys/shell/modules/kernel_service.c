@@ -8,6 +8,7 @@
 #include <shell/shell.h>
 #include <init.h>
 #include <debug/object_tracing.h>
+#include <string.h>
 
 #define SHELL_KERNEL "kernel"
 
@@ -76,6 +77,99 @@ static int shell_cmd_stack(int argc, char *argv[])
 }
 #endif
 
+#if defined(CONFIG_MEM_ALLOC_STATS)
+static void print_alloc_stats(struct k_mem_alloc_stats *stats)
+{
+	printk("    used %u, max %u, allocs %u, frees %u, failures %u\n",
+	       stats->used, stats->max_used, stats->num_allocs,
+	       stats->num_frees, stats->num_failures);
+	printk("    waits %u, wait time %u ms\n",
+	       stats->num_waits, stats->wait_time);
+}
+
+static int shell_cmd_mem(int argc, char *argv[])
+{
+	extern struct k_mem_slab _k_mem_slab_list_start[];
+	extern struct k_mem_slab _k_mem_slab_list_end[];
+	extern struct k_mem_pool _k_mem_pool_list_start[];
+	extern struct k_mem_pool _k_mem_pool_list_end[];
+	struct k_mem_alloc_stats stats;
+	struct k_mem_slab *slab;
+	struct k_mem_pool *pool;
+	int reset = argc > 1 && !strcmp(argv[1], "reset");
+
+#if defined(CONFIG_OBJECT_TRACING)
+	/* includes the slabs initialized at run time */
+	for (slab = SYS_TRACING_HEAD(struct k_mem_slab, k_mem_slab);
+	     slab != NULL;
+	     slab = SYS_TRACING_NEXT(struct k_mem_slab, k_mem_slab, slab)) {
+#else
+	for (slab = _k_mem_slab_list_start; slab < _k_mem_slab_list_end;
+	     slab++) {
+#endif
+		k_mem_slab_stats_get(slab, &stats);
+		printk("slab %p: %u blocks of %zu bytes, usage in blocks\n",
+		       slab, slab->num_blocks, slab->block_size);
+		print_alloc_stats(&stats);
+		if (reset) {
+			k_mem_slab_stats_reset(slab);
+		}
+	}
+
+	for (pool = _k_mem_pool_list_start; pool < _k_mem_pool_list_end;
+	     pool++) {
+		k_mem_pool_stats_get(pool, &stats);
+		printk("pool %p: %u blocks of %zu bytes, usage in bytes\n",
+		       pool, pool->n_max, pool->max_sz);
+		print_alloc_stats(&stats);
+		if (reset) {
+			k_mem_pool_stats_reset(pool);
+		}
+	}
+
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+static int shell_cmd_threads(int argc, char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+	struct k_thread_runtime_stats stats;
+	struct k_thread *thread;
+	u64_t total = 0;
+
+	for (thread = SYS_THREAD_MONITOR_HEAD; thread != NULL;
+	     thread = SYS_THREAD_MONITOR_NEXT(thread)) {
+		k_thread_runtime_stats_get(thread, &stats);
+		total += stats.cycles;
+	}
+
+	if (total == 0) {
+		total = 1;
+	}
+
+	printk("threads:\n");
+
+	for (thread = SYS_THREAD_MONITOR_HEAD; thread != NULL;
+	     thread = SYS_THREAD_MONITOR_NEXT(thread)) {
+		k_thread_runtime_stats_get(thread, &stats);
+		printk("%s%p: priority %d, runtime %u ms (%u%%)\n",
+		       (thread == k_current_get()) ? "*" : " ", thread,
+		       k_thread_priority_get(thread),
+		       (u32_t)(stats.cycles /
+			       (sys_clock_hw_cycles_per_sec / MSEC_PER_SEC)),
+		       (u32_t)(stats.cycles * 100 / total));
+		printk("    switches %u, preemptions %u, stack %zu/%zu bytes\n",
+		       stats.num_switches, stats.num_preemptions,
+		       stats.stack_max_used, stats.stack_size);
+	}
+
+	return 0;
+}
+#endif
+
 struct shell_cmd kernel_commands[] = {
 	{ "version", shell_cmd_version, "show kernel version" },
 	{ "uptime", shell_cmd_uptime, "show system uptime in milliseconds" },
@@ -85,6 +179,14 @@ struct shell_cmd kernel_commands[] = {
 #endif
 #if defined(CONFIG_INIT_STACKS)
 	{ "stacks", shell_cmd_stack, "show system stacks" },
+#endif
+#if defined(CONFIG_MEM_ALLOC_STATS)
+	{ "mem", shell_cmd_mem,
+	  "show memory slab and pool statistics, 'reset' clears them" },
+#endif
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+	{ "threads", shell_cmd_threads,
+	  "show CPU time, context switches and stack usage of threads" },
 #endif
 	{ NULL, NULL, NULL }
 };
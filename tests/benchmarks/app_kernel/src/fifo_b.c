@@ -10,6 +10,52 @@
 
 #ifdef FIFO_BENCH
 
+/* batch sizes measured with k_msgq_put_n() and k_msgq_get_n() */
+static const u32_t batch_sizes[] = { 1, 2, 4, 8, 16, 32, 64 };
+
+/**
+ *
+ * @brief Queue batch transfer speed test
+ *
+ * Moves NR_OF_FIFO_RUNS 4 bytes messages, rounded down to a multiple of the
+ * batch size, and reports the average cost per message.
+ *
+ * @return N/A
+ */
+static void queue_batch_test(void)
+{
+	u32_t et; /* elapsed time */
+	u32_t batch, nr_of_msgs;
+	int i, j;
+
+	for (j = 0; j < ARRAY_SIZE(batch_sizes); j++) {
+		batch = batch_sizes[j];
+		nr_of_msgs = (NR_OF_FIFO_RUNS / batch) * batch;
+
+		et = BENCH_START();
+		for (i = 0; i < nr_of_msgs; i += batch) {
+			k_msgq_put_n(&DEMOQX4, data_bench, batch, K_FOREVER);
+		}
+		et = TIME_STAMP_DELTA_GET(et);
+		check_result();
+
+		PRINT_F(output_file, "| enqueue 4 bytes msgs in FIFO, batches of %2u"
+			"                      |%10u|\n", batch,
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, nr_of_msgs));
+
+		et = BENCH_START();
+		for (i = 0; i < nr_of_msgs; i += batch) {
+			k_msgq_get_n(&DEMOQX4, data_bench, batch, K_FOREVER);
+		}
+		et = TIME_STAMP_DELTA_GET(et);
+		check_result();
+
+		PRINT_F(output_file, "| dequeue 4 bytes msgs in FIFO, batches of %2u"
+			"                      |%10u|\n", batch,
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, nr_of_msgs));
+	}
+}
+
 /**
  *
  * @brief Queue transfer speed test
@@ -61,6 +107,8 @@ void queue_test(void)
 	PRINT_F(output_file, FORMAT, "dequeue 4 bytes msg in FIFO",
 			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
 
+	queue_batch_test();
+
 	k_sem_give(&STARTRCV);
 
 	et = BENCH_START();
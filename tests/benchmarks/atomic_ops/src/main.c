@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure the cost of the atomic operations
+ *
+ * Runs each atomic operation in a loop and reports its average cost, to
+ * compare the interrupt-locking C implementation with the native one. The
+ * cost is measured in core clock cycles when the core counts them, rather
+ * than with the system timer, which may run much slower.
+ */
+
+#include <zephyr.h>
+#include <atomic.h>
+#include <tc_util.h>
+#include <arch/cpu.h>
+
+#define NUM_RUNS 1000
+
+#ifdef CONFIG_RISCV_HAS_CYCLE_COUNTERS
+#define GET_CYCLES() riscv_mcycle_get_32()
+#define PRINT_COST(name, cycles) \
+	TC_PRINT("%-16s %6u core cycles\n", name, (cycles) / NUM_RUNS)
+#else
+#define GET_CYCLES() k_cycle_get_32()
+#define PRINT_COST(name, cycles) \
+	TC_PRINT("%-16s %6u cycles (%6u ns)\n", name, (cycles) / NUM_RUNS, \
+		 SYS_CLOCK_HW_CYCLES_TO_NS_AVG(cycles, NUM_RUNS))
+#endif
+
+static atomic_t target;
+static ATOMIC_DEFINE(bits, 32);
+
+#define BENCH(name, op)							\
+	do {								\
+		u32_t t0, t1;						\
+		int i;							\
+									\
+		t0 = GET_CYCLES();					\
+		for (i = 0; i < NUM_RUNS; i++) {			\
+			op;						\
+		}							\
+		t1 = GET_CYCLES();					\
+									\
+		PRINT_COST(name, t1 - t0);				\
+	} while ((0))
+
+void main(void)
+{
+	TC_START("Atomic operations benchmark");
+
+#ifdef CONFIG_ATOMIC_OPERATIONS_BUILTIN
+	TC_PRINT("Atomic operations: native instructions\n");
+#else
+	TC_PRINT("Atomic operations: C, interrupts locked\n");
+#endif
+	TC_PRINT("Average over %d operations, loop overhead included\n",
+		 NUM_RUNS);
+
+	BENCH("loop", __asm__ volatile (""));
+	BENCH("atomic_get", (void)atomic_get(&target));
+	BENCH("atomic_set", atomic_set(&target, i));
+	BENCH("atomic_inc", atomic_inc(&target));
+	BENCH("atomic_dec", atomic_dec(&target));
+	BENCH("atomic_add", atomic_add(&target, 3));
+	BENCH("atomic_or", atomic_or(&target, 0x10));
+	BENCH("atomic_and", atomic_and(&target, ~0x10));
+	BENCH("atomic_cas", atomic_cas(&target, i, i + 1));
+	BENCH("atomic_set_bit", atomic_set_bit(bits, i & 31));
+	BENCH("atomic_test_and_clear_bit",
+	      (void)atomic_test_and_clear_bit(bits, i & 31));
+
+	TC_PRINT("Atomic operations benchmark finished\n");
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file measure interrupt entry and exit time on riscv32
+ *
+ * This file contains test that measures the time to enter an ISR triggered
+ * by software, and to return from it to the interrupted thread. The ISR is
+ * a direct one with CONFIG_RISCV_DIRECT_ISR, a regular one otherwise, so that
+ * both can be compared by running the benchmark in both configurations.
+ *
+ * When the core implements the mcycle and minstret CSRs, the time is counted
+ * in core clock cycles, along with the instructions retired, rather than with
+ * the machine timer, which may be too slow to measure an interrupt entry.
+ */
+
+#include "timestamp.h"
+#include "utils.h"
+
+#include <arch/cpu.h>
+
+#define NUM_RUNS 100
+
+#ifdef CONFIG_RISCV_HAS_CYCLE_COUNTERS
+#define GET_CYCLES() riscv_mcycle_get_32()
+#else
+#define GET_CYCLES() OS_GET_TIME()
+#endif
+
+#if defined(CONFIG_SOC_RISCV32_FE310)
+#define TEST_IRQ RISCV_MACHINE_SOFT_IRQ
+#define MSIP (*(volatile u32_t *)RISCV_MSIP_BASE)
+
+static inline void trigger_irq(void)
+{
+	MSIP = 1;
+}
+
+static inline void clear_irq(void)
+{
+	/* the machine software interrupt is only pending as long as set */
+	MSIP = 0;
+}
+#elif defined(CONFIG_SOC_RISCV32_PULPINO)
+/* no I2C driver uses the line */
+#define TEST_IRQ PULP_I2C_0_IRQ
+
+static inline void trigger_irq(void)
+{
+	PULP_ISP = (1 << TEST_IRQ);
+}
+
+static inline void clear_irq(void)
+{
+	/* cleared by the interrupt entry code */
+}
+#endif
+
+#ifdef TEST_IRQ
+static volatile int flag_var;
+
+static u32_t entry_stamp;
+#ifdef CONFIG_RISCV_HAS_CYCLE_COUNTERS
+static u32_t entry_instret;
+#endif
+
+#ifdef CONFIG_RISCV_DIRECT_ISR
+ISR_DIRECT_DECLARE(latency_direct_isr)
+{
+	entry_stamp = GET_CYCLES();
+#ifdef CONFIG_RISCV_HAS_CYCLE_COUNTERS
+	entry_instret = riscv_minstret_get_32();
+#endif
+	clear_irq();
+	flag_var = 1;
+
+	/* nothing to reschedule */
+	return 0;
+}
+#else
+static void latency_test_isr(void *unused)
+{
+	ARG_UNUSED(unused);
+
+	entry_stamp = GET_CYCLES();
+#ifdef CONFIG_RISCV_HAS_CYCLE_COUNTERS
+	entry_instret = riscv_minstret_get_32();
+#endif
+	clear_irq();
+	flag_var = 1;
+}
+#endif
+
+/**
+ *
+ * @brief The test main function
+ *
+ * @return 0 on success
+ */
+int int_direct(void)
+{
+	u32_t entry_total = 0;
+	u32_t exit_total = 0;
+	u32_t start, end;
+#ifdef CONFIG_RISCV_HAS_CYCLE_COUNTERS
+	u32_t entry_instret_total = 0;
+	u32_t exit_instret_total = 0;
+	u32_t start_instret, end_instret;
+#endif
+	int i;
+
+#ifdef CONFIG_RISCV_DIRECT_ISR
+	PRINT_FORMAT(" 7 - Measure time to enter and leave a direct ISR");
+	IRQ_DIRECT_CONNECT(TEST_IRQ, IRQ_PRIORITY, latency_direct_isr, 0);
+#else
+	PRINT_FORMAT(" 7 - Measure time to enter and leave a regular ISR");
+	IRQ_CONNECT(TEST_IRQ, IRQ_PRIORITY, latency_test_isr, NULL, 0);
+#endif
+	irq_enable(TEST_IRQ);
+
+	TICK_SYNCH();
+
+	for (i = 0; i < NUM_RUNS; i++) {
+		flag_var = 0;
+
+#ifdef CONFIG_RISCV_HAS_CYCLE_COUNTERS
+		start_instret = riscv_minstret_get_32();
+#endif
+		start = GET_CYCLES();
+		trigger_irq();
+		while (!flag_var) {
+		}
+		end = GET_CYCLES();
+#ifdef CONFIG_RISCV_HAS_CYCLE_COUNTERS
+		end_instret = riscv_minstret_get_32();
+
+		entry_instret_total += entry_instret - start_instret;
+		exit_instret_total += end_instret - entry_instret;
+#endif
+
+		entry_total += entry_stamp - start;
+		exit_total += end - entry_stamp;
+	}
+
+	irq_disable(TEST_IRQ);
+
+#ifdef CONFIG_RISCV_HAS_CYCLE_COUNTERS
+	PRINT_FORMAT(" Average ISR entry: %u core cycles, %u instructions",
+		     entry_total / NUM_RUNS, entry_instret_total / NUM_RUNS);
+	PRINT_FORMAT(" Average ISR exit: %u core cycles, %u instructions",
+		     exit_total / NUM_RUNS, exit_instret_total / NUM_RUNS);
+#else
+	PRINT_FORMAT(" Average ISR entry time %u tcs = %u nsec",
+		     entry_total / NUM_RUNS,
+		     SYS_CLOCK_HW_CYCLES_TO_NS_AVG(entry_total, NUM_RUNS));
+	PRINT_FORMAT(" Average ISR exit time %u tcs = %u nsec",
+		     exit_total / NUM_RUNS,
+		     SYS_CLOCK_HW_CYCLES_TO_NS_AVG(exit_total, NUM_RUNS));
+#endif
+	return 0;
+}
+#else
+int int_direct(void)
+{
+	PRINT_FORMAT(" 7 - Measure time to enter and leave an ISR");
+	PRINT_FORMAT(" no software triggered interrupt on this SOC, skipped");
+	return 0;
+}
+#endif /* TEST_IRQ */
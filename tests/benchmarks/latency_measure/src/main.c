@@ -25,6 +25,7 @@ extern void int_to_thread_evt(void);
 extern void sema_lock_unlock(void);
 extern void mutex_lock_unlock(void);
 extern int coop_ctx_switch(void);
+extern int int_direct(void);
 void test_thread(void *arg1, void *arg2, void *arg3)
 {
 	PRINT_BANNER();
@@ -50,6 +51,11 @@ void test_thread(void *arg1, void *arg2, void *arg3)
 	coop_ctx_switch();
 	print_dash_line();
 
+#ifdef CONFIG_RISCV32
+	int_direct();
+	print_dash_line();
+#endif
+
 	TC_END_REPORT(error_count);
 }
 
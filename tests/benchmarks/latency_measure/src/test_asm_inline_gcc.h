@@ -35,6 +35,8 @@ static inline void timestamp_serialize(void)
 }
 #elif defined(CONFIG_CPU_ARCV2)
 #define timestamp_serialize()
+#elif defined(CONFIG_RISCV32)
+#define timestamp_serialize()
 #else
 #error implementation of timestamp_serialize() not provided for your CPU target
 #endif
@@ -0,0 +1,141 @@
+/* isrfifo.c */
+
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measure fifos fed from an ISR and consumed by a thread, with the regular
+ * k_fifo_put() and with k_fifo_put_lockfree(). The ISR adds either one
+ * element at a time, the consumer thread waiting for each of them, or bursts
+ * of elements which the consumer thread gathers once woken up.
+ */
+
+#include <irq_offload.h>
+
+#include "syskernel.h"
+
+#define BURST_SIZE 8
+
+static struct k_fifo isr_fifo;
+
+/* the first word of each element is reserved for the kernel */
+static int elements[BURST_SIZE][2];
+
+static int use_lockfree;
+static int burst;
+
+/**
+ *
+ * @brief Add a burst of elements to the fifo, from an ISR
+ *
+ * @param arg   Ignored parameter.
+ *
+ * @return N/A
+ */
+static void isr_put(void *arg)
+{
+	int i;
+
+	ARG_UNUSED(arg);
+
+	for (i = 0; i < burst; i++) {
+		if (use_lockfree) {
+			k_fifo_put_lockfree(&isr_fifo, elements[i]);
+		} else {
+			k_fifo_put(&isr_fifo, elements[i]);
+		}
+	}
+}
+
+/**
+ *
+ * @brief Fifo consumer thread
+ *
+ * @param par1   Address of the counter.
+ * @param par2   Number of test loops.
+ *
+ * @return N/A
+ */
+static void isr_fifo_thread(void *par1, void *par2, void *par3)
+{
+	int i;
+	int *pcounter = (int *)par1;
+	int num_loops = (int)par2;
+
+	ARG_UNUSED(par3);
+
+	for (i = 0; i < num_loops; i++) {
+		if (!k_fifo_get(&isr_fifo, K_FOREVER)) {
+			break;
+		}
+		(*pcounter)++;
+	}
+}
+
+/**
+ *
+ * @brief Run one ISR producer / thread consumer test case
+ *
+ * @param name   Name of the test case.
+ * @param put   Name of the routine used to add elements.
+ * @param lockfree   Non-zero to use k_fifo_put_lockfree().
+ * @param size   Number of elements added by each ISR.
+ *
+ * @return 1 if success and 0 on failure
+ */
+static int isr_fifo_case(const char *name, const char *put, int lockfree,
+			 int size)
+{
+	u32_t t;
+	int i = 0;
+	int j;
+
+	fprintf(output_file, sz_test_case_fmt, name);
+	fprintf(output_file, sz_description, "\n\tk_fifo_init"
+		"\n\tk_fifo_get(K_FOREVER)");
+	fprintf(output_file, "\n\t%s from ISR, %d at a time", put, size);
+	printf(sz_test_start_fmt);
+
+	k_fifo_init(&isr_fifo);
+	use_lockfree = lockfree;
+	burst = size;
+
+	t = BENCH_START();
+
+	/* the consumer preempts this thread as soon as the ISR is done */
+	k_thread_create(&thread_data1, thread_stack1, STACK_SIZE,
+			isr_fifo_thread, (void *) &i, (void *) NUMBER_OF_LOOPS,
+			NULL, K_PRIO_COOP(3), 0, K_NO_WAIT);
+
+	for (j = 0; j < NUMBER_OF_LOOPS; j += size) {
+		irq_offload(isr_put, NULL);
+	}
+
+	t = TIME_STAMP_DELTA_GET(t);
+
+	return check_result(i, t);
+}
+
+/**
+ *
+ * @brief The main test entry
+ *
+ * @return number of successful test cases
+ */
+int isr_fifo_test(void)
+{
+	int return_value = 0;
+
+	return_value += isr_fifo_case("FIFO from ISR #1", "k_fifo_put", 0, 1);
+	return_value += isr_fifo_case("FIFO from ISR #2",
+				      "k_fifo_put_lockfree", 1, 1);
+	return_value += isr_fifo_case("FIFO from ISR #3", "k_fifo_put", 0,
+				      BURST_SIZE);
+	return_value += isr_fifo_case("FIFO from ISR #4",
+				      "k_fifo_put_lockfree", 1, BURST_SIZE);
+
+	return return_value;
+}
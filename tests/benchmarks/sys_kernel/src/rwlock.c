@@ -0,0 +1,150 @@
+/* rwlock.c */
+
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "syskernel.h"
+
+#define MAX_READERS 8
+#define READER_STACK_SIZE 512
+
+static K_THREAD_STACK_ARRAY_DEFINE(reader_stacks, MAX_READERS,
+				   READER_STACK_SIZE);
+static struct k_thread reader_threads[MAX_READERS];
+
+struct k_rwlock rwlock1;
+struct k_mutex mutex1;
+
+/**
+ *
+ * @brief Reader thread using the reader-writer lock
+ *
+ * The thread yields while holding the lock, so that the other readers get to
+ * lock it at the same time.
+ *
+ * @param par1   Address of the counter.
+ * @param par2   Number of test loops.
+ *
+ * @return N/A
+ */
+void rwlock_reader(void *par1, void *par2, void *par3)
+{
+	int i;
+	int *pcounter = (int *)par1;
+	int num_loops = (int) par2;
+
+	ARG_UNUSED(par3);
+
+	for (i = 0; i < num_loops; i++) {
+		k_rwlock_read_lock(&rwlock1, K_FOREVER);
+		k_yield();
+		(*pcounter)++;
+		k_rwlock_read_unlock(&rwlock1);
+	}
+}
+
+/**
+ *
+ * @brief Reader thread using a mutex, for comparison
+ *
+ * @param par1   Address of the counter.
+ * @param par2   Number of test loops.
+ *
+ * @return N/A
+ */
+void mutex_reader(void *par1, void *par2, void *par3)
+{
+	int i;
+	int *pcounter = (int *)par1;
+	int num_loops = (int) par2;
+
+	ARG_UNUSED(par3);
+
+	for (i = 0; i < num_loops; i++) {
+		k_mutex_lock(&mutex1, K_FOREVER);
+		k_yield();
+		(*pcounter)++;
+		k_mutex_unlock(&mutex1);
+	}
+}
+
+/**
+ *
+ * @brief Run NUMBER_OF_LOOPS read accesses, spread over a number of readers
+ *
+ * The readers are all started before any of them runs, and the test ends
+ * when all of them are done, since they have a higher priority.
+ *
+ * @param entry   Reader thread entry point.
+ * @param num_readers   Number of concurrent readers.
+ *
+ * @return 1 if success and 0 on failure
+ */
+static int run_readers(k_thread_entry_t entry, int num_readers)
+{
+	u32_t t;
+	int i = 0;
+	int n;
+
+	t = BENCH_START();
+
+	k_sched_lock();
+	for (n = 0; n < num_readers; n++) {
+		k_thread_create(&reader_threads[n], reader_stacks[n],
+				READER_STACK_SIZE, entry, (void *) &i,
+				(void *) (NUMBER_OF_LOOPS / num_readers), NULL,
+				K_PRIO_COOP(3), 0, K_NO_WAIT);
+	}
+	k_sched_unlock();
+
+	t = TIME_STAMP_DELTA_GET(t);
+
+	return check_result(i, t);
+}
+
+/**
+ *
+ * @brief The main test entry
+ *
+ * @return 1 if success and 0 on failure
+ */
+int rwlock_test(void)
+{
+	int return_value = 0;
+	int num_readers;
+	char name[40];
+
+	k_rwlock_init(&rwlock1);
+	k_mutex_init(&mutex1);
+
+	for (num_readers = 1; num_readers <= MAX_READERS; num_readers *= 2) {
+		snprintf(name, sizeof(name), "RW lock, %d reader(s)",
+			 num_readers);
+		fprintf(output_file, sz_test_case_fmt, name);
+		fprintf(output_file, sz_description,
+				"\n\tk_rwlock_read_lock(K_FOREVER)"
+				"\n\tk_yield"
+				"\n\tk_rwlock_read_unlock");
+		printf(sz_test_start_fmt);
+
+		return_value += run_readers(rwlock_reader, num_readers);
+	}
+
+	for (num_readers = 1; num_readers <= MAX_READERS; num_readers *= 2) {
+		snprintf(name, sizeof(name), "Mutex, %d reader(s)",
+			 num_readers);
+		fprintf(output_file, sz_test_case_fmt, name);
+		fprintf(output_file, sz_description,
+				"\n\tk_mutex_lock(K_FOREVER)"
+				"\n\tk_yield"
+				"\n\tk_mutex_unlock");
+		printf(sz_test_start_fmt);
+
+		return_value += run_readers(mutex_reader, num_readers);
+	}
+
+	return return_value;
+}
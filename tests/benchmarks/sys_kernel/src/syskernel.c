@@ -26,6 +26,17 @@ const char sz_success[] = "SUCCESSFUL";
 const char sz_partial[] = "PARTIAL";
 const char sz_fail[] = "FAILED";
 
+#ifdef CONFIG_QUEUE_LOCKFREE_APPEND
+/*
+ * sema/lifo/fifo/stack account for 12 tests, rwlock for 8, fifo from ISR
+ * for 4
+ */
+#define NUMBER_OF_TESTS 24
+#else
+/* sema/lifo/fifo/stack account for 12 tests, rwlock for 8 */
+#define NUMBER_OF_TESTS 20
+#endif
+
 /* time necessary to read the time */
 u32_t tm_off;
 
@@ -158,10 +169,13 @@ void main(void)
 		test_result += lifo_test();
 		test_result += fifo_test();
 		test_result += stack_test();
+		test_result += rwlock_test();
+#ifdef CONFIG_QUEUE_LOCKFREE_APPEND
+		test_result += isr_fifo_test();
+#endif
 
 		if (test_result) {
-			/* sema/lifo/fifo/stack account for 12 tests in total */
-			if (test_result == 12) {
+			if (test_result == NUMBER_OF_TESTS) {
 				fprintf(output_file, sz_module_result_fmt,
 					sz_success);
 			} else {
@@ -49,6 +49,8 @@ int sema_test(void);
 int lifo_test(void);
 int fifo_test(void);
 int stack_test(void);
+int rwlock_test(void);
+int isr_fifo_test(void);
 void begin_test(void);
 
 static inline u32_t BENCH_START(void)
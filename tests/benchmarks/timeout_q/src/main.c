@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure timeout queue insertion and removal cost
+ *
+ * Starts an increasing number of kernel timers, so that their timeouts are
+ * pending in the timeout queue, then measures how long it takes to start and
+ * stop one more timer. Starting a timer adds its timeout to the queue and
+ * stopping it removes the timeout from the queue, both with interrupts locked.
+ *
+ * The probe timers are given durations spread over the same range as the
+ * pending ones, so that they land at various positions in the queue.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+
+#define MAX_PENDING 512
+#define NUM_PROBES 64
+
+/* long enough that no timer expires while the test runs */
+#define MIN_DURATION K_SECONDS(100)
+#define DURATION_SPAN K_SECONDS(100)
+
+static struct k_timer pending[MAX_PENDING];
+static struct k_timer probe;
+
+static const int num_pending[] = { 0, 8, 16, 32, 64, 128, 256, 512 };
+
+static u32_t seed = 0x12345678;
+
+/* cheap deterministic pseudo-random durations, identical for all runs */
+static s32_t next_duration(void)
+{
+	seed = seed * 1103515245 + 12345;
+
+	return MIN_DURATION + (s32_t)((seed >> 8) % DURATION_SPAN);
+}
+
+static void bench_timeouts(int count)
+{
+	u32_t start_cycles = 0;
+	u32_t stop_cycles = 0;
+	u32_t t0, t1, t2;
+	int i;
+
+	for (i = 0; i < NUM_PROBES; i++) {
+		s32_t duration = next_duration();
+
+		t0 = k_cycle_get_32();
+		k_timer_start(&probe, duration, 0);
+		t1 = k_cycle_get_32();
+		k_timer_stop(&probe);
+		t2 = k_cycle_get_32();
+
+		start_cycles += t1 - t0;
+		stop_cycles += t2 - t1;
+	}
+
+	TC_PRINT("%4d pending: start %6u cycles (%6u ns), "
+		 "stop %6u cycles (%6u ns)\n", count,
+		 start_cycles / NUM_PROBES,
+		 SYS_CLOCK_HW_CYCLES_TO_NS_AVG(start_cycles, NUM_PROBES),
+		 stop_cycles / NUM_PROBES,
+		 SYS_CLOCK_HW_CYCLES_TO_NS_AVG(stop_cycles, NUM_PROBES));
+}
+
+void main(void)
+{
+	int started = 0;
+	int i, j;
+
+	TC_START("Timeout queue benchmark");
+
+#ifdef CONFIG_TIMEOUT_QUEUE_PAIRING_HEAP
+	TC_PRINT("Timeout queue: pairing heap\n");
+#else
+	TC_PRINT("Timeout queue: delta list\n");
+#endif
+	TC_PRINT("Average over %d timers started then stopped\n", NUM_PROBES);
+
+	k_timer_init(&probe, NULL, NULL);
+	for (i = 0; i < MAX_PENDING; i++) {
+		k_timer_init(&pending[i], NULL, NULL);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(num_pending); i++) {
+		for (j = started; j < num_pending[i]; j++) {
+			k_timer_start(&pending[j], next_duration(), 0);
+		}
+		started = num_pending[i];
+
+		bench_timeouts(started);
+	}
+
+	for (i = 0; i < started; i++) {
+		k_timer_stop(&pending[i]);
+	}
+
+	TC_PRINT("Timeout queue benchmark finished\n");
+
+	TC_END_RESULT(TC_PASS);
+	TC_END_REPORT(TC_PASS);
+}
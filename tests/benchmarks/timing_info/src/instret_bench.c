@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure instructions retired on riscv32
+ *
+ * Calibrate the core cycle counter against the system clock, and count the
+ * instructions retired by the main kernel operations, using the minstret
+ * CSR: unlike the cycle count, this does not depend on the memory latency
+ * or on the core pipeline.
+ */
+#include <kernel.h>
+#include <zephyr.h>
+#include <tc_util.h>
+#include <ksched.h>
+#include "timing_info.h"
+
+#define STACK_SIZE 500
+#define CALIBRATION_MS 100
+
+extern char sline[];
+
+extern char my_stack_area[];
+extern struct k_thread my_thread;
+
+extern u32_t __read_swap_end_tsc_value;
+
+extern u32_t __start_swap_instret;
+extern u32_t __end_swap_instret;
+extern u32_t __start_intr_instret;
+extern u32_t __end_intr_instret;
+extern u32_t __start_tick_instret;
+extern u32_t __end_tick_instret;
+
+u32_t timing_cycles_per_sec;
+
+static u32_t swap_instret;
+
+K_SEM_DEFINE(instret_sem, 0, 1);
+
+#define PRINT_INSTRET(name, instret) \
+	TC_PRINT("%-45s:%5u instructions\n", name, instret)
+
+/*
+ * Count the core clock cycles elapsed during a whole number of system clock
+ * cycles. The machine timer may run much slower than the core clock, hence
+ * the long enough calibration period.
+ */
+void timing_calibrate(void)
+{
+	u32_t period = (u32_t)((u64_t)sys_clock_hw_cycles_per_sec *
+			       CALIBRATION_MS / MSEC_PER_SEC);
+	u32_t start, cycles;
+
+	start = k_cycle_get_32();
+	while (k_cycle_get_32() == start) {
+	}
+
+	start = k_cycle_get_32();
+	cycles = OS_GET_TIME();
+	while (k_cycle_get_32() - start < period) {
+	}
+	cycles = OS_GET_TIME() - cycles;
+
+	timing_cycles_per_sec = (u32_t)((u64_t)cycles * MSEC_PER_SEC /
+					CALIBRATION_MS);
+}
+
+static void instret_swap_thread(void *p1, void *p2, void *p3)
+{
+	/* switched in right after the end of swap was recorded */
+	swap_instret = __end_swap_instret - __start_swap_instret;
+}
+
+static void instret_nop_thread(void *p1, void *p2, void *p3)
+{
+}
+
+void instret_bench(void)
+{
+	u32_t create_instret, sem_give_instret, sem_take_instret;
+	u32_t intr_instret, tick_instret;
+	u32_t start;
+	unsigned int key;
+	k_tid_t tid;
+
+	/* Context switch, from k_sleep() to a ready thread */
+	k_thread_create(&my_thread, my_stack_area, STACK_SIZE,
+			instret_swap_thread, NULL, NULL, NULL,
+			5 /*priority*/, 0, K_NO_WAIT);
+
+	__read_swap_end_tsc_value = 1;
+	k_sleep(10);
+
+	/* Thread creation */
+	start = OS_GET_INSTRET();
+	tid = k_thread_create(&my_thread, my_stack_area, STACK_SIZE,
+			      instret_nop_thread, NULL, NULL, NULL,
+			      5 /*priority*/, 0, 10);
+	create_instret = OS_GET_INSTRET() - start;
+
+	k_thread_cancel(tid);
+
+	/* Semaphore give and take, without context switch */
+	start = OS_GET_INSTRET();
+	k_sem_give(&instret_sem);
+	sem_give_instret = OS_GET_INSTRET() - start;
+
+	start = OS_GET_INSTRET();
+	k_sem_take(&instret_sem, K_NO_WAIT);
+	sem_take_instret = OS_GET_INSTRET() - start;
+
+	/* Interrupt entry and tick handler, recorded by the last tick */
+	k_sleep(10);
+
+	key = irq_lock();
+	intr_instret = __end_intr_instret - __start_intr_instret;
+	tick_instret = __end_tick_instret - __start_tick_instret;
+	irq_unlock(key);
+
+	PRINT_INSTRET("Context switch", swap_instret);
+	PRINT_INSTRET("Interrupt latency", intr_instret);
+	PRINT_INSTRET("Tick overhead", tick_instret);
+	PRINT_INSTRET("Thread Creation", create_instret);
+	PRINT_INSTRET("Semaphore Give without context switch",
+		      sem_give_instret);
+	PRINT_INSTRET("Semaphore Take without context switch",
+		      sem_take_instret);
+}
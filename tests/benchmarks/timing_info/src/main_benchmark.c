@@ -18,7 +18,14 @@
 
 void main(void)
 {
+#ifdef TIMING_HAS_INSTRET
+	u32_t freq;
+
+	timing_calibrate();
+	freq = timing_cycles_per_sec / 1000000;
+#else
 	u32_t freq = CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC / 1000000;
+#endif
 
 	TC_START("Time Measurement");
 	TC_PRINT("Timing Results: Clock Frequency: %d MHz\n", freq);
@@ -47,6 +54,11 @@ void main(void)
 	/* mutex lock and unlock*/
 	msg_passing_bench();
 
+#ifdef TIMING_HAS_INSTRET
+	/*******************************************************************/
+	/* Instructions retired */
+	instret_bench();
+#endif
 
 	TC_PRINT("Timing Measurement  finished\n");
 
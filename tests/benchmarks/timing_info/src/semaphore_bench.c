@@ -101,16 +101,16 @@ void semaphore_bench(void)
 	/* TC_PRINT("test_time2 , %d cycles\n", (u32_t)test_time2); */
 
 	PRINT_F("Semaphore Take with context switch",
-		sem_cycles, SYS_CLOCK_HW_CYCLES_TO_NS(sem_cycles));
+		sem_cycles, CYCLES_TO_NS(sem_cycles));
 	PRINT_F("Semaphore Give with context switch",
-		sem_give_cycles, SYS_CLOCK_HW_CYCLES_TO_NS(sem_give_cycles));
+		sem_give_cycles, CYCLES_TO_NS(sem_give_cycles));
 
 	PRINT_F("Semaphore Take without context switch",
 		sem_take_wo_cxt_cycles,
-		SYS_CLOCK_HW_CYCLES_TO_NS(sem_take_wo_cxt_cycles));
+		CYCLES_TO_NS(sem_take_wo_cxt_cycles));
 	PRINT_F("Semaphore Give without context switch",
 		sem_give_wo_cxt_cycles,
-		SYS_CLOCK_HW_CYCLES_TO_NS(sem_give_wo_cxt_cycles));
+		CYCLES_TO_NS(sem_give_wo_cxt_cycles));
 
 }
 /******************************************************************************/
@@ -140,10 +140,10 @@ void mutex_bench(void)
 	}
 
 	PRINT_F("Mutex lock", mutex_lock_diff / 1000,
-		SYS_CLOCK_HW_CYCLES_TO_NS(mutex_lock_diff / 1000));
+		CYCLES_TO_NS(mutex_lock_diff / 1000));
 
 	PRINT_F("Mutex unlock", mutex_unlock_diff / 1000,
-		SYS_CLOCK_HW_CYCLES_TO_NS(mutex_unlock_diff / 1000));
+		CYCLES_TO_NS(mutex_unlock_diff / 1000));
 
 }
 
@@ -125,6 +125,67 @@ void read_systick_end_of_tick_handler(void)
 	__end_tick_tsc  = (u32_t)SysTick->VAL;
 }
 
+#elif CONFIG_RISCV32
+#ifdef TIMING_HAS_INSTRET
+u32_t __start_swap_instret;
+u32_t __end_swap_instret;
+u32_t __start_intr_instret;
+u32_t __end_intr_instret;
+u32_t __start_tick_instret;
+u32_t __end_tick_instret;
+#endif
+
+void read_timer_start_of_swap(void)
+{
+	__start_swap_tsc = OS_GET_TIME();
+#ifdef TIMING_HAS_INSTRET
+	__start_swap_instret = OS_GET_INSTRET();
+#endif
+}
+
+void read_timer_end_of_swap(void)
+{
+	if (__read_swap_end_tsc_value == 1) {
+		__read_swap_end_tsc_value = 2;
+		__common_var_swap_end_tsc = OS_GET_TIME();
+#ifdef TIMING_HAS_INSTRET
+		__end_swap_instret = OS_GET_INSTRET();
+#endif
+	}
+}
+
+void read_timer_start_of_isr(void)
+{
+	__start_intr_tsc = OS_GET_TIME();
+#ifdef TIMING_HAS_INSTRET
+	__start_intr_instret = OS_GET_INSTRET();
+#endif
+}
+
+void read_timer_end_of_isr(void)
+{
+	__end_intr_tsc = OS_GET_TIME();
+#ifdef TIMING_HAS_INSTRET
+	__end_intr_instret = OS_GET_INSTRET();
+#endif
+}
+
+void read_timer_start_of_tick_handler(void)
+{
+	__start_tick_tsc = OS_GET_TIME();
+#ifdef TIMING_HAS_INSTRET
+	__start_tick_instret = OS_GET_INSTRET();
+#endif
+}
+
+void read_timer_end_of_tick_handler(void)
+{
+	__end_tick_tsc = OS_GET_TIME();
+#ifdef TIMING_HAS_INSTRET
+	__end_tick_instret = OS_GET_INSTRET();
+#endif
+}
+
 #endif
 
 
@@ -191,11 +252,11 @@ void system_thread_bench(void)
 				     SUBTRACT_CLOCK_CYCLES(__start_swap_tsc);
 
 	/* Interrupt latency*/
-	total_intr_time = SYS_CLOCK_HW_CYCLES_TO_NS(__end_intr_tsc -
+	total_intr_time = CYCLES_TO_NS(__end_intr_tsc -
 						    __start_intr_tsc);
 
 	/* tick overhead*/
-	total_tick_time = SYS_CLOCK_HW_CYCLES_TO_NS(__end_tick_tsc -
+	total_tick_time = CYCLES_TO_NS(__end_tick_tsc -
 						    __start_tick_tsc);
 
 	/*******************************************************************/
@@ -250,7 +311,7 @@ void system_thread_bench(void)
 
 	PRINT_F("Context switch",
 		(u32_t)(total_swap_cycles & 0xFFFFFFFFULL),
-		(u32_t)SYS_CLOCK_HW_CYCLES_TO_NS(total_swap_cycles));
+		(u32_t)CYCLES_TO_NS(total_swap_cycles));
 
 	/*TC_PRINT("Swap Overhead:%d cycles\n", benchmarking_overhead_swap());*/
 
@@ -260,14 +321,14 @@ void system_thread_bench(void)
 
 	PRINT_F("Interrupt latency",
 		(u32_t)(intr_latency_cycles),
-		(u32_t) (SYS_CLOCK_HW_CYCLES_TO_NS(intr_latency_cycles)));
+		(u32_t) (CYCLES_TO_NS(intr_latency_cycles)));
 
 	/*tick overhead*/
 	u32_t tick_overhead_cycles =  SUBTRACT_CLOCK_CYCLES(__end_tick_tsc) -
 					SUBTRACT_CLOCK_CYCLES(__start_tick_tsc);
 	PRINT_F("Tick overhead",
 		(u32_t)(tick_overhead_cycles),
-		(u32_t) (SYS_CLOCK_HW_CYCLES_TO_NS(tick_overhead_cycles)));
+		(u32_t) (CYCLES_TO_NS(tick_overhead_cycles)));
 
 	/*thread creation*/
 	PRINT_F("Thread Creation",
@@ -345,9 +406,9 @@ void heap_malloc_free_bench(void)
 
 	PRINT_F("Heap Malloc",
 		(u32_t)((sum_malloc / count) & 0xFFFFFFFFULL),
-		(u32_t)(SYS_CLOCK_HW_CYCLES_TO_NS(sum_malloc / count)));
+		(u32_t)(CYCLES_TO_NS(sum_malloc / count)));
 	PRINT_F("Heap Free",
 		(u32_t)((sum_free / count) & 0xFFFFFFFFULL),
-		(u32_t)(SYS_CLOCK_HW_CYCLES_TO_NS(sum_free / count)));
+		(u32_t)(CYCLES_TO_NS(sum_free / count)));
 
 }
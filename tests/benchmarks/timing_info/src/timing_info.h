@@ -5,10 +5,32 @@
  */
 #include <timestamp.h>
 
+/*
+ * On riscv32, count the core clock cycles with the mcycle CSR when the core
+ * implements it, rather than the machine timer read by k_cycle_get_32(),
+ * which may run much slower. Its frequency is calibrated against the system
+ * clock when the benchmark starts. The instructions retired are counted as
+ * well, with the minstret CSR.
+ */
+#if defined(CONFIG_RISCV32) && defined(CONFIG_RISCV_HAS_CYCLE_COUNTERS)
+#define TIMING_HAS_INSTRET
+
+#undef OS_GET_TIME
+#define OS_GET_TIME() riscv_mcycle_get_32()
+#define OS_GET_INSTRET() riscv_minstret_get_32()
+
+extern u32_t timing_cycles_per_sec;
+
+#define CYCLES_TO_NS(cycles) \
+	((u32_t)(((u64_t)(cycles) * NSEC_PER_SEC) / timing_cycles_per_sec))
+#else
+#define CYCLES_TO_NS(cycles) SYS_CLOCK_HW_CYCLES_TO_NS(cycles)
+#endif
+
 
 #define CALCULATE_TIME(special_char, profile, name)			     \
 	{								     \
-		total_##profile##_##name##_time = SYS_CLOCK_HW_CYCLES_TO_NS( \
+		total_##profile##_##name##_time = CYCLES_TO_NS( \
 			special_char##profile##_##name##_end_tsc -	     \
 			special_char##profile##_##name##_start_tsc);	     \
 	}
@@ -36,6 +58,10 @@ void heap_malloc_free_bench(void);
 void semaphore_bench(void);
 void mutex_bench(void);
 void msg_passing_bench(void);
+#ifdef TIMING_HAS_INSTRET
+void timing_calibrate(void);
+void instret_bench(void);
+#endif
 
 /* PRINT_F
  * Macro to print a formatted output string. fprintf is used when
@@ -65,9 +65,9 @@ void yield_bench(void)
 	u32_t sleep_cycles = thread_sleep_end_tsc - thread_sleep_start_tsc;
 
 	PRINT_F("Thread Yield", yield_cycles,
-		SYS_CLOCK_HW_CYCLES_TO_NS(yield_cycles));
+		CYCLES_TO_NS(yield_cycles));
 	PRINT_F("Thread Sleep", sleep_cycles,
-		SYS_CLOCK_HW_CYCLES_TO_NS(sleep_cycles));
+		CYCLES_TO_NS(sleep_cycles));
 
 }
 
@@ -88,6 +88,30 @@ struct fp_non_volatile_register_set {
 #define SIZEOF_FP_NON_VOLATILE_REGISTER_SET \
 	sizeof(struct fp_non_volatile_register_set)
 
+#elif defined(CONFIG_RISCV32)
+
+#define FP_OPTION 0
+
+/*
+ * Registers f0..f31, 64-bit wide with the D extension, 32-bit wide otherwise.
+ * Some of them are callee-saved, but the kernel saves them all when switching
+ * threads: handle them as a single volatile set.
+ */
+struct fp_volatile_register_set {
+#ifdef CONFIG_RISCV_HAS_D_EXTENSION
+	u64_t f[32];
+#else
+	u32_t f[32];
+#endif
+};
+
+struct fp_non_volatile_register_set {
+	/* No non-volatile floating point registers */
+};
+
+#define SIZEOF_FP_VOLATILE_REGISTER_SET sizeof(struct fp_volatile_register_set)
+#define SIZEOF_FP_NON_VOLATILE_REGISTER_SET 0
+
 #else
 
 #error  "Architecture must provide the following definitions:\n"
@@ -0,0 +1,105 @@
+/**
+ * @file
+ * @brief RISCV32 GCC specific floating point register macros
+ */
+
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _FLOAT_REGS_RISCV32_GCC_H
+#define _FLOAT_REGS_RISCV32_GCC_H
+
+#if !defined(__GNUC__) || !defined(CONFIG_RISCV32)
+#error __FILE__ goes only with RISCV32 GCC
+#endif
+
+#include <toolchain.h>
+#include "float_context.h"
+
+#ifdef CONFIG_RISCV_HAS_D_EXTENSION
+#define FP_LOAD "fld"
+#define FP_STORE "fsd"
+#define FP_REG_SIZE "8"
+#else
+#define FP_LOAD "flw"
+#define FP_STORE "fsw"
+#define FP_REG_SIZE "4"
+#endif
+
+#define FP_REGS_IRP(insn) \
+	".irp i, 0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15," \
+	"16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31\n\t" \
+	insn " f\\i, (\\i * " FP_REG_SIZE ")(%0)\n\t" \
+	".endr\n\t"
+
+/**
+ *
+ * @brief Load all floating point registers
+ *
+ * This function loads ALL floating point registers pointed to by @a regs.
+ * It is expected that a subsequent call to _store_all_float_registers()
+ * will be issued to dump the floating point registers to memory.
+ *
+ * The format/organization of 'struct fp_register_set'; the generic C test
+ * code (main.c) merely treat the register set as an array of bytes.
+ *
+ * The only requirement is that the arch specific implementations of
+ * _load_all_float_registers() and _store_all_float_registers() agree
+ * on the format.
+ *
+ * @return N/A
+ */
+
+static inline void _load_all_float_registers(struct fp_register_set *regs)
+{
+	__asm__ volatile (
+		FP_REGS_IRP(FP_LOAD)
+		: : "r" (&regs->fp_volatile)
+		);
+}
+
+/**
+ *
+ * @brief Dump all floating point registers to memory
+ *
+ * This function stores ALL floating point registers to the memory buffer
+ * specified by @a regs. It is expected that a previous invocation of
+ * _load_all_float_registers() occurred to load all the floating point
+ * registers from a memory buffer.
+ *
+ * @return N/A
+ */
+
+static inline void _store_all_float_registers(struct fp_register_set *regs)
+{
+	__asm__ volatile (
+		FP_REGS_IRP(FP_STORE)
+		: : "r" (&regs->fp_volatile)
+		: "memory"
+		);
+}
+
+/**
+ *
+ * @brief Load then dump all float registers to memory
+ *
+ * This function loads ALL floating point registers from the memory buffer
+ * specified by @a regs, and then stores them back to that buffer.
+ *
+ * This routine is called by a high priority thread prior to calling a primitive
+ * that pends and triggers a co-operative context switch to a low priority
+ * thread.
+ *
+ * @return N/A
+ */
+
+static inline void _load_then_store_all_float_registers(struct fp_register_set
+							*regs)
+{
+	_load_all_float_registers(regs);
+	_store_all_float_registers(regs);
+}
+#endif /* _FLOAT_REGS_RISCV32_GCC_H */
@@ -58,6 +58,8 @@
   #else
     #include <float_regs_arm_other.h>
   #endif /* __GNUC__ */
+#elif defined(CONFIG_RISCV32)
+  #include <float_regs_riscv32_gcc.h>
 #endif
 
 #include <arch/cpu.h>
@@ -239,6 +241,12 @@ void load_store_low(void)
 		 * point. Neither of these capabilities are currently supported
 		 * for ARM.
 		 */
+#elif defined(CONFIG_RISCV32)
+		/*
+		 * As on ARM, k_float_disable() is not supported: the floating
+		 * point registers of a thread are only enabled when the thread
+		 * is created with K_FP_REGS.
+		 */
 #endif
 	}
 }
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Test the size class cache of the heap memory pool
+ *
+ * Checks that k_malloc() serves small requests from the size class matching
+ * their size, reusing freed blocks, that larger requests bypass the cache,
+ * and that the statistics account for all of it.
+ */
+
+#include <ztest.h>
+
+/* size of the block descriptor hidden in front of each allocation */
+#define DESC_SIZE (sizeof(struct k_mem_block))
+
+#define CLASS_BLOCK_SIZE(i) (32 << (i))
+#define CLASS_MAX_REQ(i) (CLASS_BLOCK_SIZE(i) - DESC_SIZE)
+
+#define MAX_BLOCKS (CONFIG_HEAP_MEM_POOL_SIZE / CLASS_BLOCK_SIZE(0))
+
+static void *blocks[MAX_BLOCKS];
+
+static void get_stats(unsigned int class_idx, struct k_heap_cache_stats *stats)
+{
+	zassert_equal(k_heap_cache_stats_get(class_idx, stats), 0, NULL);
+}
+
+void test_mheap_cache_reuse(void)
+{
+	struct k_heap_cache_stats before, after;
+	void *block, *block2;
+
+	get_stats(0, &before);
+
+	block = k_malloc(20);
+	zassert_not_null(block, NULL);
+
+	get_stats(0, &after);
+	zassert_equal(after.num_used, before.num_used + 1, NULL);
+	zassert_equal(after.bytes_requested,
+		      before.bytes_requested + 20 + DESC_SIZE, NULL);
+
+	k_free(block);
+
+	/* the block just freed is the first one given back */
+	block2 = k_malloc(20);
+	zassert_equal(block2, block, NULL);
+
+	get_stats(0, &after);
+	zassert_true(after.hits > before.hits, NULL);
+
+	k_free(block2);
+
+	get_stats(0, &after);
+	zassert_equal(after.num_used, before.num_used, NULL);
+	zassert_equal(after.bytes_requested, before.bytes_requested, NULL);
+}
+
+void test_mheap_cache_classes(void)
+{
+	struct k_heap_cache_stats before, after;
+	unsigned int i;
+	void *block;
+
+	for (i = 0; i < K_HEAP_CACHE_NUM_CLASSES; i++) {
+		get_stats(i, &before);
+		zassert_equal(before.block_size, CLASS_BLOCK_SIZE(i), NULL);
+
+		block = k_malloc(CLASS_MAX_REQ(i));
+		zassert_not_null(block, NULL);
+		zassert_true(((u32_t)block & 3) == 0, NULL);
+
+		get_stats(i, &after);
+		zassert_equal(after.num_used, before.num_used + 1, NULL);
+		zassert_true(after.num_blocks >= after.num_used, NULL);
+		zassert_equal(after.hits + after.refills,
+			      before.hits + before.refills + 1, NULL);
+
+		k_free(block);
+
+		get_stats(i, &after);
+		zassert_equal(after.num_used, before.num_used, NULL);
+	}
+
+	zassert_equal(k_heap_cache_stats_get(K_HEAP_CACHE_NUM_CLASSES,
+					     &after), -EINVAL, NULL);
+}
+
+void test_mheap_cache_bypass(void)
+{
+	struct k_heap_cache_stats before[K_HEAP_CACHE_NUM_CLASSES];
+	struct k_heap_cache_stats after;
+	unsigned int i;
+	void *block;
+
+	for (i = 0; i < K_HEAP_CACHE_NUM_CLASSES; i++) {
+		get_stats(i, &before[i]);
+	}
+
+	/* too large for any size class */
+	block = k_malloc(CLASS_MAX_REQ(K_HEAP_CACHE_NUM_CLASSES - 1) + 1);
+	zassert_not_null(block, NULL);
+	k_free(block);
+
+	for (i = 0; i < K_HEAP_CACHE_NUM_CLASSES; i++) {
+		get_stats(i, &after);
+		zassert_equal(after.hits, before[i].hits, NULL);
+		zassert_equal(after.refills, before[i].refills, NULL);
+		zassert_equal(after.misses, before[i].misses, NULL);
+	}
+}
+
+void test_mheap_cache_exhaust(void)
+{
+	unsigned int last = K_HEAP_CACHE_NUM_CLASSES - 1;
+	struct k_heap_cache_stats before, after;
+	int i, count = 0;
+
+	get_stats(last, &before);
+
+	/* the largest class takes whole blocks from the pool until none is left */
+	while (count < MAX_BLOCKS) {
+		blocks[count] = k_malloc(CLASS_MAX_REQ(last));
+		if (!blocks[count]) {
+			break;
+		}
+		count++;
+	}
+
+	zassert_true(count > 0 && count < MAX_BLOCKS, NULL);
+
+	get_stats(last, &after);
+	zassert_equal(after.misses, before.misses + 1, NULL);
+	zassert_equal(after.num_used, before.num_used + count, NULL);
+	zassert_equal(after.num_blocks, after.num_used, NULL);
+
+	for (i = 0; i < count; i++) {
+		k_free(blocks[i]);
+	}
+
+	get_stats(last, &after);
+	zassert_equal(after.num_used, before.num_used, NULL);
+
+	/* freed blocks stay in the class */
+	blocks[0] = k_malloc(CLASS_MAX_REQ(last));
+	zassert_not_null(blocks[0], NULL);
+	k_free(blocks[0]);
+}
+
+/*test case main entry*/
+void test_main(void *p1, void *p2, void *p3)
+{
+	ztest_test_suite(test_mheap_cache,
+			 ztest_unit_test(test_mheap_cache_reuse),
+			 ztest_unit_test(test_mheap_cache_classes),
+			 ztest_unit_test(test_mheap_cache_bypass),
+			 ztest_unit_test(test_mheap_cache_exhaust));
+	ztest_run_test_suite(test_mheap_cache);
+}
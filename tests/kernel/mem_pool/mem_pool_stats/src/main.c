@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Test the allocation statistics of memory pools
+ *
+ * - API coverage
+ *   - k_mem_pool_stats_get
+ *   - k_mem_pool_stats_reset
+ */
+
+#include <ztest.h>
+
+#define BLK_SIZE_MIN 16
+#define BLK_SIZE_MAX 64
+#define BLK_NUM_MAX 2
+#define BLK_ALIGN 4
+#define WAIT_TIME 20
+
+K_MEM_POOL_DEFINE(kmpool, BLK_SIZE_MIN, BLK_SIZE_MAX, BLK_NUM_MAX, BLK_ALIGN);
+
+void test_mpool_stats(void)
+{
+	struct k_mem_alloc_stats stats;
+	struct k_mem_block block[2], fail;
+
+	/* usage is counted in size of the blocks, not the size requested */
+	zassert_equal(k_mem_pool_alloc(&kmpool, &block[0], BLK_SIZE_MIN + 1,
+				       K_NO_WAIT), 0, NULL);
+	zassert_equal(k_mem_pool_alloc(&kmpool, &block[1], BLK_SIZE_MIN,
+				       K_NO_WAIT), 0, NULL);
+
+	k_mem_pool_stats_get(&kmpool, &stats);
+	zassert_equal(stats.num_allocs, 2, NULL);
+	zassert_equal(stats.used, BLK_SIZE_MAX + BLK_SIZE_MIN, NULL);
+	zassert_equal(stats.max_used, stats.used, NULL);
+
+	/* no maximum sized block is left */
+	zassert_equal(k_mem_pool_alloc(&kmpool, &fail, BLK_SIZE_MAX,
+				       K_NO_WAIT), -ENOMEM, NULL);
+	zassert_equal(k_mem_pool_alloc(&kmpool, &fail, BLK_SIZE_MAX,
+				       WAIT_TIME), -EAGAIN, NULL);
+
+	k_mem_pool_stats_get(&kmpool, &stats);
+	zassert_equal(stats.num_failures, 2, NULL);
+	zassert_equal(stats.num_waits, 1, NULL);
+	zassert_true(stats.wait_time > 0, NULL);
+
+	k_mem_pool_free(&block[0]);
+	k_mem_pool_free(&block[1]);
+
+	k_mem_pool_stats_get(&kmpool, &stats);
+	zassert_equal(stats.num_frees, 2, NULL);
+	zassert_equal(stats.used, 0, NULL);
+	zassert_equal(stats.max_used, BLK_SIZE_MAX + BLK_SIZE_MIN, NULL);
+
+	k_mem_pool_stats_reset(&kmpool);
+
+	k_mem_pool_stats_get(&kmpool, &stats);
+	zassert_equal(stats.num_allocs, 0, NULL);
+	zassert_equal(stats.num_failures, 0, NULL);
+	zassert_equal(stats.num_waits, 0, NULL);
+	zassert_equal(stats.wait_time, 0, NULL);
+	zassert_equal(stats.max_used, 0, NULL);
+}
+
+/*test case main entry*/
+void test_main(void *p1, void *p2, void *p3)
+{
+	ztest_test_suite(test_mpool_stats,
+			 ztest_unit_test(test_mpool_stats));
+	ztest_run_test_suite(test_mpool_stats);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Test the allocation statistics of memory slabs
+ *
+ * - API coverage
+ *   - k_mem_slab_stats_get
+ *   - k_mem_slab_stats_reset
+ */
+
+#include <ztest.h>
+
+#define BLK_NUM 4
+#define BLK_SIZE 16
+#define BLK_ALIGN 4
+#define WAIT_TIME 20
+#define STACK_SIZE 512
+
+K_MEM_SLAB_DEFINE(kmslab, BLK_SIZE, BLK_NUM, BLK_ALIGN);
+
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static struct k_thread tdata;
+
+static void *block[BLK_NUM];
+
+static void tfree_later(void *p1, void *p2, void *p3)
+{
+	k_sleep(WAIT_TIME);
+	k_mem_slab_free(&kmslab, &block[0]);
+}
+
+void test_mslab_stats_alloc_free(void)
+{
+	struct k_mem_alloc_stats stats;
+	void *fail;
+	int i;
+
+	for (i = 0; i < BLK_NUM; i++) {
+		zassert_equal(k_mem_slab_alloc(&kmslab, &block[i], K_NO_WAIT),
+			      0, NULL);
+	}
+
+	zassert_equal(k_mem_slab_alloc(&kmslab, &fail, K_NO_WAIT), -ENOMEM,
+		      NULL);
+
+	for (i = 0; i < BLK_NUM / 2; i++) {
+		k_mem_slab_free(&kmslab, &block[i]);
+	}
+
+	k_mem_slab_stats_get(&kmslab, &stats);
+	zassert_equal(stats.num_allocs, BLK_NUM, NULL);
+	zassert_equal(stats.num_frees, BLK_NUM / 2, NULL);
+	zassert_equal(stats.num_failures, 1, NULL);
+	zassert_equal(stats.used, BLK_NUM / 2, NULL);
+	zassert_equal(stats.used, k_mem_slab_num_used_get(&kmslab), NULL);
+	zassert_equal(stats.max_used, BLK_NUM, NULL);
+	zassert_equal(stats.num_waits, 0, NULL);
+
+	k_mem_slab_stats_reset(&kmslab);
+
+	k_mem_slab_stats_get(&kmslab, &stats);
+	zassert_equal(stats.num_allocs, 0, NULL);
+	zassert_equal(stats.num_frees, 0, NULL);
+	zassert_equal(stats.num_failures, 0, NULL);
+	zassert_equal(stats.used, BLK_NUM / 2, NULL);
+	zassert_equal(stats.max_used, BLK_NUM / 2, NULL);
+
+	for (i = 0; i < BLK_NUM / 2; i++) {
+		zassert_equal(k_mem_slab_alloc(&kmslab, &block[i], K_NO_WAIT),
+			      0, NULL);
+	}
+}
+
+void test_mslab_stats_wait(void)
+{
+	struct k_mem_alloc_stats before, after;
+	void *blk;
+	int i;
+
+	/* the slab is full: a timed out allocation waits then fails */
+	k_mem_slab_stats_get(&kmslab, &before);
+	zassert_equal(k_mem_slab_alloc(&kmslab, &blk, WAIT_TIME), -EAGAIN,
+		      NULL);
+
+	k_mem_slab_stats_get(&kmslab, &after);
+	zassert_equal(after.num_failures, before.num_failures + 1, NULL);
+	zassert_equal(after.num_waits, before.num_waits + 1, NULL);
+	zassert_true(after.wait_time > before.wait_time, NULL);
+
+	/* a block freed by another thread is handed to the waiting one */
+	before = after;
+	k_thread_create(&tdata, tstack, STACK_SIZE, tfree_later,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+	zassert_equal(k_mem_slab_alloc(&kmslab, &blk, K_FOREVER), 0, NULL);
+
+	k_mem_slab_stats_get(&kmslab, &after);
+	zassert_equal(after.num_allocs, before.num_allocs + 1, NULL);
+	zassert_equal(after.num_frees, before.num_frees + 1, NULL);
+	zassert_equal(after.num_waits, before.num_waits + 1, NULL);
+	zassert_equal(after.used, before.used, NULL);
+	zassert_true(after.wait_time > before.wait_time, NULL);
+
+	block[0] = blk;
+	for (i = 0; i < BLK_NUM; i++) {
+		k_mem_slab_free(&kmslab, &block[i]);
+	}
+
+	k_mem_slab_stats_get(&kmslab, &after);
+	zassert_equal(after.used, 0, NULL);
+}
+
+/*test case main entry*/
+void test_main(void *p1, void *p2, void *p3)
+{
+	ztest_test_suite(test_mslab_stats,
+			 ztest_unit_test(test_mslab_stats_alloc_free),
+			 ztest_unit_test(test_mslab_stats_wait));
+	ztest_run_test_suite(test_mslab_stats);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_msgq_api
+ * @{
+ * @defgroup t_msgq_batch test_msgq_batch
+ * @brief TestPurpose: verify zephyr msgq batch put and get
+ * @}
+ */
+
+#include "test_msgq.h"
+
+#define BATCH_LEN 8
+#define NUM_WAITERS 2
+
+static K_THREAD_STACK_ARRAY_DEFINE(tstack, NUM_WAITERS, STACK_SIZE);
+static struct k_thread tdata[NUM_WAITERS];
+static char __aligned(4) tbuffer[MSG_SIZE * BATCH_LEN];
+static struct k_msgq msgq;
+static u32_t tx_data[2 * BATCH_LEN];
+static u32_t rx_data[2 * BATCH_LEN];
+static u32_t waiter_data[NUM_WAITERS];
+static int waiter_ret[NUM_WAITERS];
+
+static void fill_tx_data(u32_t first)
+{
+	for (int i = 0; i < ARRAY_SIZE(tx_data); i++) {
+		tx_data[i] = first + i;
+	}
+}
+
+static void check_rx_data(int count, u32_t first)
+{
+	for (int i = 0; i < count; i++) {
+		zassert_equal(rx_data[i], first + i, NULL);
+	}
+}
+
+static void tget_entry(void *p1, void *p2, void *p3)
+{
+	int i = (int)p1;
+
+	waiter_ret[i] = k_msgq_get(&msgq, &waiter_data[i], K_FOREVER);
+}
+
+static void tput_entry(void *p1, void *p2, void *p3)
+{
+	int i = (int)p1;
+
+	waiter_ret[i] = k_msgq_put(&msgq, &waiter_data[i], K_FOREVER);
+}
+
+static void spawn_waiters(k_thread_entry_t entry)
+{
+	for (int i = 0; i < NUM_WAITERS; i++) {
+		waiter_ret[i] = 1;
+		k_thread_create(&tdata[i], tstack[i], STACK_SIZE,
+				entry, (void *)i, NULL, NULL,
+				K_PRIO_PREEMPT(0), 0, 0);
+	}
+
+	/* let them pend on the queue */
+	k_sleep(TIMEOUT >> 1);
+}
+
+/*test cases*/
+void test_msgq_batch(void)
+{
+	int ret;
+
+	k_msgq_init(&msgq, tbuffer, MSG_SIZE, BATCH_LEN);
+	fill_tx_data(0);
+
+	/**TESTPOINT: batch put stops when the queue is full*/
+	ret = k_msgq_put_n(&msgq, tx_data, 5, K_NO_WAIT);
+	zassert_equal(ret, 5, NULL);
+	ret = k_msgq_put_n(&msgq, &tx_data[5], 5, K_NO_WAIT);
+	zassert_equal(ret, 3, NULL);
+	zassert_equal(k_msgq_num_used_get(&msgq), BATCH_LEN, NULL);
+	ret = k_msgq_put_n(&msgq, tx_data, 1, K_NO_WAIT);
+	zassert_equal(ret, -ENOMSG, NULL);
+
+	/**TESTPOINT: batch get returns messages in order*/
+	ret = k_msgq_get_n(&msgq, rx_data, 6, K_NO_WAIT);
+	zassert_equal(ret, 6, NULL);
+	check_rx_data(6, 0);
+
+	/**TESTPOINT: batch put and get wrap around the ring buffer*/
+	ret = k_msgq_put_n(&msgq, &tx_data[BATCH_LEN], 5, K_NO_WAIT);
+	zassert_equal(ret, 5, NULL);
+	ret = k_msgq_get_n(&msgq, rx_data, ARRAY_SIZE(rx_data), K_NO_WAIT);
+	zassert_equal(ret, 7, NULL);
+	check_rx_data(7, 6);
+
+	/**TESTPOINT: batch get on an empty queue*/
+	ret = k_msgq_get_n(&msgq, rx_data, BATCH_LEN, K_NO_WAIT);
+	zassert_equal(ret, -ENOMSG, NULL);
+	ret = k_msgq_get_n(&msgq, rx_data, BATCH_LEN, TIMEOUT);
+	zassert_equal(ret, -EAGAIN, NULL);
+}
+
+void test_msgq_batch_waiters(void)
+{
+	int ret;
+
+	k_msgq_init(&msgq, tbuffer, MSG_SIZE, BATCH_LEN);
+	fill_tx_data(MSG0);
+
+	/**TESTPOINT: batch put feeds the waiting receivers first*/
+	spawn_waiters(tget_entry);
+	ret = k_msgq_put_n(&msgq, tx_data, 4, K_NO_WAIT);
+	zassert_equal(ret, 4, NULL);
+	k_sleep(TIMEOUT >> 1);
+	for (int i = 0; i < NUM_WAITERS; i++) {
+		zassert_equal(waiter_ret[i], 0, NULL);
+		zassert_equal(waiter_data[i], MSG0 + i, NULL);
+	}
+	zassert_equal(k_msgq_num_used_get(&msgq), 4 - NUM_WAITERS, NULL);
+	k_msgq_purge(&msgq);
+
+	/**TESTPOINT: batch get refills the queue from the waiting senders*/
+	ret = k_msgq_put_n(&msgq, tx_data, BATCH_LEN, K_NO_WAIT);
+	zassert_equal(ret, BATCH_LEN, NULL);
+	for (int i = 0; i < NUM_WAITERS; i++) {
+		waiter_data[i] = MSG0 + BATCH_LEN + i;
+	}
+	spawn_waiters(tput_entry);
+	ret = k_msgq_get_n(&msgq, rx_data, BATCH_LEN, K_NO_WAIT);
+	zassert_equal(ret, BATCH_LEN, NULL);
+	check_rx_data(BATCH_LEN, MSG0);
+	k_sleep(TIMEOUT >> 1);
+	for (int i = 0; i < NUM_WAITERS; i++) {
+		zassert_equal(waiter_ret[i], 0, NULL);
+	}
+	ret = k_msgq_get_n(&msgq, rx_data, BATCH_LEN, K_NO_WAIT);
+	zassert_equal(ret, NUM_WAITERS, NULL);
+	check_rx_data(NUM_WAITERS, MSG0 + BATCH_LEN);
+}
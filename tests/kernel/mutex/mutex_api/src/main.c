@@ -18,6 +18,8 @@ extern void test_mutex_reent_lock_forever(void);
 extern void test_mutex_reent_lock_no_wait(void);
 extern void test_mutex_reent_lock_timeout_fail(void);
 extern void test_mutex_reent_lock_timeout_pass(void);
+extern void test_mutex_prio_inheritance_chain(void);
+extern void test_mutex_prio_ceiling(void);
 
 /*test case main entry*/
 void test_main(void *p1, void *p2, void *p3)
@@ -27,7 +29,9 @@ void test_main(void *p1, void *p2, void *p3)
 			 ztest_unit_test(test_mutex_reent_lock_forever),
 			 ztest_unit_test(test_mutex_reent_lock_no_wait),
 			 ztest_unit_test(test_mutex_reent_lock_timeout_fail),
-			 ztest_unit_test(test_mutex_reent_lock_timeout_pass)
+			 ztest_unit_test(test_mutex_reent_lock_timeout_pass),
+			 ztest_unit_test(test_mutex_prio_inheritance_chain),
+			 ztest_unit_test(test_mutex_prio_ceiling)
 			 );
 	ztest_run_test_suite(test_mutex_api);
 }
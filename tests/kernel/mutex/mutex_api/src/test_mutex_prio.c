@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_mutex_api
+ * @{
+ * @defgroup t_mutex_prio test_mutex_prio
+ * @brief TestPurpose: verify priority inheritance along a chain of mutex
+ *                     owners, the priority ceiling and the statistics
+ * - API coverage
+ *   -# k_mutex_lock k_mutex_unlock
+ *   -# k_mutex_ceiling_set
+ *   -# k_mutex_stats_get k_mutex_stats_reset
+ * @}
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE 512
+#define WAIT_TIMEOUT 200
+
+#define PRIO_TEST K_PRIO_PREEMPT(2)
+#define PRIO_HIGH K_PRIO_PREEMPT(5)
+#define PRIO_MED K_PRIO_PREEMPT(8)
+#define PRIO_LOW K_PRIO_PREEMPT(10)
+
+K_MUTEX_DEFINE(mutex_outer);
+K_MUTEX_DEFINE(mutex_inner);
+K_SEM_DEFINE(sem_release, 0, 1);
+
+static K_THREAD_STACK_DEFINE(stack_low, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(stack_med, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(stack_high, STACK_SIZE);
+static struct k_thread thread_low, thread_med, thread_high;
+
+static int high_ret;
+
+/* owns the inner mutex until told to release it */
+static void low_entry(void *p1, void *p2, void *p3)
+{
+	k_mutex_lock(&mutex_inner, K_FOREVER);
+	k_sem_take(&sem_release, K_FOREVER);
+	k_mutex_unlock(&mutex_inner);
+}
+
+/* owns the outer mutex, and waits for the inner one */
+static void med_entry(void *p1, void *p2, void *p3)
+{
+	k_mutex_lock(&mutex_outer, K_FOREVER);
+	k_mutex_lock(&mutex_inner, K_FOREVER);
+	k_mutex_unlock(&mutex_inner);
+	k_mutex_unlock(&mutex_outer);
+}
+
+/* waits in vain for the outer mutex */
+static void high_entry(void *p1, void *p2, void *p3)
+{
+	high_ret = k_mutex_lock(&mutex_outer, WAIT_TIMEOUT);
+}
+
+void test_mutex_prio_inheritance_chain(void)
+{
+	k_tid_t low, med;
+	int prio = k_thread_priority_get(k_current_get());
+
+	k_thread_priority_set(k_current_get(), PRIO_TEST);
+
+#ifdef CONFIG_MUTEX_STATS
+	k_mutex_stats_reset(&mutex_outer);
+	k_mutex_stats_reset(&mutex_inner);
+#endif
+
+	low = k_thread_create(&thread_low, stack_low, STACK_SIZE,
+			      low_entry, NULL, NULL, NULL,
+			      PRIO_LOW, 0, K_NO_WAIT);
+	k_sleep(50);
+
+	/**TESTPOINT: the owner inherits the priority of the waiter */
+	med = k_thread_create(&thread_med, stack_med, STACK_SIZE,
+			      med_entry, NULL, NULL, NULL,
+			      PRIO_MED, 0, K_NO_WAIT);
+	k_sleep(50);
+	zassert_equal(k_thread_priority_get(low), PRIO_MED, NULL);
+
+	/**TESTPOINT: the inheritance goes through the waiting owner */
+	k_thread_create(&thread_high, stack_high, STACK_SIZE,
+			high_entry, NULL, NULL, NULL,
+			PRIO_HIGH, 0, K_NO_WAIT);
+	k_sleep(50);
+	zassert_equal(k_thread_priority_get(med), PRIO_HIGH, NULL);
+	zassert_equal(k_thread_priority_get(low), PRIO_HIGH, NULL);
+
+	/**TESTPOINT: the timeout of the waiter undoes it down the chain */
+	k_sleep(WAIT_TIMEOUT + 50);
+	zassert_equal(high_ret, -EAGAIN, NULL);
+	zassert_equal(k_thread_priority_get(med), PRIO_MED, NULL);
+	zassert_equal(k_thread_priority_get(low), PRIO_MED, NULL);
+
+	k_sem_give(&sem_release);
+	k_sleep(50);
+	zassert_equal(k_thread_priority_get(low), PRIO_LOW, NULL);
+	zassert_is_null(mutex_outer.owner, NULL);
+	zassert_is_null(mutex_inner.owner, NULL);
+
+#ifdef CONFIG_MUTEX_STATS
+	struct k_mutex_stats stats;
+
+	/**TESTPOINT: the contended and timed out locks are counted */
+	k_mutex_stats_get(&mutex_outer, &stats);
+	zassert_equal(stats.num_locks, 1, NULL);
+	zassert_equal(stats.num_contended, 1, NULL);
+	zassert_true(stats.max_wait_time > 0, NULL);
+
+	k_mutex_stats_get(&mutex_inner, &stats);
+	zassert_equal(stats.num_locks, 2, NULL);
+	zassert_equal(stats.num_contended, 1, NULL);
+	zassert_true(stats.max_hold_time >= stats.max_wait_time, NULL);
+#endif
+
+	k_thread_priority_set(k_current_get(), prio);
+}
+
+#ifdef CONFIG_MUTEX_PRIORITY_CEILING
+void test_mutex_prio_ceiling(void)
+{
+	struct k_mutex mutex;
+	int prio = k_thread_priority_get(k_current_get());
+
+	k_thread_priority_set(k_current_get(), PRIO_LOW);
+
+	k_mutex_init(&mutex);
+	k_mutex_ceiling_set(&mutex, PRIO_HIGH);
+
+	/**TESTPOINT: the owner runs at the ceiling until it unlocks */
+	zassert_equal(k_mutex_lock(&mutex, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_thread_priority_get(k_current_get()), PRIO_HIGH, NULL);
+	zassert_equal(k_mutex_lock(&mutex, K_NO_WAIT), 0, NULL);
+	k_mutex_unlock(&mutex);
+	zassert_equal(k_thread_priority_get(k_current_get()), PRIO_HIGH, NULL);
+	k_mutex_unlock(&mutex);
+	zassert_equal(k_thread_priority_get(k_current_get()), PRIO_LOW, NULL);
+
+	k_thread_priority_set(k_current_get(), prio);
+}
+#else
+void test_mutex_prio_ceiling(void)
+{
+	TC_PRINT("mutex priority ceiling not enabled, skipped\n");
+}
+#endif
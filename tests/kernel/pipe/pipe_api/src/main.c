@@ -18,6 +18,11 @@ extern void test_pipe_get_fail(void);
 extern void test_pipe_block_put(void);
 extern void test_pipe_block_put_sema(void);
 extern void test_pipe_get_put(void);
+extern void test_pipe_block_get_waiting_reader(void);
+extern void test_pipe_block_get_put_no_wait(void);
+extern void test_pipe_block_get_no_block(void);
+extern void test_pipe_block_get_waiting_writer(void);
+extern void test_pipe_block_get_copy(void);
 
 /*test case main entry*/
 void test_main(void *p1, void *p2, void *p3)
@@ -28,6 +33,11 @@ void test_main(void *p1, void *p2, void *p3)
 			 ztest_unit_test(test_pipe_get_fail),
 			 ztest_unit_test(test_pipe_block_put),
 			 ztest_unit_test(test_pipe_block_put_sema),
-			 ztest_unit_test(test_pipe_get_put));
+			 ztest_unit_test(test_pipe_get_put),
+			 ztest_unit_test(test_pipe_block_get_waiting_reader),
+			 ztest_unit_test(test_pipe_block_get_put_no_wait),
+			 ztest_unit_test(test_pipe_block_get_no_block),
+			 ztest_unit_test(test_pipe_block_get_waiting_writer),
+			 ztest_unit_test(test_pipe_block_get_copy));
 	ztest_run_test_suite(test_pipe_api);
 }
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_pipe_api
+ * @{
+ * @defgroup t_pipe_block_get test_pipe_block_get
+ * @brief TestPurpose: verify memory blocks are passed through pipes
+ * without copying their data when possible
+ * - API coverage
+ *   -# k_pipe_block_get
+ *   -# k_pipe_block_put
+ *   -# k_pipe_put
+ * @}
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE 1024
+#define BLK_SIZE 16
+#define BLK_NUM 4
+#define PIPE_LEN 16
+
+K_MEM_POOL_DEFINE(bpool, BLK_SIZE, BLK_SIZE, BLK_NUM, 4);
+
+static unsigned char __aligned(4) pipe_buf[PIPE_LEN];
+static struct k_pipe bpipe;
+
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static struct k_thread tdata;
+
+static const char msg[] = "zero-copy";
+
+static struct k_mem_block rx_block;
+static size_t rx_bytes;
+static int rx_ret;
+
+static struct k_sem put_sema;
+
+static void block_put(struct k_pipe *ppipe, void **data)
+{
+	struct k_mem_block block;
+
+	k_sem_init(&put_sema, 0, 1);
+
+	zassert_equal(k_mem_pool_alloc(&bpool, &block, BLK_SIZE, K_NO_WAIT),
+		      0, NULL);
+	memcpy(block.data, msg, sizeof(msg));
+	*data = block.data;
+
+	k_pipe_block_put(ppipe, &block, sizeof(msg), &put_sema);
+}
+
+static void tThread_block_get(void *p1, void *p2, void *p3)
+{
+	rx_ret = k_pipe_block_get((struct k_pipe *)p1, &bpool, &rx_block,
+				  BLK_SIZE, &rx_bytes, K_FOREVER);
+}
+
+static void check_rx(int copied, void *data)
+{
+	zassert_equal(rx_ret, 0, NULL);
+	zassert_equal(rx_bytes, sizeof(msg), NULL);
+	zassert_false(memcmp(rx_block.data, msg, sizeof(msg)), NULL);
+	if (copied) {
+		zassert_not_equal(rx_block.data, data, NULL);
+	} else {
+		zassert_equal(rx_block.data, data, NULL);
+	}
+
+	k_mem_pool_free(&rx_block);
+}
+
+/*test cases*/
+void test_pipe_block_get_waiting_reader(void)
+{
+	void *data;
+
+	k_pipe_init(&bpipe, NULL, 0);
+
+	/**TESTPOINT: a waiting block reader is handed the block itself*/
+	k_tid_t tid = k_thread_create(&tdata, tstack, STACK_SIZE,
+				      tThread_block_get, &bpipe, NULL, NULL,
+				      K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(10);
+
+	block_put(&bpipe, &data);
+	zassert_equal(k_sem_take(&put_sema, K_NO_WAIT), 0, NULL);
+	k_sleep(10);
+
+	check_rx(0, data);
+
+	k_thread_abort(tid);
+}
+
+void test_pipe_block_get_put_no_wait(void)
+{
+	size_t written;
+
+	k_pipe_init(&bpipe, NULL, 0);
+
+	/**TESTPOINT: a waiting block reader takes the data of a writer
+	 * which does not wait, in a new block
+	 */
+	k_tid_t tid = k_thread_create(&tdata, tstack, STACK_SIZE,
+				      tThread_block_get, &bpipe, NULL, NULL,
+				      K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(10);
+
+	zassert_equal(k_pipe_put(&bpipe, (void *)msg, sizeof(msg), &written,
+				 sizeof(msg), K_NO_WAIT), 0, NULL);
+	zassert_equal(written, sizeof(msg), NULL);
+	k_sleep(10);
+
+	check_rx(1, (void *)msg);
+
+	k_thread_abort(tid);
+}
+
+void test_pipe_block_get_no_block(void)
+{
+	struct k_mem_block blocks[BLK_NUM];
+	size_t written;
+	int i;
+
+	k_pipe_init(&bpipe, pipe_buf, sizeof(msg) / 2);
+
+	k_tid_t tid = k_thread_create(&tdata, tstack, STACK_SIZE,
+				      tThread_block_get, &bpipe, NULL, NULL,
+				      K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(10);
+
+	for (i = 0; i < BLK_NUM; i++) {
+		zassert_equal(k_mem_pool_alloc(&bpool, &blocks[i], BLK_SIZE,
+					       K_NO_WAIT), 0, NULL);
+	}
+
+	/**TESTPOINT: a block reader without a block does not count
+	 * towards an all-or-nothing write
+	 */
+	zassert_equal(k_pipe_put(&bpipe, (void *)msg, sizeof(msg), &written,
+				 sizeof(msg), K_NO_WAIT), -EIO, NULL);
+	zassert_equal(written, 0, NULL);
+
+	for (i = 0; i < BLK_NUM; i++) {
+		k_mem_pool_free(&blocks[i]);
+	}
+
+	zassert_equal(k_pipe_put(&bpipe, (void *)msg, sizeof(msg), &written,
+				 sizeof(msg), K_NO_WAIT), 0, NULL);
+	zassert_equal(written, sizeof(msg), NULL);
+	k_sleep(10);
+
+	check_rx(1, (void *)msg);
+
+	k_thread_abort(tid);
+}
+
+void test_pipe_block_get_waiting_writer(void)
+{
+	void *data;
+
+	k_pipe_init(&bpipe, NULL, 0);
+
+	/**TESTPOINT: a block reader takes over the block of a writer*/
+	block_put(&bpipe, &data);
+	zassert_equal(k_sem_take(&put_sema, K_NO_WAIT), -EBUSY, NULL);
+
+	rx_ret = k_pipe_block_get(&bpipe, &bpool, &rx_block, BLK_SIZE,
+				  &rx_bytes, K_NO_WAIT);
+	zassert_equal(k_sem_take(&put_sema, K_NO_WAIT), 0, NULL);
+	check_rx(0, data);
+}
+
+void test_pipe_block_get_copy(void)
+{
+	size_t written;
+
+	k_pipe_init(&bpipe, pipe_buf, PIPE_LEN);
+
+	/**TESTPOINT: data from the pipe's buffer is copied to a new block*/
+	zassert_equal(k_pipe_put(&bpipe, (void *)msg, sizeof(msg), &written,
+				 sizeof(msg), K_NO_WAIT), 0, NULL);
+
+	rx_ret = k_pipe_block_get(&bpipe, &bpool, &rx_block, BLK_SIZE,
+				  &rx_bytes, K_NO_WAIT);
+	check_rx(1, (void *)msg);
+
+	/**TESTPOINT: return -EIO without waiting if no data*/
+	zassert_equal(k_pipe_block_get(&bpipe, &bpool, &rx_block, BLK_SIZE,
+				       &rx_bytes, K_NO_WAIT), -EIO, NULL);
+	zassert_equal(rx_bytes, 0, NULL);
+
+	/**TESTPOINT: return -EAGAIN if no data when timed out*/
+	zassert_equal(k_pipe_block_get(&bpipe, &bpool, &rx_block, BLK_SIZE,
+				       &rx_bytes, 10), -EAGAIN, NULL);
+}
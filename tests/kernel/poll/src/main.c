@@ -15,6 +15,9 @@
 extern void test_poll_no_wait(void);
 extern void test_poll_wait(void);
 extern void test_poll_eaddrinuse(void);
+extern void test_poll_set_edge(void);
+extern void test_poll_set_wait(void);
+extern void test_poll_set_eaddrinuse(void);
 
 /*test case main entry*/
 void test_main(void *p1, void *p2, void *p3)
@@ -23,6 +26,9 @@ void test_main(void *p1, void *p2, void *p3)
 			 , ztest_unit_test(test_poll_no_wait)
 			 , ztest_unit_test(test_poll_wait)
 			 , ztest_unit_test(test_poll_eaddrinuse)
+			 , ztest_unit_test(test_poll_set_edge)
+			 , ztest_unit_test(test_poll_set_wait)
+			 , ztest_unit_test(test_poll_set_eaddrinuse)
 			 );
 	ztest_run_test_suite(test_poll_api);
 }
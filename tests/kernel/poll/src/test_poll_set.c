@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_poll_api
+ * @{
+ * @defgroup t_poll_api_set test_poll_api_set
+ * @brief TestPurpose: verify zephyr poll set apis
+ * - API coverage
+ *   -# k_poll_set_init
+ *   -# k_poll_set_add k_poll_set_remove
+ *   -# k_poll_set_wait
+ * @}
+ */
+
+#include <ztest.h>
+#include <kernel.h>
+
+#define STACK_SIZE 512
+#define TIMEOUT 100
+
+struct fifo_msg {
+	void *private;
+	u32_t msg;
+};
+
+static struct k_poll_set set;
+static struct k_sem set_sem;
+static struct k_fifo set_fifo;
+static struct k_poll_signal set_signal;
+static struct k_poll_event set_events[3];
+
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static struct k_thread tdata;
+
+static void init_set(void)
+{
+	k_sem_init(&set_sem, 0, 1);
+	k_fifo_init(&set_fifo);
+	k_poll_signal_init(&set_signal);
+
+	k_poll_event_init(&set_events[0], K_POLL_TYPE_SEM_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &set_sem);
+	k_poll_event_init(&set_events[1], K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &set_fifo);
+	k_poll_event_init(&set_events[2], K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &set_signal);
+
+	k_poll_set_init(&set);
+	for (int i = 0; i < ARRAY_SIZE(set_events); i++) {
+		zassert_equal(k_poll_set_add(&set, &set_events[i]), 0, "");
+	}
+}
+
+static void fini_set(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(set_events); i++) {
+		k_poll_set_remove(&set, &set_events[i]);
+	}
+}
+
+/* verify events are reported once per signal, in signal order */
+void test_poll_set_edge(void)
+{
+	struct fifo_msg msg[3] = { { NULL, 0 }, { NULL, 1 }, { NULL, 2 } };
+	struct k_poll_event *ready[3];
+
+	init_set();
+
+	zassert_equal(k_poll_set_wait(&set, ready, 3, K_NO_WAIT), -EAGAIN, "");
+
+	k_poll_signal(&set_signal, 0);
+	k_fifo_put(&set_fifo, &msg[0]);
+
+	zassert_equal(k_poll_set_wait(&set, ready, 3, K_NO_WAIT), 2, "");
+	zassert_equal(ready[0], &set_events[2], "");
+	zassert_equal(ready[0]->state, K_POLL_STATE_SIGNALED, "");
+	zassert_equal(ready[1], &set_events[1], "");
+	zassert_equal(ready[1]->state, K_POLL_STATE_FIFO_DATA_AVAILABLE, "");
+
+	/* not reported again while nothing new happens, not even if the fifo
+	 * still has data
+	 */
+	zassert_equal(k_poll_set_wait(&set, ready, 3, K_NO_WAIT), -EAGAIN, "");
+
+	/* several signals of one object are reported once */
+	k_fifo_put(&set_fifo, &msg[1]);
+	k_sem_give(&set_sem);
+	k_fifo_put(&set_fifo, &msg[2]);
+	zassert_equal(k_poll_set_wait(&set, ready, 1, K_NO_WAIT), 1, "");
+	zassert_equal(ready[0], &set_events[1], "");
+	zassert_equal(k_poll_set_wait(&set, ready, 3, K_NO_WAIT), 1, "");
+	zassert_equal(ready[0], &set_events[0], "");
+	zassert_equal(ready[0]->state, K_POLL_STATE_SEM_AVAILABLE, "");
+
+	/* events stay registered across waits */
+	zassert_equal(set_sem.poll_event, &set_events[0], "");
+	zassert_equal(set_fifo._queue.poll_event, &set_events[1], "");
+
+	/* a removed event is not reported anymore */
+	k_poll_signal(&set_signal, 0);
+	k_poll_set_remove(&set, &set_events[2]);
+	zassert_equal(k_poll_set_wait(&set, ready, 3, K_NO_WAIT), -EAGAIN, "");
+	zassert_equal(k_poll_set_add(&set, &set_events[2]), 0, "");
+
+	/* an event already fulfilled when added is reported */
+	zassert_equal(k_poll_set_wait(&set, ready, 3, K_NO_WAIT), 1, "");
+	zassert_equal(ready[0], &set_events[2], "");
+
+	fini_set();
+	zassert_is_null(set_fifo._queue.poll_event, "");
+}
+
+static void signal_entry(void *p1, void *p2, void *p3)
+{
+	k_sleep(TIMEOUT >> 1);
+	k_sem_give(&set_sem);
+}
+
+/* verify a thread waiting on a set is woken up by a signaled event */
+void test_poll_set_wait(void)
+{
+	struct k_poll_event *ready[3];
+
+	init_set();
+
+	zassert_equal(k_poll_set_wait(&set, ready, 3, TIMEOUT), -EAGAIN, "");
+
+	k_thread_create(&tdata, tstack, STACK_SIZE, signal_entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+
+	zassert_equal(k_poll_set_wait(&set, ready, 3, TIMEOUT * 2), 1, "");
+	zassert_equal(ready[0], &set_events[0], "");
+	zassert_equal(k_sem_take(&set_sem, K_NO_WAIT), 0, "");
+
+	fini_set();
+}
+
+/* verify an object polled by a set cannot be polled by k_poll() */
+void test_poll_set_eaddrinuse(void)
+{
+	struct k_poll_event event;
+
+	init_set();
+
+	k_poll_event_init(&event, K_POLL_TYPE_SEM_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &set_sem);
+	zassert_equal(k_poll(&event, 1, TIMEOUT), -EADDRINUSE, "");
+	zassert_equal(k_poll_set_add(&set, &event), -EADDRINUSE, "");
+
+	fini_set();
+
+	zassert_equal(k_poll_set_add(&set, &event), 0, "");
+	k_poll_set_remove(&set, &event);
+}
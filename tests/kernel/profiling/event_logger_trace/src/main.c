@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <logging/kernel_event_logger.h>
+
+#define NUM_DUMP_RECORDS CONFIG_KERNEL_EVENT_LOGGER_TRACE_RAM_RECORDS
+#define NUM_SLEEPS 16
+
+#define CUSTOM_EVENT_ID 0x0010
+
+/*
+ * Sleep so that context switch and thread events are traced, and that the
+ * trace thread drains them to the RAM buffer. The test thread is
+ * cooperative, so the RAM buffer is not written while it is checked.
+ */
+static void trace_events(void)
+{
+	int i;
+
+	for (i = 0; i < NUM_SLEEPS; i++) {
+		k_sleep(CONFIG_KERNEL_EVENT_LOGGER_TRACE_PERIOD);
+	}
+}
+
+void test_trace_records(void)
+{
+	struct sys_k_trace_record *rec, *prev = NULL;
+	u32_t max_seq = 0, first_seq, seq;
+	int i;
+
+	trace_events();
+
+	for (i = 0; i < NUM_DUMP_RECORDS; i++) {
+		if (sys_k_trace_dump[i].seq > max_seq) {
+			max_seq = sys_k_trace_dump[i].seq;
+		}
+	}
+
+	zassert_true(max_seq >= NUM_SLEEPS, "too few events traced");
+
+	/*
+	 * the records are drained in sequence order, the latest ones are kept
+	 * and their timestamps follow their sequence numbers
+	 */
+	first_seq = max_seq > NUM_DUMP_RECORDS ?
+		max_seq - NUM_DUMP_RECORDS + 1 : 1;
+
+	for (seq = first_seq; seq <= max_seq; seq++) {
+		rec = &sys_k_trace_dump[(seq - 1) % NUM_DUMP_RECORDS];
+
+		zassert_equal(rec->seq, seq, "record missing");
+		zassert_true(rec->event_id ==
+			     KERNEL_EVENT_LOGGER_CONTEXT_SWITCH_EVENT_ID ||
+			     rec->event_id == KERNEL_EVENT_LOGGER_THREAD_EVENT_ID,
+			     "unexpected event");
+
+		if (prev) {
+			zassert_true((s32_t)(rec->timestamp - prev->timestamp) >=
+				     0, "timestamp out of order");
+		}
+
+		prev = rec;
+	}
+}
+
+void test_trace_custom_event(void)
+{
+	u32_t data[4];
+	u16_t event_id;
+	u8_t dropped, size;
+	int ret;
+
+	sys_k_event_logger_put_timed(CUSTOM_EVENT_ID);
+
+	/* custom events go to the event logger ring buffer, not the trace */
+	size = ARRAY_SIZE(data);
+	ret = sys_k_event_logger_get(&event_id, &dropped, data, &size);
+	zassert_true(ret > 0, "custom event not in the ring buffer");
+	zassert_equal(event_id, CUSTOM_EVENT_ID, "wrong event");
+	zassert_equal(size, 1, "wrong event size");
+
+	size = ARRAY_SIZE(data);
+	ret = sys_k_event_logger_get(&event_id, &dropped, data, &size);
+	zassert_equal(ret, 0, "kernel event in the ring buffer");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_event_logger_trace,
+			 ztest_unit_test(test_trace_records),
+			 ztest_unit_test(test_trace_custom_event));
+	ztest_run_test_suite(test_event_logger_trace);
+}
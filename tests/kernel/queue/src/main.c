@@ -17,6 +17,18 @@ extern void test_queue_thread2isr(void);
 extern void test_queue_isr2thread(void);
 extern void test_queue_get_fail(void);
 extern void test_queue_loop(void);
+#ifdef CONFIG_QUEUE_LOCKFREE_APPEND
+extern void test_queue_lockfree_order(void);
+extern void test_queue_lockfree_isr_wake(void);
+extern void test_queue_lockfree_peek(void);
+
+#define LOCKFREE_TESTS \
+			 ztest_unit_test(test_queue_lockfree_order), \
+			 ztest_unit_test(test_queue_lockfree_isr_wake), \
+			 ztest_unit_test(test_queue_lockfree_peek),
+#else
+#define LOCKFREE_TESTS
+#endif
 
 /*test case main entry*/
 void test_main(void *p1, void *p2, void *p3)
@@ -26,6 +38,7 @@ void test_main(void *p1, void *p2, void *p3)
 			 ztest_unit_test(test_queue_thread2isr),
 			 ztest_unit_test(test_queue_isr2thread),
 			 ztest_unit_test(test_queue_get_fail),
+			 LOCKFREE_TESTS
 			 ztest_unit_test(test_queue_loop));
 	ztest_run_test_suite(test_queue_api);
 }
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_queue_api
+ * @{
+ * @defgroup t_queue_lockfree test_queue_lockfree
+ * @brief TestPurpose: verify lock-free appends to a queue
+ * - API coverage
+ *   -# k_queue_append_lockfree
+ *   -# k_queue_append k_queue_get
+ *   -# k_queue_is_empty k_queue_peek_head k_queue_peek_tail
+ * @}
+ */
+
+#include "test_queue.h"
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define LIST_LEN 4
+#define TIMEOUT 500
+
+static struct k_queue queue;
+static qdata_t data[LIST_LEN];
+static qdata_t data_lf[LIST_LEN];
+
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static struct k_thread tdata;
+static struct k_sem end_sema;
+static void *rx_data;
+
+static void tIsr_entry_append_lockfree(void *p)
+{
+	k_queue_append_lockfree((struct k_queue *)p, (void *)&data_lf[0]);
+}
+
+static void tThread_entry(void *p1, void *p2, void *p3)
+{
+	rx_data = k_queue_get((struct k_queue *)p1, TIMEOUT);
+	k_sem_give(&end_sema);
+}
+
+/*test cases*/
+void test_queue_lockfree_order(void)
+{
+	void *rx;
+
+	k_queue_init(&queue);
+
+	/**TESTPOINT: alternate locked and lock-free appends*/
+	for (int i = 0; i < LIST_LEN; i++) {
+		k_queue_append(&queue, (void *)&data[i]);
+		k_queue_append_lockfree(&queue, (void *)&data_lf[i]);
+	}
+
+	/**TESTPOINT: items come out in the order they were appended*/
+	for (int i = 0; i < LIST_LEN; i++) {
+		rx = k_queue_get(&queue, K_NO_WAIT);
+		zassert_equal(rx, (void *)&data[i], NULL);
+		rx = k_queue_get(&queue, K_NO_WAIT);
+		zassert_equal(rx, (void *)&data_lf[i], NULL);
+	}
+	zassert_is_null(k_queue_get(&queue, K_NO_WAIT), NULL);
+}
+
+void test_queue_lockfree_isr_wake(void)
+{
+	k_queue_init(&queue);
+	k_sem_init(&end_sema, 0, 1);
+	rx_data = NULL;
+
+	k_tid_t tid = k_thread_create(&tdata, tstack, STACK_SIZE,
+				      tThread_entry, &queue, NULL, NULL,
+				      K_PRIO_PREEMPT(0), 0, 0);
+
+	/* let the consumer pend on the empty queue */
+	k_sleep(100);
+
+	/**TESTPOINT: a lock-free append from an ISR wakes the consumer*/
+	irq_offload(tIsr_entry_append_lockfree, &queue);
+	k_sem_take(&end_sema, K_FOREVER);
+	zassert_equal(rx_data, (void *)&data_lf[0], NULL);
+	zassert_true(k_queue_is_empty(&queue), NULL);
+	k_thread_abort(tid);
+}
+
+void test_queue_lockfree_peek(void)
+{
+	k_queue_init(&queue);
+	zassert_true(k_queue_is_empty(&queue), NULL);
+
+	/**TESTPOINT: an unflushed item makes the queue non-empty*/
+	k_queue_append_lockfree(&queue, (void *)&data_lf[0]);
+	zassert_false(k_queue_is_empty(&queue), NULL);
+
+	/**TESTPOINT: peek sees the unflushed items*/
+	k_queue_append_lockfree(&queue, (void *)&data_lf[1]);
+	zassert_equal(k_queue_peek_head(&queue), (void *)&data_lf[0], NULL);
+	zassert_equal(k_queue_peek_tail(&queue), (void *)&data_lf[1], NULL);
+
+	k_queue_append(&queue, (void *)&data[0]);
+	k_queue_append_lockfree(&queue, (void *)&data_lf[2]);
+	zassert_equal(k_queue_peek_head(&queue), (void *)&data_lf[0], NULL);
+	zassert_equal(k_queue_peek_tail(&queue), (void *)&data_lf[2], NULL);
+
+	zassert_equal(k_queue_get(&queue, K_NO_WAIT), (void *)&data_lf[0],
+		      NULL);
+	zassert_equal(k_queue_get(&queue, K_NO_WAIT), (void *)&data_lf[1],
+		      NULL);
+	zassert_equal(k_queue_get(&queue, K_NO_WAIT), (void *)&data[0], NULL);
+	zassert_equal(k_queue_get(&queue, K_NO_WAIT), (void *)&data_lf[2],
+		      NULL);
+	zassert_true(k_queue_is_empty(&queue), NULL);
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_rwlock
+ * @{
+ * @defgroup t_rwlock_api test_rwlock_api
+ * @}
+ */
+
+
+#include <ztest.h>
+extern void test_rwlock_readers_share(void);
+extern void test_rwlock_writer_excludes(void);
+extern void test_rwlock_writer_preferred(void);
+extern void test_rwlock_writer_inherits(void);
+
+/*test case main entry*/
+void test_main(void *p1, void *p2, void *p3)
+{
+	ztest_test_suite(test_rwlock_api,
+			 ztest_unit_test(test_rwlock_readers_share),
+			 ztest_unit_test(test_rwlock_writer_excludes),
+			 ztest_unit_test(test_rwlock_writer_preferred),
+			 ztest_unit_test(test_rwlock_writer_inherits)
+			 );
+	ztest_run_test_suite(test_rwlock_api);
+}
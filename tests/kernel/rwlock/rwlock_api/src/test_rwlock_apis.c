@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_rwlock_api
+ * @{
+ * @defgroup t_rwlock_lock test_rwlock_lock
+ * @brief TestPurpose: verify the sharing, exclusion, writer preference and
+ *                     priority inheritance of reader-writer locks
+ * - API coverage
+ *   -# k_rwlock_init K_RWLOCK_DEFINE
+ *   -# k_rwlock_read_lock [FOREVER NO_WAIT TIMEOUT]
+ *   -# k_rwlock_read_unlock
+ *   -# k_rwlock_write_lock [FOREVER NO_WAIT]
+ *   -# k_rwlock_write_unlock
+ * @}
+ */
+
+#include <ztest.h>
+
+#define TIMEOUT 100
+#define STACK_SIZE 512
+
+#define PRIO_HIGH K_PRIO_PREEMPT(5)
+#define PRIO_TEST K_PRIO_PREEMPT(8)
+
+/**TESTPOINT: init via K_RWLOCK_DEFINE*/
+K_RWLOCK_DEFINE(krwlock);
+
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(tstack2, STACK_SIZE);
+static struct k_thread tdata, tdata2;
+
+static int read_ret, write_ret;
+static volatile int writer_done;
+
+static void tThread_entry_read_write_no_wait(void *p1, void *p2, void *p3)
+{
+	read_ret = k_rwlock_read_lock((struct k_rwlock *)p1, K_NO_WAIT);
+	if (read_ret == 0) {
+		k_rwlock_read_unlock((struct k_rwlock *)p1);
+	}
+
+	write_ret = k_rwlock_write_lock((struct k_rwlock *)p1, K_NO_WAIT);
+	if (write_ret == 0) {
+		k_rwlock_write_unlock((struct k_rwlock *)p1);
+	}
+}
+
+static void tThread_entry_read_timeout(void *p1, void *p2, void *p3)
+{
+	read_ret = k_rwlock_read_lock((struct k_rwlock *)p1, TIMEOUT);
+	if (read_ret == 0) {
+		k_rwlock_read_unlock((struct k_rwlock *)p1);
+	}
+}
+
+static void tThread_entry_read_forever(void *p1, void *p2, void *p3)
+{
+	read_ret = k_rwlock_read_lock((struct k_rwlock *)p1, K_FOREVER);
+	k_rwlock_read_unlock((struct k_rwlock *)p1);
+}
+
+static void tThread_entry_write_forever(void *p1, void *p2, void *p3)
+{
+	write_ret = k_rwlock_write_lock((struct k_rwlock *)p1, K_FOREVER);
+	writer_done = 1;
+	k_rwlock_write_unlock((struct k_rwlock *)p1);
+}
+
+static void spawn(struct k_thread *thread, char *stack,
+		  k_thread_entry_t entry, struct k_rwlock *rwlock)
+{
+	k_thread_create(thread, stack, STACK_SIZE, entry, rwlock, NULL, NULL,
+			PRIO_HIGH, 0, K_NO_WAIT);
+}
+
+/*test cases*/
+void test_rwlock_readers_share(void)
+{
+	struct k_rwlock rwlock;
+	int prio = k_thread_priority_get(k_current_get());
+
+	k_thread_priority_set(k_current_get(), PRIO_TEST);
+
+	/**TESTPOINT: test k_rwlock_init rwlock*/
+	k_rwlock_init(&rwlock);
+
+	/**TESTPOINT: readers share the lock, writers are kept out*/
+	zassert_equal(k_rwlock_read_lock(&rwlock, K_FOREVER), 0, NULL);
+	spawn(&tdata, tstack, tThread_entry_read_write_no_wait, &rwlock);
+	zassert_equal(read_ret, 0, NULL);
+	zassert_equal(write_ret, -EBUSY, NULL);
+	k_rwlock_read_unlock(&rwlock);
+
+	/**TESTPOINT: the lock can be taken for writing once free*/
+	zassert_equal(k_rwlock_write_lock(&rwlock, K_NO_WAIT), 0, NULL);
+	k_rwlock_write_unlock(&rwlock);
+
+	k_thread_priority_set(k_current_get(), prio);
+}
+
+void test_rwlock_writer_excludes(void)
+{
+	int prio = k_thread_priority_get(k_current_get());
+
+	k_thread_priority_set(k_current_get(), PRIO_TEST);
+
+	/**TESTPOINT: the writer keeps readers and writers out*/
+	zassert_equal(k_rwlock_write_lock(&krwlock, K_FOREVER), 0, NULL);
+	spawn(&tdata, tstack, tThread_entry_read_write_no_wait, &krwlock);
+	zassert_equal(read_ret, -EBUSY, NULL);
+	zassert_equal(write_ret, -EBUSY, NULL);
+
+	/**TESTPOINT: a reader times out while the writer holds the lock*/
+	spawn(&tdata, tstack, tThread_entry_read_timeout, &krwlock);
+	k_sleep(TIMEOUT + 50);
+	zassert_equal(read_ret, -EAGAIN, NULL);
+
+	k_rwlock_write_unlock(&krwlock);
+
+	k_thread_priority_set(k_current_get(), prio);
+}
+
+void test_rwlock_writer_preferred(void)
+{
+	int prio = k_thread_priority_get(k_current_get());
+
+	k_thread_priority_set(k_current_get(), PRIO_TEST);
+	writer_done = 0;
+
+	zassert_equal(k_rwlock_read_lock(&krwlock, K_FOREVER), 0, NULL);
+
+	/**TESTPOINT: a waiting writer keeps new readers out*/
+	spawn(&tdata, tstack, tThread_entry_write_forever, &krwlock);
+	spawn(&tdata2, tstack2, tThread_entry_read_write_no_wait, &krwlock);
+	zassert_equal(read_ret, -EBUSY, NULL);
+	zassert_false(writer_done, NULL);
+
+	/**TESTPOINT: the last reader hands the lock over to the writer*/
+	k_rwlock_read_unlock(&krwlock);
+	zassert_equal(write_ret, 0, NULL);
+	zassert_true(writer_done, NULL);
+
+	k_thread_priority_set(k_current_get(), prio);
+}
+
+void test_rwlock_writer_inherits(void)
+{
+	int prio = k_thread_priority_get(k_current_get());
+
+	k_thread_priority_set(k_current_get(), PRIO_TEST);
+	read_ret = -1;
+
+	zassert_equal(k_rwlock_write_lock(&krwlock, K_FOREVER), 0, NULL);
+
+	/**TESTPOINT: the writer inherits the priority of the waiter*/
+	spawn(&tdata, tstack, tThread_entry_read_forever, &krwlock);
+	zassert_equal(k_thread_priority_get(k_current_get()), PRIO_HIGH, NULL);
+
+	/**TESTPOINT: the writer gets its priority back when unlocking*/
+	k_rwlock_write_unlock(&krwlock);
+	zassert_equal(k_thread_priority_get(k_current_get()), PRIO_TEST, NULL);
+	zassert_equal(read_ret, 0, NULL);
+
+	k_thread_priority_set(k_current_get(), prio);
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_sched
+ * @{
+ * @defgroup t_sched_deadline test_sched_deadline
+ * @}
+ */
+
+#include <ztest.h>
+
+#define NUM_THREADS 8
+#define STACK_SIZE 512
+
+/* below the test thread, so that none of them runs before all are set up */
+#define THREAD_PRIO K_PRIO_PREEMPT(5)
+
+K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_THREADS, STACK_SIZE);
+static struct k_thread threads[NUM_THREADS];
+
+/*
+ * Deadlines, in cycles, deliberately not in creation order, and far enough
+ * apart that the time taken to create the threads does not matter.
+ */
+#define DEADLINE_STEP 1000000
+
+static const int deadlines[NUM_THREADS] = {
+	8 * DEADLINE_STEP, 3 * DEADLINE_STEP, 1 * DEADLINE_STEP,
+	7 * DEADLINE_STEP, 2 * DEADLINE_STEP, 6 * DEADLINE_STEP,
+	5 * DEADLINE_STEP, 4 * DEADLINE_STEP
+};
+
+static int run_order[NUM_THREADS];
+static int num_run;
+
+static void worker(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	run_order[num_run++] = (int)p1;
+}
+
+/**
+ * @brief Test that threads of equal priority run in deadline order
+ */
+void test_deadline_order(void)
+{
+	int i;
+
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(0));
+
+	for (i = 0; i < NUM_THREADS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				worker, (void *)i, NULL, NULL,
+				THREAD_PRIO, 0, K_NO_WAIT);
+		k_thread_deadline_set(&threads[i], deadlines[i]);
+	}
+
+	/* let all the workers run */
+	k_sleep(100);
+
+	zassert_equal(num_run, NUM_THREADS, "not all threads ran");
+
+	for (i = 1; i < NUM_THREADS; i++) {
+		zassert_true(deadlines[run_order[i - 1]] <
+			     deadlines[run_order[i]],
+			     "threads did not run in deadline order");
+	}
+}
+
+static K_SEM_DEFINE(wake_sem, 0, NUM_THREADS);
+
+static void pending_worker(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_sem_take(&wake_sem, K_FOREVER);
+	run_order[num_run++] = (int)p1;
+}
+
+/**
+ * @brief Test that pending threads of equal priority wake in deadline order
+ */
+void test_deadline_pending_order(void)
+{
+	int i;
+
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(0));
+	num_run = 0;
+
+	for (i = 0; i < NUM_THREADS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				pending_worker, (void *)i, NULL, NULL,
+				THREAD_PRIO, 0, K_NO_WAIT);
+	}
+
+	/* let all the workers pend on the semaphore, then set deadlines */
+	k_sleep(100);
+
+	for (i = 0; i < NUM_THREADS; i++) {
+		k_thread_deadline_set(&threads[i], deadlines[i]);
+	}
+
+	/* wake the workers one at a time, from the head of the wait queue */
+	for (i = 0; i < NUM_THREADS; i++) {
+		k_sem_give(&wake_sem);
+		k_sleep(10);
+	}
+
+	zassert_equal(num_run, NUM_THREADS, "not all threads ran");
+
+	for (i = 1; i < NUM_THREADS; i++) {
+		zassert_true(deadlines[run_order[i - 1]] <
+			     deadlines[run_order[i]],
+			     "threads did not wake in deadline order");
+	}
+}
+
+void test_main(void *p1, void *p2, void *p3)
+{
+	ztest_test_suite(test_sched_deadline,
+			 ztest_unit_test(test_deadline_order),
+			 ztest_unit_test(test_deadline_pending_order));
+	ztest_run_test_suite(test_sched_deadline);
+}
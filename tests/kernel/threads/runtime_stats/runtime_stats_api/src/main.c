@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_threads
+ * @{
+ * @defgroup t_thread_runtime_stats test_thread_runtime_stats
+ * @brief TestPurpose: verify per-thread runtime statistics
+ * - API coverage
+ *   -# k_thread_runtime_stats_get
+ * @}
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE 512
+#define BUSY_CYCLES 100000
+#define NUM_YIELDS 5
+
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static struct k_thread tdata;
+
+static void busy_entry(void *p1, void *p2, void *p3)
+{
+	u32_t start = k_cycle_get_32();
+
+	while (k_cycle_get_32() - start < BUSY_CYCLES) {
+	}
+}
+
+static void yield_entry(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < NUM_YIELDS; i++) {
+		k_yield();
+	}
+}
+
+static void sleep_entry(void *p1, void *p2, void *p3)
+{
+	k_sleep(10);
+}
+
+static void run_thread(k_thread_entry_t entry, int prio,
+		       struct k_thread_runtime_stats *stats)
+{
+	k_tid_t tid = k_thread_create(&tdata, tstack, STACK_SIZE, entry,
+				      NULL, NULL, NULL, prio, 0, 0);
+
+	/* let it run to completion */
+	k_sleep(100);
+	k_thread_runtime_stats_get(tid, stats);
+	k_thread_abort(tid);
+}
+
+/*test cases*/
+void test_runtime_stats_cycles(void)
+{
+	struct k_thread_runtime_stats stats;
+
+	/**TESTPOINT: a busy thread accounts the cycles it ran for*/
+	run_thread(busy_entry, K_PRIO_PREEMPT(1), &stats);
+	zassert_true(stats.cycles >= BUSY_CYCLES, NULL);
+	zassert_true(stats.num_switches >= 1, NULL);
+
+	/**TESTPOINT: a sleeping thread is switched in twice*/
+	run_thread(sleep_entry, K_PRIO_PREEMPT(1), &stats);
+	zassert_equal(stats.num_switches, 2, NULL);
+	zassert_equal(stats.num_preemptions, 0, NULL);
+	zassert_true(stats.cycles < BUSY_CYCLES, NULL);
+}
+
+void test_runtime_stats_preemptions(void)
+{
+	struct k_thread_runtime_stats stats;
+	int prio = K_LOWEST_APPLICATION_THREAD_PRIO;
+	k_tid_t tid;
+
+	/* ping-pong with a thread of equal priority */
+	k_thread_priority_set(k_current_get(), prio);
+	tid = k_thread_create(&tdata, tstack, STACK_SIZE, yield_entry,
+			      NULL, NULL, NULL, prio, 0, 0);
+	for (int i = 0; i < NUM_YIELDS; i++) {
+		k_yield();
+	}
+
+	/**TESTPOINT: switching out a thread still ready is counted*/
+	k_thread_runtime_stats_get(tid, &stats);
+	zassert_true(stats.num_preemptions >= 1, NULL);
+	zassert_true(stats.num_switches >= 2, NULL);
+	k_thread_abort(tid);
+}
+
+void test_runtime_stats_current(void)
+{
+	struct k_thread_runtime_stats before, after;
+	u32_t start = k_cycle_get_32();
+
+	k_thread_runtime_stats_get(k_current_get(), &before);
+	while (k_cycle_get_32() - start < BUSY_CYCLES) {
+	}
+	k_thread_runtime_stats_get(k_current_get(), &after);
+
+	/**TESTPOINT: the cycles of the current thread are up to date*/
+	zassert_true(after.cycles - before.cycles >= BUSY_CYCLES / 2, NULL);
+
+	/**TESTPOINT: the stack usage of the current thread is known*/
+	zassert_true(after.stack_size > 0, NULL);
+	zassert_true(after.stack_max_used > 0, NULL);
+	zassert_true(after.stack_max_used <= after.stack_size, NULL);
+}
+
+void test_main(void *p1, void *p2, void *p3)
+{
+	ztest_test_suite(test_thread_runtime_stats,
+			 ztest_unit_test(test_runtime_stats_cycles),
+			 ztest_unit_test(test_runtime_stats_current),
+			 ztest_unit_test(test_runtime_stats_preemptions));
+	ztest_run_test_suite(test_thread_runtime_stats);
+}
@@ -66,6 +66,15 @@ extern void _timestamp_close(void);
 #define _TIMESTAMP_READ()	(_timestamp_read())
 #define _TIMESTAMP_CLOSE()	(_timestamp_close())
 
+#elif defined(CONFIG_RISCV32) && defined(CONFIG_RISCV_MACHINE_TIMER)
+typedef u32_t _timer_res_t;
+#define _TIMER_ZERO  0
+
+/* the machine timer counter keeps running while idle */
+#define _TIMESTAMP_OPEN()
+#define _TIMESTAMP_READ()	(k_cycle_get_32())
+#define _TIMESTAMP_CLOSE()
+
 #else
 #error "Unknown target"
 #endif
@@ -123,7 +132,7 @@ void ticklessTestThread(void)
 #if defined(CONFIG_X86) || defined(CONFIG_ARC)
 	printk("Calibrated time stamp period = 0x%x%x\n",
 		   (u32_t)(cal_tsc >> 32), (u32_t)(cal_tsc & 0xFFFFFFFFLL));
-#elif defined(CONFIG_ARM)
+#elif defined(CONFIG_ARM) || defined(CONFIG_RISCV32)
 	printk("Calibrated time stamp period = 0x%x\n", cal_tsc);
 #endif
 
@@ -168,7 +177,8 @@ void ticklessTestThread(void)
 		   (u32_t)(diff_tsc >> 32), (u32_t)(diff_tsc & 0xFFFFFFFFULL));
 	printk("Cal   time stamp: 0x%x%x\n",
 		   (u32_t)(cal_tsc >> 32), (u32_t)(cal_tsc & 0xFFFFFFFFLL));
-#elif defined(CONFIG_ARM) || defined(CONFIG_SOC_QUARK_SE_C1000_SS)
+#elif defined(CONFIG_ARM) || defined(CONFIG_SOC_QUARK_SE_C1000_SS) || \
+	defined(CONFIG_RISCV32)
 	printk("diff  time stamp: 0x%x\n", diff_tsc);
 	printk("Cal   time stamp: 0x%x\n", cal_tsc);
 #endif
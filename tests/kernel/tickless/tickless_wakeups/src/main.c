@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Measure the wakeups and the idle residency of tickless idle
+ *
+ * The test thread sleeps while nothing else is ready, so that the system is
+ * idle, and counts the interrupts logged meanwhile by the kernel event
+ * logger: each of them woke the CPU up. The idle residency is the share of
+ * the sleep spent in the idle thread, from its runtime statistics.
+ *
+ * With tickless idle, the only wakeup expected is the one ending the sleep;
+ * with the periodic tick, there is one per tick.
+ *
+ * The same counting is done while busy threads of equal priority run in
+ * round-robin fashion: a tickless kernel is only interrupted at the end of
+ * each time slice.
+ */
+
+#include <ztest.h>
+#include <logging/kernel_event_logger.h>
+
+#define SLEEP_TICKS 50
+#define SLICE_TICKS 10
+
+#define NUM_WORKERS 2
+#define WORKER_PRIO K_PRIO_PREEMPT(1)
+#define STACK_SIZE 512
+
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, NUM_WORKERS, STACK_SIZE);
+static struct k_thread workers[NUM_WORKERS];
+static volatile u32_t worker_runs[NUM_WORKERS];
+
+extern k_tid_t const _idle_thread;
+
+#ifndef CONFIG_TICKLESS_KERNEL
+extern s32_t _sys_idle_threshold_ticks;
+#endif
+
+static void drain_events(void)
+{
+	u32_t data[4];
+	u16_t event_id;
+	u8_t dropped;
+	u8_t size;
+
+	do {
+		size = ARRAY_SIZE(data);
+	} while (sys_k_event_logger_get(&event_id, &dropped, data, &size));
+}
+
+static u32_t count_wakeups(void)
+{
+	u32_t data[4];
+	u32_t wakeups = 0;
+	u16_t event_id;
+	u8_t dropped;
+	u8_t size;
+
+	for (;;) {
+		size = ARRAY_SIZE(data);
+		if (!sys_k_event_logger_get(&event_id, &dropped, data, &size)) {
+			break;
+		}
+
+		zassert_equal(dropped, 0, "events were dropped");
+
+		if (event_id == KERNEL_EVENT_LOGGER_INTERRUPT_EVENT_ID) {
+			wakeups++;
+		}
+	}
+
+	return wakeups;
+}
+
+/* sleep, and return the wakeups and the idle residency in percent */
+static u32_t measure_idle(u32_t *residency)
+{
+	struct k_thread_runtime_stats idle_start, idle_end;
+	u32_t start, cycles, wakeups;
+
+	/* start on a tick boundary, with nothing logged */
+	k_sleep(__ticks_to_ms(1));
+	drain_events();
+
+	k_thread_runtime_stats_get(_idle_thread, &idle_start);
+	start = k_cycle_get_32();
+
+	k_sleep(__ticks_to_ms(SLEEP_TICKS));
+
+	cycles = k_cycle_get_32() - start;
+	k_thread_runtime_stats_get(_idle_thread, &idle_end);
+
+	wakeups = count_wakeups();
+	*residency = (u32_t)((idle_end.cycles - idle_start.cycles) * 100 /
+			     cycles);
+
+	TC_PRINT("%d ticks slept: %u wakeups, idle residency %u%%\n",
+		 SLEEP_TICKS, wakeups, *residency);
+
+	return wakeups;
+}
+
+void test_tickless_idle_wakeups(void)
+{
+	u32_t wakeups, residency;
+
+	wakeups = measure_idle(&residency);
+
+	/**TESTPOINT: the periodic tick does not wake the CPU up */
+	zassert_true(wakeups <= 2, "woken up by the tick");
+	/**TESTPOINT: the CPU stays idle for almost all the sleep */
+	zassert_true(residency >= 90, "idle residency too low");
+}
+
+void test_tickful_idle_wakeups(void)
+{
+#ifndef CONFIG_TICKLESS_KERNEL
+	s32_t threshold = _sys_idle_threshold_ticks;
+	u32_t wakeups, residency;
+
+	/* make sure we do not enter tickless idle mode */
+	_sys_idle_threshold_ticks = 0x7FFFFFFF;
+	wakeups = measure_idle(&residency);
+	_sys_idle_threshold_ticks = threshold;
+
+	/**TESTPOINT: each tick wakes the CPU up */
+	zassert_true(wakeups >= SLEEP_TICKS - 1, "missing tick wakeups");
+#else
+	TC_PRINT("no periodic tick to compare with in a tickless kernel\n");
+#endif
+}
+
+static void worker(void *p1, void *p2, void *p3)
+{
+	volatile u32_t *runs = p1;
+	u32_t last = 0;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	/* count the slices: other workers run between two of them */
+	for (;;) {
+		u32_t now = k_cycle_get_32();
+
+		if (now - last > sys_clock_hw_cycles_per_tick) {
+			(*runs)++;
+		}
+		last = now;
+	}
+}
+
+void test_slice_wakeups(void)
+{
+	u32_t wakeups;
+	int i;
+
+	k_sched_time_slice_set(__ticks_to_ms(SLICE_TICKS), WORKER_PRIO);
+
+	/* start on a tick boundary, with nothing logged */
+	k_sleep(__ticks_to_ms(1));
+	drain_events();
+
+	/* the workers have a lower priority: they run while the test sleeps */
+	for (i = 0; i < NUM_WORKERS; i++) {
+		worker_runs[i] = 0;
+		k_thread_create(&workers[i], worker_stacks[i], STACK_SIZE,
+				worker, (void *)&worker_runs[i], NULL, NULL,
+				WORKER_PRIO, 0, K_NO_WAIT);
+	}
+
+	k_sleep(__ticks_to_ms(SLEEP_TICKS));
+
+	for (i = 0; i < NUM_WORKERS; i++) {
+		k_thread_abort(&workers[i]);
+	}
+	k_sched_time_slice_set(0, WORKER_PRIO);
+
+	wakeups = count_wakeups();
+
+	TC_PRINT("%d ticks of round-robin: %u wakeups, runs %u and %u\n",
+		 SLEEP_TICKS, wakeups, worker_runs[0], worker_runs[1]);
+
+	/**TESTPOINT: the workers share the CPU */
+	zassert_true(worker_runs[0] >= 2 && worker_runs[1] >= 2,
+		     "no round-robin between the workers");
+#ifdef CONFIG_TICKLESS_KERNEL
+	/**TESTPOINT: only the end of each slice interrupts the workers */
+	zassert_true(wakeups <= SLEEP_TICKS / SLICE_TICKS + 2,
+		     "interrupted by the tick");
+#else
+	/**TESTPOINT: each tick interrupts the workers */
+	zassert_true(wakeups >= SLEEP_TICKS - 1, "missing tick interrupts");
+#endif
+}
+
+void test_main(void *p1, void *p2, void *p3)
+{
+	ztest_test_suite(test_tickless_wakeups,
+			 ztest_unit_test(test_tickless_idle_wakeups),
+			 ztest_unit_test(test_tickful_idle_wakeups),
+			 ztest_unit_test(test_slice_wakeups));
+	ztest_run_test_suite(test_tickless_wakeups);
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_workq
+ * @{
+ * @defgroup t_prio_workq test_prio_workq
+ * @brief TestPurpose: verify priority work queue functionalities
+ * - API coverage
+ *   -# k_prio_work_init
+ *   -# k_prio_work_q_start
+ *   -# k_prio_work_submit_to_queue
+ *   -# k_prio_work_q_depth_get
+ *   -# k_prio_work_q_max_wait_get
+ *   -# k_prio_work_wait_get
+ * @}
+ */
+
+#include <ztest.h>
+
+#define TIMEOUT 100
+#define STACK_SIZE 512
+#define NUM_WORKERS 2
+#define NUM_OF_WORK 4
+
+static K_THREAD_STACK_ARRAY_DEFINE(tstacks, NUM_WORKERS, STACK_SIZE);
+static struct k_thread tthreads[NUM_WORKERS];
+static struct k_prio_work_q workq;
+static struct k_prio_work work[NUM_OF_WORK];
+static struct k_prio_work work_sleepy;
+static struct k_sem sync_sema;
+
+static struct k_prio_work *done[NUM_OF_WORK];
+static int num_done;
+
+static void work_handler(struct k_work *w)
+{
+	done[num_done++] = CONTAINER_OF(w, struct k_prio_work, work);
+	k_sem_give(&sync_sema);
+}
+
+static void work_sleepy_handler(struct k_work *w)
+{
+	k_sleep(TIMEOUT);
+	k_sem_give(&sync_sema);
+}
+
+static void wait_done(int count)
+{
+	for (int i = 0; i < count; i++) {
+		zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+	}
+}
+
+/*test cases*/
+void test_prio_workq_start(void)
+{
+	k_sem_init(&sync_sema, 0, NUM_OF_WORK);
+
+	/**TESTPOINT: start a pool of workers*/
+	k_prio_work_q_start(&workq, tthreads, (char *)tstacks,
+			    K_THREAD_STACK_SIZEOF(tstacks[0]), NUM_WORKERS,
+			    K_PRIO_PREEMPT(0));
+	zassert_equal(k_prio_work_q_depth_get(&workq), 0, NULL);
+}
+
+void test_prio_work_order(void)
+{
+	static const int prios[NUM_OF_WORK] = { 3, 1, 2, 1 };
+	static const int order[NUM_OF_WORK] = { 1, 3, 2, 0 };
+
+	num_done = 0;
+	for (int i = 0; i < NUM_OF_WORK; i++) {
+		k_prio_work_init(&work[i], work_handler, prios[i]);
+	}
+
+	/* the test thread is cooperative: nothing runs before it sleeps */
+	for (int i = 0; i < NUM_OF_WORK; i++) {
+		k_prio_work_submit_to_queue(&workq, &work[i]);
+	}
+	/**TESTPOINT: resubmitting a pending item has no effect*/
+	k_prio_work_submit_to_queue(&workq, &work[0]);
+	zassert_equal(k_prio_work_q_depth_get(&workq), NUM_OF_WORK, NULL);
+
+	wait_done(NUM_OF_WORK);
+	zassert_equal(k_prio_work_q_depth_get(&workq), 0, NULL);
+
+	/**TESTPOINT: items run by priority, then in submission order*/
+	for (int i = 0; i < NUM_OF_WORK; i++) {
+		zassert_equal(done[i], &work[order[i]], NULL);
+	}
+}
+
+void test_prio_work_parallel(void)
+{
+	num_done = 0;
+	k_prio_work_init(&work_sleepy, work_sleepy_handler, 0);
+	k_prio_work_init(&work[0], work_handler, 1);
+
+	k_prio_work_submit_to_queue(&workq, &work_sleepy);
+	k_prio_work_submit_to_queue(&workq, &work[0]);
+
+	/**TESTPOINT: a slow item does not hold up the other workers*/
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT >> 1), 0, NULL);
+	zassert_equal(num_done, 1, NULL);
+	zassert_equal(done[0], &work[0], NULL);
+
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+}
+
+void test_prio_work_wait_time(void)
+{
+	u32_t start, max_depth;
+
+	num_done = 0;
+	k_prio_work_init(&work[0], work_handler, 0);
+	k_prio_work_submit_to_queue(&workq, &work[0]);
+
+	/* keep the workers from running for a while */
+	start = k_cycle_get_32();
+	while (k_cycle_get_32() - start < 1000) {
+	}
+
+	/**TESTPOINT: wait time of a pending item grows*/
+	zassert_true(k_prio_work_wait_get(&work[0]) >= 1000, NULL);
+
+	wait_done(1);
+
+	/**TESTPOINT: wait time of a processed item is frozen*/
+	zassert_true(k_prio_work_wait_get(&work[0]) >= 1000, NULL);
+	zassert_true(k_prio_work_q_max_wait_get(&workq, &max_depth) >=
+		     k_prio_work_wait_get(&work[0]), NULL);
+	zassert_equal(max_depth, NUM_OF_WORK, NULL);
+}
+
+void test_main(void *p1, void *p2, void *p3)
+{
+	ztest_test_suite(test_prio_workq,
+			 ztest_unit_test(test_prio_workq_start),/*keep first!*/
+			 ztest_unit_test(test_prio_work_order),
+			 ztest_unit_test(test_prio_work_parallel),
+			 ztest_unit_test(test_prio_work_wait_time));
+	ztest_run_test_suite(test_prio_workq);
+}
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2017 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <ztest.h>
+#include <misc/rbtree.h>
+
+#define NUM_NODES 256
+#define NUM_ROUNDS 2000
+
+/* few distinct keys, so that many nodes compare equal */
+#define NUM_KEYS 32
+
+struct container_node {
+	sys_rbnode_t node;
+	int key;
+	u32_t order;
+	bool in_tree;
+};
+
+static struct container_node nodes[NUM_NODES];
+static sys_rbtree_t tree;
+static u32_t insert_count;
+static u32_t rand_state = 0x2545f491;
+
+/* xorshift, reproducible from one run to the next */
+static u32_t test_rand(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+static int node_lessthan(sys_rbnode_t *a, sys_rbnode_t *b)
+{
+	return CONTAINER_OF(a, struct container_node, node)->key <
+		CONTAINER_OF(b, struct container_node, node)->key;
+}
+
+static void insert_node(struct container_node *c)
+{
+	c->order = insert_count++;
+	c->in_tree = true;
+	sys_rb_insert(&tree, &c->node);
+}
+
+static void remove_node(struct container_node *c)
+{
+	c->in_tree = false;
+	sys_rb_remove(&tree, &c->node);
+}
+
+/*
+ * Check the links and colors of a subtree, return its black height: a red
+ * node has black children, and all the paths down to the leaves have the
+ * same number of black nodes.
+ */
+static int check_subtree(sys_rbnode_t *node, int *count)
+{
+	int left, right;
+
+	if (!node) {
+		return 1;
+	}
+
+	(*count)++;
+	zassert_true(*count <= NUM_NODES, "loop in the tree");
+
+	if (node->left) {
+		zassert_equal(node->left->parent, node, "bad parent link");
+	}
+
+	if (node->right) {
+		zassert_equal(node->right->parent, node, "bad parent link");
+	}
+
+	if (node->red) {
+		zassert_false(node->left && node->left->red, "red red");
+		zassert_false(node->right && node->right->red, "red red");
+	}
+
+	left = check_subtree(node->left, count);
+	right = check_subtree(node->right, count);
+	zassert_equal(left, right, "unbalanced black height");
+
+	return left + !node->red;
+}
+
+/*
+ * Check the tree properties, and that walking it in both directions gives
+ * the nodes in the tree sorted by key, then by insertion order.
+ */
+static void check_tree(void)
+{
+	struct container_node *c, *prev = NULL;
+	sys_rbnode_t *n;
+	int count = 0, walked = 0, expected = 0;
+	int i;
+
+	for (i = 0; i < NUM_NODES; i++) {
+		expected += nodes[i].in_tree;
+	}
+
+	if (tree.root) {
+		zassert_is_null(tree.root->parent, "root has a parent");
+		zassert_false(tree.root->red, "red root");
+	}
+
+	check_subtree(tree.root, &count);
+	zassert_equal(count, expected, "wrong node count");
+
+	SYS_RB_FOR_EACH_CONTAINER(&tree, c, node) {
+		zassert_true(c->in_tree, "removed node in the tree");
+
+		if (prev) {
+			zassert_true(prev->key < c->key ||
+				     (prev->key == c->key &&
+				      prev->order < c->order), "out of order");
+		}
+
+		prev = c;
+		walked++;
+	}
+
+	zassert_equal(walked, expected, "wrong walk length");
+	zassert_equal(sys_rb_get_max(&tree), prev ? &prev->node : NULL,
+		      "wrong maximum");
+
+	for (n = sys_rb_get_max(&tree); n; n = sys_rb_prev(n)) {
+		walked--;
+	}
+
+	zassert_equal(walked, 0, "wrong reverse walk length");
+}
+
+static void empty_tree(void)
+{
+	sys_rbnode_t *n;
+
+	while ((n = sys_rb_get_min(&tree))) {
+		remove_node(CONTAINER_OF(n, struct container_node, node));
+	}
+}
+
+void test_rbtree_empty(void)
+{
+	sys_rb_init(&tree, node_lessthan);
+
+	zassert_true(sys_rb_is_empty(&tree), NULL);
+	zassert_is_null(sys_rb_get_min(&tree), NULL);
+	zassert_is_null(sys_rb_get_max(&tree), NULL);
+
+	nodes[0].key = 0;
+	insert_node(&nodes[0]);
+	zassert_false(sys_rb_is_empty(&tree), NULL);
+	zassert_equal(sys_rb_get_min(&tree), &nodes[0].node, NULL);
+	zassert_equal(sys_rb_get_max(&tree), &nodes[0].node, NULL);
+	zassert_is_null(sys_rb_next(&nodes[0].node), NULL);
+	zassert_is_null(sys_rb_prev(&nodes[0].node), NULL);
+
+	remove_node(&nodes[0]);
+	zassert_true(sys_rb_is_empty(&tree), NULL);
+}
+
+void test_rbtree_sorted_insert(void)
+{
+	int i;
+
+	sys_rb_init(&tree, node_lessthan);
+
+	/*
+	 * ascending then descending keys, the worst case of naive trees, each
+	 * key being used twice
+	 */
+	for (i = 0; i < NUM_NODES / 2; i++) {
+		nodes[i].key = i;
+		insert_node(&nodes[i]);
+		check_tree();
+	}
+
+	for (i = NUM_NODES / 2; i < NUM_NODES; i++) {
+		nodes[i].key = NUM_NODES - 1 - i;
+		insert_node(&nodes[i]);
+		check_tree();
+	}
+
+	zassert_equal(sys_rb_get_min(&tree), &nodes[0].node, NULL);
+	zassert_equal(sys_rb_get_max(&tree), &nodes[NUM_NODES / 2].node, NULL);
+
+	/* remove the minimum each time, as the ready queue does */
+	for (i = 0; i < NUM_NODES; i++) {
+		remove_node(CONTAINER_OF(sys_rb_get_min(&tree),
+					 struct container_node, node));
+		check_tree();
+	}
+
+	zassert_true(sys_rb_is_empty(&tree), NULL);
+}
+
+void test_rbtree_random(void)
+{
+	struct container_node *c;
+	int i;
+
+	sys_rb_init(&tree, node_lessthan);
+
+	for (i = 0; i < NUM_ROUNDS; i++) {
+		c = &nodes[test_rand() % NUM_NODES];
+
+		if (c->in_tree) {
+			remove_node(c);
+		} else {
+			c->key = test_rand() % NUM_KEYS;
+			insert_node(c);
+		}
+
+		check_tree();
+	}
+
+	empty_tree();
+	check_tree();
+	zassert_true(sys_rb_is_empty(&tree), NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lib_rbtree_test,
+			 ztest_unit_test(test_rbtree_empty),
+			 ztest_unit_test(test_rbtree_sorted_insert),
+			 ztest_unit_test(test_rbtree_random)
+			 );
+
+	ztest_run_test_suite(lib_rbtree_test);
+}
@@ -0,0 +1,232 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measure how long net_conn_input() takes to find the handler of a received
+ * UDP packet, with an increasing number of registered connections: each
+ * connection is a client of a CoAP like server, which also listens for new
+ * clients on the same port.
+ */
+
+#include <zephyr.h>
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <misc/printk.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+
+#include <tc_util.h>
+
+#include "connection.h"
+#include "udp.h"
+#include "net_private.h"
+
+#define SERVER_PORT 5683
+#define CLIENT_PORT 49152
+#define NEW_CLIENT_PORT 1024
+#define LOOPS 1000
+
+#define LISTENER INT_TO_POINTER(-1)
+
+static const int conn_counts[] = { 8, 64, 256 };
+
+static struct net_conn_handle *handles[CONFIG_NET_MAX_CONN];
+
+static void *matched;
+
+static enum net_verdict recv_cb(struct net_conn *conn,
+				struct net_pkt *pkt,
+				void *user_data)
+{
+	/* The packet is reused, do not release it */
+	matched = user_data;
+
+	return NET_OK;
+}
+
+static void client_addr(struct in6_addr *addr, int client)
+{
+	/* 2001:db8::c:0/112, one address per client */
+	memset(addr, 0, sizeof(*addr));
+	addr->s6_addr[0] = 0x20;
+	addr->s6_addr[1] = 0x01;
+	addr->s6_addr[2] = 0x0d;
+	addr->s6_addr[3] = 0xb8;
+	addr->s6_addr[13] = 0x0c;
+	addr->s6_addr[14] = client >> 8;
+	addr->s6_addr[15] = client;
+}
+
+static struct net_pkt *setup_pkt(void)
+{
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+
+	pkt = net_pkt_get_reserve_rx(0, K_FOREVER);
+	frag = net_pkt_get_frag(pkt, K_FOREVER);
+	net_pkt_frag_add(pkt, frag);
+
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv6_hdr));
+	net_pkt_set_ipv6_ext_len(pkt, 0);
+
+	NET_IPV6_HDR(pkt)->vtc = 0x60;
+	NET_IPV6_HDR(pkt)->len[0] = 0;
+	NET_IPV6_HDR(pkt)->len[1] = NET_UDPH_LEN;
+	NET_IPV6_HDR(pkt)->nexthdr = IPPROTO_UDP;
+	NET_IPV6_HDR(pkt)->hop_limit = 255;
+
+	/* 2001:db8::1 */
+	memset(&NET_IPV6_HDR(pkt)->dst, 0, sizeof(struct in6_addr));
+	NET_IPV6_HDR(pkt)->dst.s6_addr[0] = 0x20;
+	NET_IPV6_HDR(pkt)->dst.s6_addr[1] = 0x01;
+	NET_IPV6_HDR(pkt)->dst.s6_addr[2] = 0x0d;
+	NET_IPV6_HDR(pkt)->dst.s6_addr[3] = 0xb8;
+	NET_IPV6_HDR(pkt)->dst.s6_addr[15] = 0x01;
+
+	NET_UDP_HDR(pkt)->dst_port = htons(SERVER_PORT);
+
+	net_buf_add(frag, net_pkt_ip_hdr_len(pkt) +
+		    sizeof(struct net_udp_hdr));
+
+	return pkt;
+}
+
+static bool register_conns(int count)
+{
+	struct sockaddr_in6 remote = { .sin6_family = AF_INET6 };
+	int ret, i;
+
+	ret = net_udp_register(NULL, NULL, 0, SERVER_PORT, recv_cb,
+			       LISTENER, &handles[count]);
+	if (ret) {
+		printk("Cannot register listener (%d)\n", ret);
+		return false;
+	}
+
+	for (i = 0; i < count; i++) {
+		client_addr(&remote.sin6_addr, i);
+		remote.sin6_port = htons(CLIENT_PORT + i);
+
+		ret = net_udp_register((struct sockaddr *)&remote, NULL,
+				       CLIENT_PORT + i, SERVER_PORT,
+				       recv_cb, INT_TO_POINTER(i + 1),
+				       &handles[i]);
+		if (ret) {
+			printk("Cannot register connection %d (%d)\n", i, ret);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void unregister_conns(int count)
+{
+	int i;
+
+	for (i = 0; i <= count; i++) {
+		net_udp_unregister(handles[i]);
+	}
+}
+
+/* Set 'cycles' to the average number of cycles taken by a lookup, return
+ * false if some packet did not reach its handler.
+ */
+static bool measure(struct net_pkt *pkt, int count, bool new_clients,
+		    u32_t *cycles)
+{
+	u64_t total = 0;
+	u32_t start;
+	int i, client;
+
+	for (i = 0; i < LOOPS; i++) {
+		client = i % count;
+
+		client_addr(&NET_IPV6_HDR(pkt)->src, client);
+
+		if (new_clients) {
+			NET_UDP_HDR(pkt)->src_port =
+				htons(NEW_CLIENT_PORT + client);
+		} else {
+			NET_UDP_HDR(pkt)->src_port = htons(CLIENT_PORT + client);
+		}
+
+		matched = NULL;
+
+		start = k_cycle_get_32();
+
+		if (net_conn_input(IPPROTO_UDP, pkt) != NET_OK) {
+			printk("Packet of client %d dropped\n", client);
+			return false;
+		}
+
+		total += k_cycle_get_32() - start;
+
+		if (matched != (new_clients ? LISTENER :
+				INT_TO_POINTER(client + 1))) {
+			printk("Packet of client %d matched %p\n", client,
+			       matched);
+			return false;
+		}
+	}
+
+	*cycles = total / LOOPS;
+
+	return true;
+}
+
+static bool run_tests(void)
+{
+	struct net_pkt *pkt = setup_pkt();
+	u32_t connected, listener;
+	bool ret = true;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(conn_counts) && ret; i++) {
+		if (conn_counts[i] >= CONFIG_NET_MAX_CONN) {
+			break;
+		}
+
+		if (!register_conns(conn_counts[i])) {
+			ret = false;
+			break;
+		}
+
+		if (!measure(pkt, conn_counts[i], false, &connected) ||
+		    !measure(pkt, conn_counts[i], true, &listener)) {
+			ret = false;
+		} else {
+			printk("%3d connections: connected %u cycles (%u ns), "
+			       "listener %u cycles (%u ns) per packet\n",
+			       conn_counts[i],
+			       connected, SYS_CLOCK_HW_CYCLES_TO_NS(connected),
+			       listener, SYS_CLOCK_HW_CYCLES_TO_NS(listener));
+		}
+
+		unregister_conns(conn_counts[i]);
+	}
+
+	net_pkt_unref(pkt);
+
+	return ret;
+}
+
+void main(void)
+{
+	k_thread_priority_set(k_current_get(), K_PRIO_COOP(7));
+
+	if (run_tests()) {
+		TC_END_REPORT(TC_PASS);
+	} else {
+		TC_END_REPORT(TC_FAIL);
+	}
+}
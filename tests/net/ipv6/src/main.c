@@ -414,6 +414,75 @@ static bool net_test_nbr_lookup_ok(void)
 	return true;
 }
 
+static bool net_test_nbr_add_rm(void)
+{
+	struct in6_addr addr1 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				      0, 0, 0, 0, 0, 0, 0, 0x11 } } };
+	struct in6_addr addr2 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				      0, 0, 0, 0, 0, 0, 0, 0x12 } } };
+	u8_t mac[] = { 0x02, 0x00, 0x5e, 0x00, 0x53, 0x11 };
+	struct net_if *iface = net_if_get_default();
+	struct net_linkaddr lladdr;
+	struct net_nbr *nbr1, *nbr2;
+
+	lladdr.len = sizeof(mac);
+	lladdr.addr = mac;
+	lladdr.type = NET_LINK_ETHERNET;
+
+	nbr1 = net_ipv6_nbr_add(iface, &addr1, &lladdr, false,
+				NET_IPV6_NBR_STATE_REACHABLE);
+	if (!nbr1) {
+		TC_ERROR("Cannot add %s to neighbor cache\n",
+			 net_sprint_ipv6_addr(&addr1));
+		return false;
+	}
+
+	/* The neighbor found last is remembered */
+	if (net_ipv6_nbr_lookup(iface, &addr1) != nbr1 ||
+	    net_ipv6_nbr_lookup(iface, &addr1) != nbr1) {
+		TC_ERROR("Neighbor %s not found\n",
+			 net_sprint_ipv6_addr(&addr1));
+		return false;
+	}
+
+	if (!net_ipv6_nbr_rm(iface, &addr1)) {
+		TC_ERROR("Cannot remove %s from neighbor cache\n",
+			 net_sprint_ipv6_addr(&addr1));
+		return false;
+	}
+
+	if (net_ipv6_nbr_lookup(iface, &addr1)) {
+		TC_ERROR("Removed neighbor %s found\n",
+			 net_sprint_ipv6_addr(&addr1));
+		return false;
+	}
+
+	/* Its entry and link layer address are reused by the next one */
+	nbr2 = net_ipv6_nbr_add(iface, &addr2, &lladdr, false,
+				NET_IPV6_NBR_STATE_REACHABLE);
+	if (!nbr2) {
+		TC_ERROR("Cannot add %s to neighbor cache\n",
+			 net_sprint_ipv6_addr(&addr2));
+		return false;
+	}
+
+	if (net_ipv6_nbr_lookup(iface, &addr1) ||
+	    net_ipv6_nbr_lookup(iface, &addr2) != nbr2 ||
+	    memcmp(net_nbr_get_lladdr(nbr2->idx)->addr, mac, sizeof(mac))) {
+		TC_ERROR("Wrong neighbor found after reuse\n");
+		return false;
+	}
+
+	if (!net_ipv6_nbr_rm(iface, &addr2) ||
+	    net_ipv6_nbr_lookup(iface, &addr2)) {
+		TC_ERROR("Cannot remove %s from neighbor cache\n",
+			 net_sprint_ipv6_addr(&addr2));
+		return false;
+	}
+
+	return true;
+}
+
 static bool net_test_send_ns_extra_options(void)
 {
 	struct net_pkt *pkt;
@@ -682,6 +751,7 @@ static const struct {
 	{ "IPv6 neighbor lookup fail", net_test_nbr_lookup_fail },
 	{ "IPv6 add neighbor", net_test_add_neighbor },
 	{ "IPv6 neighbor lookup ok", net_test_nbr_lookup_ok },
+	{ "IPv6 add and remove neighbors", net_test_nbr_add_rm },
 	{ "IPv6 send NS extra options", net_test_send_ns_extra_options },
 	{ "IPv6 send NS no options", net_test_send_ns_no_options },
 	{ "IPv6 handle RA message", net_test_ra_message },
@@ -338,6 +338,95 @@ static bool run_tests(void)
 		return false;
 	}
 
+	/* Changing the lladdr of a neighbor, it must be found by the new
+	 * lladdr only.
+	 */
+	nbr = net_nbr_get(&net_test_neighbor.table);
+	if (!nbr) {
+		printk("Cannot get neighbor from table %p\n",
+		       &net_test_neighbor.table);
+		return false;
+	}
+
+	lladdr.addr = addrs[0]->addr;
+
+	ret = net_nbr_link(nbr, iface1, &lladdr);
+	if (ret < 0) {
+		printk("Cannot add %s to nbr cache (%d)\n",
+		       net_sprint_ll_addr(lladdr.addr, lladdr.len), ret);
+		return false;
+	}
+
+	net_nbr_set_lladdr(nbr->idx, addrs[1]->addr,
+			   sizeof(struct net_eth_addr));
+
+	if (net_nbr_lookup(&net_test_neighbor.table, iface1, &lladdr)) {
+		printk("Neighbor found by its old lladdr\n");
+		return false;
+	}
+
+	lladdr.addr = addrs[1]->addr;
+
+	if (net_nbr_lookup(&net_test_neighbor.table, iface1,
+			   &lladdr) != nbr) {
+		printk("Neighbor not found by its new lladdr\n");
+		return false;
+	}
+
+	net_nbr_unlink(nbr, &lladdr);
+	net_nbr_unref(nbr);
+
+	/* Neighbors sharing a lladdr on two interfaces, each one must be
+	 * found on its own interface whichever was linked or found last,
+	 * and not once unlinked.
+	 */
+	lladdr.addr = addrs[2]->addr;
+
+	for (i = 0; i < 2; i++) {
+		nbrs[i] = net_nbr_get(&net_test_neighbor.table);
+		if (!nbrs[i]) {
+			printk("Cannot get neighbor from table %p\n",
+			       &net_test_neighbor.table);
+			return false;
+		}
+
+		ret = net_nbr_link(nbrs[i], i ? iface2 : iface1, &lladdr);
+		if (ret < 0) {
+			printk("Cannot add %s to nbr cache (%d)\n",
+			       net_sprint_ll_addr(lladdr.addr, lladdr.len),
+			       ret);
+			return false;
+		}
+	}
+
+	for (i = 0; i < 2; i++) {
+		if (net_nbr_lookup(&net_test_neighbor.table, iface1,
+				   &lladdr) != nbrs[0] ||
+		    net_nbr_lookup(&net_test_neighbor.table, iface2,
+				   &lladdr) != nbrs[1]) {
+			printk("Shared lladdr found on the wrong iface\n");
+			return false;
+		}
+	}
+
+	net_nbr_unlink(nbrs[1], &lladdr);
+	net_nbr_unref(nbrs[1]);
+
+	if (net_nbr_lookup(&net_test_neighbor.table, iface2, &lladdr) ||
+	    net_nbr_lookup(&net_test_neighbor.table, iface1,
+			   &lladdr) != nbrs[0]) {
+		printk("Unlinked neighbor found by its lladdr\n");
+		return false;
+	}
+
+	net_nbr_unlink(nbrs[0], &lladdr);
+	net_nbr_unref(nbrs[0]);
+
+	if (net_nbr_lookup(&net_test_neighbor.table, iface1, &lladdr)) {
+		printk("Unlinked neighbor found by its lladdr\n");
+		return false;
+	}
+
 	net_nbr_clear_table(&net_test_neighbor.table);
 
 	if (!clear_called) {
@@ -554,6 +554,66 @@ static bool route_del_many(void)
 	return true;
 }
 
+static bool route_lookup_longest_prefix(void)
+{
+	struct net_route_entry *prefix_route, *host_route;
+	int ret;
+
+	/* generic_addr/112 covers all the dest_addresses */
+	prefix_route = net_route_add(my_iface, &generic_addr, 112,
+				     &peer_addr);
+	if (!prefix_route) {
+		TC_ERROR("Prefix route add failed\n");
+		return false;
+	}
+
+	host_route = net_route_add(my_iface, &dest_addresses[0], 128,
+				   &peer_addr);
+	if (!host_route || host_route == prefix_route) {
+		TC_ERROR("Host route add failed\n");
+		return false;
+	}
+
+	if (net_route_lookup(my_iface, &dest_addresses[0]) != host_route) {
+		TC_ERROR("Host route not found\n");
+		return false;
+	}
+
+	if (net_route_lookup(my_iface, &dest_addresses[1]) != prefix_route) {
+		TC_ERROR("Prefix route not found\n");
+		return false;
+	}
+
+	if (net_route_lookup(my_iface, &dest_addr)) {
+		TC_ERROR("Route found for address outside of the prefix\n");
+		return false;
+	}
+
+	ret = net_route_del(host_route);
+	if (ret) {
+		TC_ERROR("Host route del failed (%d)\n", ret);
+		return false;
+	}
+
+	if (net_route_lookup(my_iface, &dest_addresses[0]) != prefix_route) {
+		TC_ERROR("Prefix route not found after host route del\n");
+		return false;
+	}
+
+	ret = net_route_del(prefix_route);
+	if (ret) {
+		TC_ERROR("Prefix route del failed (%d)\n", ret);
+		return false;
+	}
+
+	if (net_route_lookup(my_iface, &dest_addresses[0])) {
+		TC_ERROR("Route found after all routes deleted\n");
+		return false;
+	}
+
+	return true;
+}
+
 static const struct {
 	const char *name;
 	bool (*func)(void);
@@ -575,6 +635,7 @@ static const struct {
 	{ "Populate neighbor cache again", populate_nbr_cache },
 	{ "Add many routes", route_add_many },
 	{ "Del many routes", route_del_many },
+	{ "Lookup longest prefix", route_lookup_longest_prefix },
 };
 
 void main(void)
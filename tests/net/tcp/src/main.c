@@ -939,6 +939,56 @@ static bool test_create_v4_synack_packet(void)
 	return true;
 }
 
+static bool test_syn_options(void)
+{
+	struct net_tcp *tcp = v6_ctx->tcp;
+	u8_t options[NET_TCP_SYN_OPT_SIZE], again[NET_TCP_SYN_OPT_SIZE];
+	u8_t optionlen, againlen;
+	u32_t send_seq = tcp->send_seq;
+	struct net_pkt *pkt = NULL;
+	bool ret = false;
+	u8_t *opt;
+
+	net_tcp_set_syn_opt(tcp, options, &optionlen);
+
+	/* The SACK permitted option is aligned after the MSS one */
+	opt = options + optionlen - NET_TCP_SACK_PERM_SIZE;
+	if (optionlen != NET_TCP_SYN_OPT_SIZE ||
+	    opt[0] != NET_TCP_NOP_OPT || opt[1] != NET_TCP_NOP_OPT ||
+	    opt[2] != NET_TCP_SACK_PERM_OPT || opt[3] != 2) {
+		DBG("Invalid SYN options\n");
+		return false;
+	}
+
+	/* A SYN sent again tells the same MSS */
+	net_tcp_set_syn_opt(tcp, again, &againlen);
+	if (againlen != optionlen || memcmp(again, options, optionlen)) {
+		DBG("SYN options changed\n");
+		return false;
+	}
+
+	if (net_tcp_prepare_segment(tcp, NET_TCP_SYN, options, optionlen, NULL,
+				    (struct sockaddr *)&peer_v6_addr, &pkt)) {
+		DBG("Prepare segment failed\n");
+		return false;
+	}
+
+	net_tcp_parse_syn_options(tcp, pkt);
+	if (!tcp->sack_permitted) {
+		DBG("SACK permitted option not parsed\n");
+		goto out;
+	}
+
+	ret = true;
+
+out:
+	tcp->sack_permitted = 0;
+	tcp->send_seq = send_seq;
+	net_pkt_unref(pkt);
+
+	return ret;
+}
+
 static bool test_create_v6_fin_packet(void)
 {
 	struct net_tcp *tcp = v6_ctx->tcp;
@@ -1065,6 +1115,483 @@ static bool test_v4_seq_check(void)
 	return true;
 }
 
+/* A segment, only its sequence number and length matter here */
+static struct net_pkt *new_segment(struct net_tcp *tcp, u32_t seq, u16_t len)
+{
+	u32_t send_seq = tcp->send_seq;
+	struct net_pkt *pkt = NULL;
+	int ret;
+
+	tcp->send_seq = seq;
+
+	ret = net_tcp_prepare_segment(tcp, NET_TCP_ACK, NULL, 0, NULL,
+				      (struct sockaddr *)&peer_v6_addr, &pkt);
+
+	tcp->send_seq = send_seq;
+
+	if (ret) {
+		DBG("Prepare segment failed (%d)\n", ret);
+		return NULL;
+	}
+
+	net_pkt_set_appdatalen(pkt, len);
+
+	return pkt;
+}
+
+static bool queue_ooo_segment(struct net_tcp *tcp, u32_t seq, u16_t len,
+			      bool held)
+{
+	struct net_pkt *pkt = new_segment(tcp, seq, len);
+
+	if (!pkt) {
+		return false;
+	}
+
+	if (net_tcp_ooo_queue(tcp, pkt) != held) {
+		DBG("Segment %u not %s\n", seq, held ? "held" : "dropped");
+		net_pkt_unref(pkt);
+		return false;
+	}
+
+	if (!held) {
+		net_pkt_unref(pkt);
+	}
+
+	return true;
+}
+
+static bool check_ooo_next(struct net_tcp *tcp, u32_t seq)
+{
+	struct net_pkt *pkt = net_tcp_ooo_next(tcp);
+
+	if (!seq) {
+		if (pkt) {
+			DBG("Unexpected segment %u\n",
+			    sys_get_be32(NET_TCP_HDR(pkt)->seq));
+			net_pkt_unref(pkt);
+			return false;
+		}
+
+		return true;
+	}
+
+	if (!pkt) {
+		DBG("Segment %u not returned\n", seq);
+		return false;
+	}
+
+	if (sys_get_be32(NET_TCP_HDR(pkt)->seq) != seq) {
+		DBG("Segment %u returned instead of %u\n",
+		    sys_get_be32(NET_TCP_HDR(pkt)->seq), seq);
+		net_pkt_unref(pkt);
+		return false;
+	}
+
+	tcp->send_ack += net_pkt_appdatalen(pkt);
+	net_pkt_unref(pkt);
+
+	return true;
+}
+
+static bool check_sack(struct net_tcp *tcp)
+{
+	static const u32_t blocks[] = { 1300, 1400, 1100, 1200 };
+	struct net_pkt *pkt = NULL;
+	u8_t *opt;
+	int i, ret;
+
+	ret = net_tcp_prepare_ack(tcp, (struct sockaddr *)&peer_v6_addr,
+				  &pkt);
+	if (ret || !pkt) {
+		DBG("Prepare ACK failed (%d)\n", ret);
+		return false;
+	}
+
+	opt = NET_TCP_HDR(pkt)->optdata;
+
+	/* The block of the last segment received comes first */
+	if ((NET_TCP_HDR(pkt)->offset >> 4) != (NET_TCPH_LEN + 20) / 4 ||
+	    opt[0] != NET_TCP_NOP_OPT || opt[1] != NET_TCP_NOP_OPT ||
+	    opt[2] != NET_TCP_SACK_OPT || opt[3] != 18) {
+		DBG("Invalid SACK option\n");
+		net_pkt_unref(pkt);
+		return false;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(blocks); i++) {
+		if (sys_get_be32(opt + 4 + 4 * i) != blocks[i]) {
+			DBG("Invalid SACK block edge %u\n",
+			    sys_get_be32(opt + 4 + 4 * i));
+			net_pkt_unref(pkt);
+			return false;
+		}
+	}
+
+	net_pkt_unref(pkt);
+
+	return true;
+}
+
+static bool test_ooo_queue(void)
+{
+	struct net_tcp *tcp = v6_ctx->tcp;
+	u32_t send_ack = tcp->send_ack;
+	bool ret = false;
+
+	tcp->send_ack = 1000;
+	tcp->sack_permitted = 1;
+
+	/* 1000-1100 is missing, 1200-1300 too */
+	if (!queue_ooo_segment(tcp, 1100, 100, true) ||
+	    !queue_ooo_segment(tcp, 1300, 100, true) ||
+	    !queue_ooo_segment(tcp, 1100, 100, false) ||
+	    !queue_ooo_segment(tcp, 1150, 100, false) ||
+	    !queue_ooo_segment(tcp, 1000, 100, false) ||
+	    !queue_ooo_segment(tcp, 1000 + NET_TCP_BUF_MAX_LEN, 100, false) ||
+	    !check_ooo_next(tcp, 0)) {
+		goto out;
+	}
+
+	if (!check_sack(tcp)) {
+		goto out;
+	}
+
+	/* The segments are returned as the gaps fill */
+	tcp->send_ack = 1100;
+
+	if (!check_ooo_next(tcp, 1100) || !check_ooo_next(tcp, 0)) {
+		goto out;
+	}
+
+	tcp->send_ack = 1300;
+
+	if (!check_ooo_next(tcp, 1300) || !check_ooo_next(tcp, 0)) {
+		goto out;
+	}
+
+	ret = true;
+
+out:
+	/* Segments still held are released with the context */
+	tcp->sack_permitted = 0;
+	tcp->send_ack = send_ack;
+
+	return ret;
+}
+
+/* The segments below are sent from SENT_SEQ on, SENT_COUNT of them */
+#define SENT_SEQ 1000
+#define SENT_COUNT 4
+
+static u32_t sent_mss(struct net_tcp *tcp)
+{
+	u16_t mss = net_tcp_get_recv_mss(tcp);
+
+	return mss ? mss : NET_TCP_DEFAULT_MSS;
+}
+
+/* Put segments of one MSS in the queue, as if they had been sent */
+static bool queue_sent_segments(struct net_tcp *tcp)
+{
+	u32_t mss = sent_mss(tcp);
+	struct net_pkt *pkt;
+	int i;
+
+	for (i = 0; i < SENT_COUNT; i++) {
+		pkt = new_segment(tcp, SENT_SEQ + i * mss, mss);
+		if (!pkt) {
+			return false;
+		}
+
+		net_pkt_set_sent(pkt, true);
+		sys_slist_append(&tcp->sent_list, &pkt->sent_list);
+	}
+
+	tcp->send_wnd = SENT_COUNT * mss;
+	tcp->flags &= ~(NET_TCP_RETRYING | NET_TCP_FAST_RECOVERY |
+			NET_TCP_RTT_TIMING | NET_TCP_ZERO_WND_ACKED);
+	tcp->dup_acks = 0;
+	tcp->retry_timeout_shift = 0;
+
+	return true;
+}
+
+static void flush_sent_segments(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+	sys_snode_t *node;
+
+	k_timer_stop(&tcp->retry_timer);
+
+	while ((node = sys_slist_get(&tcp->sent_list))) {
+		pkt = CONTAINER_OF(node, struct net_pkt, sent_list);
+
+		/* A segment to send again holds a second reference */
+		if (!net_pkt_sent(pkt)) {
+			net_pkt_unref(pkt);
+		}
+
+		net_pkt_unref(pkt);
+	}
+
+	tcp->cwnd = 0;
+	tcp->ssthresh = UINT_MAX;
+	tcp->retry_timeout_shift = 0;
+	tcp->dup_acks = 0;
+	tcp->flags &= ~(NET_TCP_RETRYING | NET_TCP_FAST_RECOVERY |
+			NET_TCP_RTT_TIMING | NET_TCP_ZERO_WND_ACKED);
+}
+
+/* Receive an ACK from the peer, without data */
+static bool receive_ack(struct net_tcp *tcp, u32_t ack, u16_t wnd)
+{
+	struct net_pkt *pkt = new_segment(tcp, 0, 0);
+
+	if (!pkt) {
+		return false;
+	}
+
+	sys_put_be32(ack, NET_TCP_HDR(pkt)->ack);
+	sys_put_be16(wnd, NET_TCP_HDR(pkt)->wnd);
+
+	net_tcp_ack_received(tcp->context, pkt);
+	net_pkt_unref(pkt);
+
+	return true;
+}
+
+static bool check_cwnd(struct net_tcp *tcp, u32_t cwnd)
+{
+	if (tcp->cwnd != cwnd) {
+		DBG("Congestion window %u instead of %u\n", tcp->cwnd, cwnd);
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_cwnd_growth(void)
+{
+	struct net_tcp *tcp = v6_ctx->tcp;
+	u32_t mss = sent_mss(tcp);
+	bool ret = false;
+
+	if (!queue_sent_segments(tcp)) {
+		goto out;
+	}
+
+	tcp->cwnd = 2 * mss;
+	tcp->ssthresh = 4 * mss;
+
+	/* Slow start, one MSS per MSS acknowledged, then congestion
+	 * avoidance, about one MSS per window
+	 */
+	if (!receive_ack(tcp, SENT_SEQ + mss, tcp->send_wnd) ||
+	    !check_cwnd(tcp, 3 * mss) ||
+	    !receive_ack(tcp, SENT_SEQ + 2 * mss, tcp->send_wnd) ||
+	    !check_cwnd(tcp, 4 * mss) ||
+	    !receive_ack(tcp, SENT_SEQ + 3 * mss, tcp->send_wnd) ||
+	    !check_cwnd(tcp, 4 * mss + mss / 4)) {
+		goto out;
+	}
+
+	/* An ACK for old data does not open the window */
+	if (!receive_ack(tcp, SENT_SEQ + mss, tcp->send_wnd) ||
+	    !check_cwnd(tcp, 4 * mss + mss / 4)) {
+		goto out;
+	}
+
+	ret = true;
+
+out:
+	flush_sent_segments(tcp);
+
+	return ret;
+}
+
+static bool test_fast_retransmit(void)
+{
+	struct net_tcp *tcp = v6_ctx->tcp;
+	u32_t mss = sent_mss(tcp);
+	bool ret = false;
+	int i;
+
+	if (!queue_sent_segments(tcp)) {
+		goto out;
+	}
+
+	tcp->cwnd = SENT_COUNT * mss;
+
+	/* Two duplicate ACKs are not enough to tell a loss */
+	for (i = 0; i < 2; i++) {
+		if (!receive_ack(tcp, SENT_SEQ, tcp->send_wnd)) {
+			goto out;
+		}
+	}
+
+	if (tcp->dup_acks != 2 || (tcp->flags & NET_TCP_FAST_RECOVERY) ||
+	    !check_cwnd(tcp, SENT_COUNT * mss)) {
+		DBG("Fast retransmit before the third duplicate ACK\n");
+		goto out;
+	}
+
+	/* The third one halves the window, inflated by the three segments
+	 * which left the network
+	 */
+	if (!receive_ack(tcp, SENT_SEQ, tcp->send_wnd)) {
+		goto out;
+	}
+
+	if (!(tcp->flags & NET_TCP_FAST_RECOVERY) ||
+	    tcp->ssthresh != SENT_COUNT * mss / 2 ||
+	    tcp->recover != SENT_SEQ + SENT_COUNT * mss ||
+	    !check_cwnd(tcp, tcp->ssthresh + 3 * mss)) {
+		DBG("No fast retransmit on the third duplicate ACK\n");
+		goto out;
+	}
+
+	/* Each further one inflates the window */
+	if (!receive_ack(tcp, SENT_SEQ, tcp->send_wnd) ||
+	    !check_cwnd(tcp, tcp->ssthresh + 4 * mss)) {
+		goto out;
+	}
+
+	/* Acknowledging everything ends the fast recovery */
+	if (!receive_ack(tcp, SENT_SEQ + SENT_COUNT * mss, tcp->send_wnd)) {
+		goto out;
+	}
+
+	if ((tcp->flags & NET_TCP_FAST_RECOVERY) ||
+	    !check_cwnd(tcp, tcp->ssthresh)) {
+		DBG("Fast recovery not ended\n");
+		goto out;
+	}
+
+	ret = true;
+
+out:
+	flush_sent_segments(tcp);
+
+	return ret;
+}
+
+/* Let the retransmission timer expire right away */
+static void expire_retry_timer(struct net_tcp *tcp)
+{
+	k_timer_start(&tcp->retry_timer, K_MSEC(10), 0);
+	k_sleep(K_MSEC(50));
+}
+
+static bool test_rto_backoff(void)
+{
+	struct net_tcp *tcp = v6_ctx->tcp;
+	u32_t mss = sent_mss(tcp);
+	u32_t rto = tcp->rto;
+	bool ret = false;
+	s32_t remaining;
+
+	if (!queue_sent_segments(tcp)) {
+		goto out;
+	}
+
+	tcp->cwnd = SENT_COUNT * mss;
+	tcp->rto = 200;
+
+	/* The window collapses to one segment, and the timeout doubles */
+	expire_retry_timer(tcp);
+
+	remaining = k_timer_remaining_get(&tcp->retry_timer);
+	if (tcp->retry_timeout_shift != 1 || remaining <= 200 ||
+	    remaining > 400 || !(tcp->flags & NET_TCP_RETRYING) ||
+	    tcp->ssthresh != SENT_COUNT * mss / 2 || !check_cwnd(tcp, mss)) {
+		DBG("Invalid state after a timeout (%d ms)\n", remaining);
+		goto out;
+	}
+
+	/* The segments after the first one are to be sent again */
+	if (!net_pkt_sent(CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+				       struct net_pkt, sent_list)) ||
+	    net_pkt_sent(CONTAINER_OF(sys_slist_peek_tail(&tcp->sent_list),
+				      struct net_pkt, sent_list))) {
+		DBG("Segments not to be sent again\n");
+		goto out;
+	}
+
+	/* A second timeout does not lower the threshold further */
+	expire_retry_timer(tcp);
+
+	remaining = k_timer_remaining_get(&tcp->retry_timer);
+	if (tcp->retry_timeout_shift != 2 || remaining <= 400 ||
+	    tcp->ssthresh != SENT_COUNT * mss / 2 || !check_cwnd(tcp, mss)) {
+		DBG("Invalid state after a second timeout (%d ms)\n",
+		    remaining);
+		goto out;
+	}
+
+	ret = true;
+
+out:
+	flush_sent_segments(tcp);
+	tcp->rto = rto;
+
+	return ret;
+}
+
+static bool test_zero_window_probe(void)
+{
+	struct net_tcp *tcp = v6_ctx->tcp;
+	u32_t mss = sent_mss(tcp);
+	bool ret = false;
+	int i;
+
+	if (!queue_sent_segments(tcp)) {
+		goto out;
+	}
+
+	tcp->cwnd = SENT_COUNT * mss;
+
+	/* ACKs closing the window are not duplicate ACKs */
+	for (i = 0; i < 3; i++) {
+		if (!receive_ack(tcp, SENT_SEQ, 0)) {
+			goto out;
+		}
+	}
+
+	if (tcp->dup_acks || (tcp->flags & NET_TCP_FAST_RECOVERY)) {
+		DBG("Zero window taken as a loss\n");
+		goto out;
+	}
+
+	/* As long as the peer answers the probes, they do not count as
+	 * retries, even past the retry count
+	 */
+	tcp->retry_timeout_shift = CONFIG_NET_TCP_RETRY_COUNT;
+
+	for (i = 0; i < 2; i++) {
+		expire_retry_timer(tcp);
+
+		if (!net_context_is_used(v6_ctx) ||
+		    tcp->retry_timeout_shift != CONFIG_NET_TCP_RETRY_COUNT ||
+		    (tcp->flags & NET_TCP_ZERO_WND_ACKED) ||
+		    !check_cwnd(tcp, SENT_COUNT * mss)) {
+			DBG("Zero window probe taken as a retry\n");
+			goto out;
+		}
+
+		if (!receive_ack(tcp, SENT_SEQ, 0)) {
+			goto out;
+		}
+	}
+
+	ret = true;
+
+out:
+	flush_sent_segments(tcp);
+
+	return ret;
+}
+
 #if 0
 static void connect_v6_cb(struct net_context *context, void *user_data)
 {
@@ -1468,10 +1995,16 @@ static const struct {
 	{ "test IPv4 TCP syn packet creation", test_create_v4_syn_packet },
 	{ "test IPv6 TCP synack packet create", test_create_v6_synack_packet },
 	{ "test IPv4 TCP synack packet create", test_create_v4_synack_packet },
+	{ "test TCP SYN options", test_syn_options },
 	{ "test IPv6 TCP fin packet creation", test_create_v6_fin_packet },
 	{ "test IPv4 TCP fin packet creation", test_create_v4_fin_packet },
 	{ "test IPv6 TCP seq check", test_v6_seq_check },
 	{ "test IPv4 TCP seq check", test_v4_seq_check },
+	{ "test TCP out of order queue", test_ooo_queue },
+	{ "test TCP congestion window growth", test_cwnd_growth },
+	{ "test TCP fast retransmit", test_fast_retransmit },
+	{ "test TCP retransmission timeout backoff", test_rto_backoff },
+	{ "test TCP zero window probe", test_zero_window_probe },
 	{ "test TCP reply context init", test_init_tcp_reply_context },
 	{ "test TCP accept init", test_init_tcp_accept },
 #if 0